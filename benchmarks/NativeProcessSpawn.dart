@@ -0,0 +1,56 @@
+// Copyright (c) 2016, the Dartino project authors. Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE.md file.
+
+// Measures spawning short-lived native processes and waiting for them to
+// exit. The RunTime is for spawning CHILDREN processes.
+
+import 'dart:dartino.os';
+
+import 'package:os/os.dart' as os;
+
+import 'BenchmarkBase.dart';
+
+const int CHILDREN = 16;
+
+void main() {
+  new SequentialSpawnBenchmark().report();
+  new ConcurrentSpawnBenchmark().report();
+}
+
+NativeProcess start() => NativeProcess.start('/bin/true', const []);
+
+int finish(NativeProcess process) {
+  os.sys.close(process.stdin);
+  os.sys.close(process.stdout);
+  os.sys.close(process.stderr);
+  return process.waitForExit();
+}
+
+// Spawns one child at a time and waits for it to exit.
+class SequentialSpawnBenchmark extends BenchmarkBase {
+  SequentialSpawnBenchmark() : super("NativeProcessSpawnSequential");
+
+  void exercise() => run();
+
+  void run() {
+    for (int i = 0; i < CHILDREN; i++) {
+      if (finish(start()) != 0) throw "Unexpected exit code";
+    }
+  }
+}
+
+// Spawns all children before waiting for any of them, like a process pool.
+class ConcurrentSpawnBenchmark extends BenchmarkBase {
+  ConcurrentSpawnBenchmark() : super("NativeProcessSpawnConcurrent");
+
+  void exercise() => run();
+
+  void run() {
+    List<NativeProcess> processes = new List<NativeProcess>(CHILDREN);
+    for (int i = 0; i < CHILDREN; i++) processes[i] = start();
+    for (int i = 0; i < CHILDREN; i++) {
+      if (finish(processes[i]) != 0) throw "Unexpected exit code";
+    }
+  }
+}
@@ -0,0 +1,88 @@
+// Copyright (c) 2016, the Dartino project authors. Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE.md file.
+
+// Measures the number formatting and parsing natives with the kind of values
+// typically found in JSON and CSV documents.
+
+import 'BenchmarkBase.dart';
+
+const int VALUES = 1000;
+
+void main() {
+  new DoubleToStringBenchmark().report();
+  new DoubleToStringAsFixedBenchmark().report();
+  new DoubleParseBenchmark().report();
+  new IntParseBenchmark().report();
+}
+
+List<double> generateDoubles() {
+  List<double> result = new List<double>(VALUES);
+  for (int i = 0; i < VALUES; i++) {
+    switch (i % 4) {
+      case 0: result[i] = i.toDouble(); break;
+      case 1: result[i] = i / 100; break;
+      case 2: result[i] = i * 1.1e-9; break;
+      case 3: result[i] = 1 / (i + 1); break;
+    }
+  }
+  return result;
+}
+
+class DoubleToStringBenchmark extends BenchmarkBase {
+  final List<double> values = generateDoubles();
+
+  DoubleToStringBenchmark() : super("DoubleToString");
+
+  void run() {
+    int length = 0;
+    for (int i = 0; i < values.length; i++) {
+      length += values[i].toString().length;
+    }
+    if (length == 0) throw "Unexpected empty output";
+  }
+}
+
+class DoubleToStringAsFixedBenchmark extends BenchmarkBase {
+  final List<double> values = generateDoubles();
+
+  DoubleToStringAsFixedBenchmark() : super("DoubleToStringAsFixed");
+
+  void run() {
+    int length = 0;
+    for (int i = 0; i < values.length; i++) {
+      length += values[i].toStringAsFixed(2).length;
+    }
+    if (length == 0) throw "Unexpected empty output";
+  }
+}
+
+class DoubleParseBenchmark extends BenchmarkBase {
+  final List<String> inputs =
+      generateDoubles().map((double d) => d.toString()).toList();
+
+  DoubleParseBenchmark() : super("DoubleParse");
+
+  void run() {
+    double sum = 0.0;
+    for (int i = 0; i < inputs.length; i++) {
+      sum += double.parse(inputs[i]);
+    }
+    if (sum == 0.0) throw "Unexpected sum";
+  }
+}
+
+class IntParseBenchmark extends BenchmarkBase {
+  final List<String> inputs =
+      new List<String>.generate(VALUES, (int i) => (i * 7919).toString());
+
+  IntParseBenchmark() : super("IntParse");
+
+  void run() {
+    int sum = 0;
+    for (int i = 0; i < inputs.length; i++) {
+      sum += int.parse(inputs[i]);
+    }
+    if (sum == 0) throw "Unexpected sum";
+  }
+}
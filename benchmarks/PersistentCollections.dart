@@ -0,0 +1,98 @@
+// Copyright (c) 2016, the Dartino project authors. Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE.md file.
+
+// Compares the persistent collections in dart:dartino with the trees in
+// package:immutable, which used to be the way to build immutable messages.
+
+import 'dart:dartino';
+
+import 'package:immutable/immutable.dart';
+
+import 'BenchmarkBase.dart';
+
+const int ENTRIES = 1000;
+
+void main() {
+  new PersistentMapInsertBenchmark().report();
+  new RedBlackTreeInsertBenchmark().report();
+  new PersistentMapLookupBenchmark().report();
+  new RedBlackTreeLookupBenchmark().report();
+  new PersistentVectorAddBenchmark().report();
+  new PersistentVectorIndexBenchmark().report();
+}
+
+// Spread the keys over the whole key space, like hash codes of strings do.
+int keyAt(int i) => (i * 7919) % 1000003;
+
+class PersistentMapInsertBenchmark extends BenchmarkBase {
+  PersistentMapInsertBenchmark() : super("PersistentMapInsert");
+
+  void run() {
+    PersistentMap map = new PersistentMap();
+    for (int i = 0; i < ENTRIES; i++) map = map.put(keyAt(i), i);
+    if (map.length != ENTRIES) throw "Unexpected length";
+  }
+}
+
+class RedBlackTreeInsertBenchmark extends BenchmarkBase {
+  RedBlackTreeInsertBenchmark() : super("RedBlackTreeInsert");
+
+  void run() {
+    RedBlackTree tree = new RedBlackTree();
+    for (int i = 0; i < ENTRIES; i++) tree = tree.insert(keyAt(i), i);
+    if (tree.lookup(keyAt(0)) != 0) throw "Unexpected value";
+  }
+}
+
+class PersistentMapLookupBenchmark extends BenchmarkBase {
+  PersistentMap map = new PersistentMap();
+
+  PersistentMapLookupBenchmark() : super("PersistentMapLookup") {
+    for (int i = 0; i < ENTRIES; i++) map = map.put(keyAt(i), i);
+  }
+
+  void run() {
+    int sum = 0;
+    for (int i = 0; i < ENTRIES; i++) sum += map[keyAt(i)];
+    if (sum == 0) throw "Unexpected sum";
+  }
+}
+
+class RedBlackTreeLookupBenchmark extends BenchmarkBase {
+  RedBlackTree tree = new RedBlackTree();
+
+  RedBlackTreeLookupBenchmark() : super("RedBlackTreeLookup") {
+    for (int i = 0; i < ENTRIES; i++) tree = tree.insert(keyAt(i), i);
+  }
+
+  void run() {
+    int sum = 0;
+    for (int i = 0; i < ENTRIES; i++) sum += tree.lookup(keyAt(i));
+    if (sum == 0) throw "Unexpected sum";
+  }
+}
+
+class PersistentVectorAddBenchmark extends BenchmarkBase {
+  PersistentVectorAddBenchmark() : super("PersistentVectorAdd");
+
+  void run() {
+    PersistentVector vector = new PersistentVector();
+    for (int i = 0; i < ENTRIES; i++) vector = vector.add(i);
+    if (vector.length != ENTRIES) throw "Unexpected length";
+  }
+}
+
+class PersistentVectorIndexBenchmark extends BenchmarkBase {
+  PersistentVector vector = new PersistentVector();
+
+  PersistentVectorIndexBenchmark() : super("PersistentVectorIndex") {
+    for (int i = 0; i < ENTRIES; i++) vector = vector.add(i);
+  }
+
+  void run() {
+    int sum = 0;
+    for (int i = 0; i < ENTRIES; i++) sum += vector[i];
+    if (sum == 0) throw "Unexpected sum";
+  }
+}
@@ -0,0 +1,58 @@
+// Copyright (c) 2016, the Dartino project authors. Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE.md file.
+
+#include "src/shared/assert.h"
+#include "src/shared/platform.h"
+#include "src/shared/test_case.h"
+#include "src/vm/object_map.h"
+
+namespace dartino {
+
+// Moves every [step]th object, like a GC that compacts part of the heap.
+class MovingVisitor : public PointerVisitor {
+ public:
+  explicit MovingVisitor(int step) : step_(step) {}
+
+  void VisitBlock(Object** start, Object** end) {
+    for (Object** p = start; p < end; p++) {
+      word value = Smi::cast(*p)->value();
+      if (value % step_ == 0) *p = Smi::FromWord(value + 1);
+    }
+  }
+
+ private:
+  int step_;
+};
+
+// Reports the cost of the operations of a session map of a large program.
+TEST_CASE(ObjectMapBenchmark) {
+  const int kSize = 200000;
+  ObjectMap map(64);
+
+  uint64 start = Platform::GetMicroseconds();
+  for (int i = 0; i < kSize; i++) map.Add(i, Smi::FromWord(i * 3));
+  uint64 insert = Platform::GetMicroseconds() - start;
+
+  start = Platform::GetMicroseconds();
+  int64 total = 0;
+  for (int i = 0; i < kSize; i++) {
+    total += map.LookupByObject(Smi::FromWord(i * 3));
+    total -= Smi::cast(map.LookupById(i))->value() / 3;
+  }
+  uint64 lookup = Platform::GetMicroseconds() - start;
+  if (total != 0) FATAL("ObjectMap lookups returned the wrong entries");
+
+  // A GC that moves one in a hundred objects, followed by a lookup.
+  MovingVisitor visitor(300);
+  start = Platform::GetMicroseconds();
+  map.IteratePointers(&visitor);
+  map.LookupByObject(Smi::FromWord((kSize - 1) * 3));
+  uint64 after_gc = Platform::GetMicroseconds() - start;
+
+  Print::Out("ObjectMapInsert(RunTime): %llu us.\n", insert);
+  Print::Out("ObjectMapLookup(RunTime): %llu us.\n", lookup);
+  Print::Out("ObjectMapAfterGC(RunTime): %llu us.\n", after_gc);
+}
+
+}  // namespace dartino
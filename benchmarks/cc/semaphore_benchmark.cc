@@ -0,0 +1,48 @@
+// Copyright (c) 2016, the Dartino project authors. Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE.md file.
+
+#include <pthread.h>
+
+#include "src/shared/assert.h"
+#include "src/shared/platform.h"
+#include "src/shared/test_case.h"
+#include "src/shared/utils.h"
+
+namespace dartino {
+
+static const int kRounds = 10000;
+
+struct PingPong {
+  Semaphore ping;
+  Semaphore pong;
+  PingPong() : ping(0), pong(0) {}
+};
+
+static void* RunPong(void* arg) {
+  PingPong* ping_pong = static_cast<PingPong*>(arg);
+  for (int i = 0; i < kRounds; i++) {
+    ping_pong->ping.Down();
+    ping_pong->pong.Up();
+  }
+  return NULL;
+}
+
+// Reports the time of passing control back and forth between two threads.
+TEST_CASE(SemaphorePingPongBenchmark) {
+  PingPong ping_pong;
+  pthread_t other;
+  if (pthread_create(&other, NULL, &RunPong, &ping_pong) != 0) {
+    FATAL("Failed to start the pong thread");
+  }
+  uint64 start = Platform::GetMicroseconds();
+  for (int i = 0; i < kRounds; i++) {
+    ping_pong.ping.Up();
+    ping_pong.pong.Down();
+  }
+  uint64 elapsed = Platform::GetMicroseconds() - start;
+  pthread_join(other, NULL);
+  Print::Out("SemaphorePingPong(RunTime): %llu us.\n", elapsed);
+}
+
+}  // namespace dartino
@@ -92,6 +92,14 @@
         'src/freertos/freertos_dartino_host_tests.gyp:freertos_dartino_host_cc_tests',
       ],
     },
+    {
+      'target_name': 'cc_benchmarks',
+      'type': 'none',
+      'toolsets': ['target'],
+      'dependencies': [
+        'src/vm/vm.gyp:vm_cc_benchmarks',
+      ],
+    },
     {
       'target_name': 'multiprogram_cc_test',
       'type': 'none',
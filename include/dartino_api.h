@@ -35,6 +35,32 @@ typedef DartinoConnection (*DartinoConnectionListenerCallback)(void* data);
 // Setup must be called before using any of the other API methods.
 DARTINO_EXPORT void DartinoSetup(void);
 
+// Configures the scheduler started by DartinoSetup, so it must be called
+// before DartinoSetup. The scheduler runs Dart processes on worker_count
+// worker threads, or the default number of threads if worker_count is 0.
+// If pin_workers is true, the worker threads are pinned round-robin to the
+// CPUs the process may run on where the platform supports it, so the heap
+// memory each first touches stays local to its CPU.
+DARTINO_EXPORT void DartinoConfigureScheduler(int worker_count,
+                                              bool pin_workers);
+
+// Makes DartinoSetup start serving the VM metrics over HTTP on the given
+// localhost port, so it must be called before DartinoSetup. The metrics are
+// in the Prometheus text format and are served from a VM thread.
+DARTINO_EXPORT void DartinoConfigureMetricsServer(int port);
+
+// Sets the default stack sizes, in words, of processes that are spawned
+// without explicit sizes. A process starts with initial_size words of stack
+// and grows it up to max_size words before a stack overflow is reported.
+// A size of 0 keeps the current default.
+DARTINO_EXPORT void DartinoConfigureStackSizes(int initial_size, int max_size);
+
+// Writes a snapshot of the VM metrics in the Prometheus text format to
+// buffer without allocating. Like snprintf, the output is truncated to
+// length - 1 characters and null-terminated, and the result is the length
+// of the complete output.
+DARTINO_EXPORT int DartinoFormatMetrics(char* buffer, int length);
+
 // TearDown should be called when an application is done using the
 // dartino API in order to free up resources.
 DARTINO_EXPORT void DartinoTearDown(void);
@@ -113,6 +139,19 @@ DARTINO_EXPORT DartinoPrintInterceptor DartinoRegisterPrintInterceptor(
     PrintInterceptionFunction function,
     void* data);
 
+// Register a print interception function that is called from a background
+// thread instead of from the thread that prints. Output is buffered and the
+// function is called with batches of one or more messages for the same
+// output id. When the buffer is full, messages are dropped if drop_when_full
+// is true, otherwise printing waits until there is room. Error output is
+// passed on before the printing thread continues, so it is not lost if the
+// VM aborts. Unregistering the interceptor passes on all buffered output
+// before returning.
+DARTINO_EXPORT DartinoPrintInterceptor DartinoRegisterBufferedPrintInterceptor(
+    PrintInterceptionFunction function,
+    void* data,
+    bool drop_when_full);
+
 // Unregister a print interceptor. This must be called with an interceptor
 // instance that was created using the registration function. The interceptor
 // instance is reclaimed and no longer valid after having called this function.
@@ -3,10 +3,17 @@
 // BSD-style license that can be found in the LICENSE file.
 
 import "dart:_internal" show POWERS_OF_TEN;
+import 'dart:dartino._system' as dartino;
 import 'dart:dartino._system' show patch;
 
 // JSON conversion.
 
+// Property names up to this length are interned, so maps decoded from
+// similar documents share their key strings.
+const int _MAX_INTERNED_KEY_LENGTH = 32;
+
+@dartino.native external String _intern(String string);
+
 @patch _parseJson(String json, reviver(var key, var value)) {
   _BuildJsonListener listener;
   if (reviver == null) {
@@ -126,7 +133,8 @@ class _BuildJsonListener extends _JsonListener {
   }
 
   void propertyName() {
-    key = value;
+    String name = value;
+    key = (name.length <= _MAX_INTERNED_KEY_LENGTH) ? _intern(name) : name;
     value = null;
   }
 
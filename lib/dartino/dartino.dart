@@ -6,6 +6,8 @@ library dart.dartino;
 
 import 'dart:dartino._system' as dartino;
 
+part 'persistent_collections.dart';
+
 /// Fibers are lightweight co-operative multitask units of execution. They
 /// are scheduled on top of OS-level threads, but they are cheap to create
 /// and block.
@@ -107,6 +109,7 @@ class Fiber {
     // Suspend the current fiber. It will never wake up again.
     Fiber next = _suspendFiber(fiber, true);
     fiber._coroutine = null;
+    Coroutine._coroutineExit();
     _schedule(next);
   }
 
@@ -242,6 +245,7 @@ class Coroutine {
 
   @dartino.native external static _coroutineCurrent();
   @dartino.native external static _coroutineNewStack(coroutine, entry);
+  @dartino.native external static _coroutineExit();
 }
 
 class ProcessDeath {
@@ -253,6 +257,37 @@ class ProcessDeath {
   DeathReason get reason => DeathReason.values[_reason];
 }
 
+/// The stack sizes of a spawned process, in words.
+///
+/// A process starts with an [initial] stack and grows it on demand up to
+/// [maximum] words, after which a stack overflow is reported. A null size
+/// selects the VM default, which the embedder can change with
+/// `DartinoConfigureStackSizes`. A stack that stays mostly unused over a
+/// few consecutive sleeps of the process is shrunk again, but never below
+/// [initial].
+class StackSize {
+  // Keep in sync with src/vm/process.h:Process::kMinStackSize.
+  static const int minimum = 64;
+
+  final int initial;
+  final int maximum;
+
+  const StackSize({this.initial, this.maximum});
+
+  void _validate() {
+    if (initial != null && initial < minimum) {
+      throw new RangeError.range(initial, minimum, null, "initial");
+    }
+    if (maximum != null && maximum < minimum) {
+      throw new RangeError.range(maximum, minimum, null, "maximum");
+    }
+    if (initial != null && maximum != null && initial > maximum) {
+      throw new ArgumentError(
+          "The initial stack size must not exceed the maximum.");
+    }
+  }
+}
+
 // TODO: Keep these in sync with src/vm/signal.h:Signal::Kind
 enum DeathReason {
   CompileTimeError,
@@ -310,7 +345,9 @@ class Process {
     throw dartino.nativeError;
   }
 
-  static Process spawn(Function fn, [argument]) {
+  /// Spawns a process that runs [fn], passing [argument] if it is not null.
+  /// The stack of the process is sized by [stackSize], if given.
+  static Process spawn(Function fn, [argument, StackSize stackSize]) {
     if (!isImmutable(fn)) {
       throw new ArgumentError(
           'The closure passed to Process.spawn() must be immutable.');
@@ -321,16 +358,31 @@ class Process {
           'The optional argument passed to Process.spawn() must be immutable.');
     }
 
-    return _spawn(_entry, fn, argument, true, true, null);
+    return _spawnWithStackSize(fn, argument, true, null, stackSize);
   }
 
-  static Process spawnDetached(Function fn, {Port monitor}) {
+  static Process spawnDetached(Function fn,
+                               {Port monitor, StackSize stackSize}) {
     if (!isImmutable(fn)) {
       throw new ArgumentError(
           'The closure passed to Process.spawnDetached() must be immutable.');
     }
 
-    return _spawn(_entry, fn, null, true, false, monitor);
+    return _spawnWithStackSize(fn, null, false, monitor, stackSize);
+  }
+
+  static Process _spawnWithStackSize(Function fn,
+                                     argument,
+                                     bool linkFromChild,
+                                     Port monitor,
+                                     StackSize stackSize) {
+    if (stackSize == null) {
+      return _spawn(_entry, fn, argument, true, linkFromChild, monitor,
+                    null, null);
+    }
+    stackSize._validate();
+    return _spawn(_entry, fn, argument, true, linkFromChild, monitor,
+                  stackSize.initial, stackSize.maximum);
   }
 
   /**
@@ -414,7 +466,9 @@ class Process {
                                        argument,
                                        bool linkToChild,
                                        bool linkFromChild,
-                                       Port monitor) {
+                                       Port monitor,
+                                       int initialStackSize,
+                                       int maxStackSize) {
     throw new ArgumentError();
   }
 
@@ -448,7 +502,8 @@ class Port {
   // TODO(kasperl): Temporary debugging aid.
   int get id => _port;
 
-  // Send a message to the channel. Not blocking.
+  // Send a message to the channel. Not blocking. The message must be
+  // immutable; use [PersistentMap] and [PersistentVector] for structured data.
   @dartino.native void send(message) {
     switch (dartino.nativeError) {
       case dartino.wrongArgumentType:
@@ -545,6 +600,31 @@ bool isImmutable(Object object) => _isImmutable(object);
 
 @dartino.native external bool _isImmutable(String string);
 
+/// Returns the canonical string with the same contents as [string].
+///
+/// Interned strings with the same contents are identical, so comparing them
+/// is a single pointer comparison, and duplicates can be garbage collected.
+/// The canonical strings are shared by all processes of the program and are
+/// only kept alive by other references to them.
+String intern(String string) => _intern(string);
+
+@dartino.native String _intern(String string) {
+  switch (dartino.nativeError) {
+    case dartino.wrongArgumentType:
+      throw new ArgumentError(string);
+    default:
+      throw dartino.nativeError;
+  }
+}
+
+/// Returns a snapshot of the VM-wide metrics in the Prometheus text format.
+///
+/// The metrics cover garbage collections, allocation, mailboxes, the
+/// scheduler and the event handler for all programs running in the VM.
+String vmMetrics() => _vmMetrics();
+
+@dartino.native external String _vmMetrics();
+
 /// Delay the current fiber for `milliseconds` milliseconds.
 // TODO(sgjesse): Take a Duration?
 void sleep(int milliseconds) {
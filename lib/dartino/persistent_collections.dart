@@ -0,0 +1,321 @@
+// Copyright (c) 2016, the Dartino project authors. Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE.md file.
+
+part of dart.dartino;
+
+// The persistent collections are tries of [_PersistentNode]s. Every object in
+// them is allocated by a const constructor, so a collection is immutable, and
+// can be sent to other processes, as long as its keys and values are.
+//
+// Updates copy the path from the root to the changed slot and share the rest
+// of the trie with the original collection. Lookups walk the trie in the
+// VM. The node layout is known to the natives in src/vm/natives.cc.
+
+const int _persistentNodeBits = 3;
+const int _persistentNodeWidth = 1 << _persistentNodeBits;
+const int _persistentNodeMask = _persistentNodeWidth - 1;
+
+// Hash codes are truncated to stay small integers on all platforms.
+const int _persistentHashMask = 0x3fffffff;
+
+const _PersistentNode _emptyPersistentNode =
+    const _PersistentNode(null, null, null, null, null, null, null, null);
+
+class _PersistentNode {
+  final _slot0;
+  final _slot1;
+  final _slot2;
+  final _slot3;
+  final _slot4;
+  final _slot5;
+  final _slot6;
+  final _slot7;
+
+  const _PersistentNode(this._slot0, this._slot1, this._slot2, this._slot3,
+                        this._slot4, this._slot5, this._slot6, this._slot7);
+
+  operator[](int index) {
+    switch (index) {
+      case 0: return _slot0;
+      case 1: return _slot1;
+      case 2: return _slot2;
+      case 3: return _slot3;
+      case 4: return _slot4;
+      case 5: return _slot5;
+      case 6: return _slot6;
+      case 7: return _slot7;
+    }
+    throw new RangeError.index(index, this);
+  }
+
+  /// Returns a copy of this node with [value] in slot [index].
+  _PersistentNode replace(int index, value) {
+    return new _PersistentNode(
+        index == 0 ? value : _slot0,
+        index == 1 ? value : _slot1,
+        index == 2 ? value : _slot2,
+        index == 3 ? value : _slot3,
+        index == 4 ? value : _slot4,
+        index == 5 ? value : _slot5,
+        index == 6 ? value : _slot6,
+        index == 7 ? value : _slot7);
+  }
+
+  bool get isEmpty {
+    return _slot0 == null && _slot1 == null && _slot2 == null &&
+        _slot3 == null && _slot4 == null && _slot5 == null &&
+        _slot6 == null && _slot7 == null;
+  }
+}
+
+// Entries with the same hash code are chained through [next].
+class _PersistentMapEntry {
+  final int hash;
+  final key;
+  final value;
+  final _PersistentMapEntry next;
+
+  const _PersistentMapEntry(this.hash, this.key, this.value, this.next);
+}
+
+/// An immutable hash map with cheap non-destructive updates.
+///
+/// [put] and [remove] return a new map that shares most of its structure with
+/// the original one. A map whose keys and values are immutable is itself
+/// immutable (see [isImmutable]), which makes it the preferred way of sending
+/// structured data through a [Port] or to [Process.spawn].
+///
+/// Keys must implement [Object.==] and [Object.hashCode] consistently.
+class PersistentMap<K, V> {
+  final int length;
+  final _PersistentNode _root;
+
+  const PersistentMap._(this.length, this._root);
+
+  factory PersistentMap() => const PersistentMap._(0, _emptyPersistentNode);
+
+  factory PersistentMap.fromMap(Map<K, V> map) {
+    PersistentMap<K, V> result = new PersistentMap<K, V>();
+    map.forEach((K key, V value) {
+      result = result.put(key, value);
+    });
+    return result;
+  }
+
+  bool get isEmpty => length == 0;
+  bool get isNotEmpty => length != 0;
+
+  V operator[](K key) {
+    _PersistentMapEntry entry = _find(key);
+    return entry == null ? null : entry.value;
+  }
+
+  bool containsKey(K key) => _find(key) != null;
+
+  /// Returns a map that maps [key] to [value] and is otherwise the same as
+  /// this map.
+  PersistentMap<K, V> put(K key, V value) {
+    int hash = key.hashCode & _persistentHashMask;
+    _PersistentMapEntry previous = _find(key);
+    if (previous != null && identical(previous.value, value)) return this;
+    _PersistentNode root = _put(_root, hash, 0, key, value);
+    return new PersistentMap<K, V>._(
+        previous == null ? length + 1 : length, root);
+  }
+
+  /// Returns a map without [key] that is otherwise the same as this map.
+  PersistentMap<K, V> remove(K key) {
+    if (_find(key) == null) return this;
+    int hash = key.hashCode & _persistentHashMask;
+    _PersistentNode root = _remove(_root, hash, 0, key);
+    return new PersistentMap<K, V>._(
+        length - 1, root == null ? _emptyPersistentNode : root);
+  }
+
+  void forEach(void f(K key, V value)) {
+    _forEachEntry(_root, f);
+  }
+
+  Map<K, V> toMap() {
+    Map<K, V> result = new Map<K, V>();
+    forEach((K key, V value) {
+      result[key] = value;
+    });
+    return result;
+  }
+
+  String toString() => toMap().toString();
+
+  _PersistentMapEntry _find(K key) {
+    int hash = key.hashCode & _persistentHashMask;
+    _PersistentMapEntry entry = _persistentMapLookup(_root, hash);
+    if (entry == null || entry.hash != hash) return null;
+    for (; entry != null; entry = entry.next) {
+      if (entry.key == key) return entry;
+    }
+    return null;
+  }
+
+  static _PersistentNode _put(
+      _PersistentNode node, int hash, int shift, key, value) {
+    int index = (hash >> shift) & _persistentNodeMask;
+    var slot = node[index];
+    var replacement;
+    if (slot == null) {
+      replacement = new _PersistentMapEntry(hash, key, value, null);
+    } else if (slot is _PersistentNode) {
+      replacement = _put(slot, hash, shift + _persistentNodeBits, key, value);
+    } else if (slot.hash == hash) {
+      replacement = new _PersistentMapEntry(
+          hash, key, value, _removeFromChain(slot, key));
+    } else {
+      // Push the existing chain one level down. The hash codes differ, so
+      // they eventually end up in different slots.
+      int childShift = shift + _persistentNodeBits;
+      int childIndex = (slot.hash >> childShift) & _persistentNodeMask;
+      _PersistentNode child = _emptyPersistentNode.replace(childIndex, slot);
+      replacement = _put(child, hash, childShift, key, value);
+    }
+    return node.replace(index, replacement);
+  }
+
+  // Returns null if the resulting node is empty.
+  static _PersistentNode _remove(
+      _PersistentNode node, int hash, int shift, key) {
+    int index = (hash >> shift) & _persistentNodeMask;
+    var slot = node[index];
+    var replacement;
+    if (slot is _PersistentNode) {
+      replacement = _remove(slot, hash, shift + _persistentNodeBits, key);
+    } else {
+      replacement = _removeFromChain(slot, key);
+    }
+    node = node.replace(index, replacement);
+    return node.isEmpty ? null : node;
+  }
+
+  static _PersistentMapEntry _removeFromChain(
+      _PersistentMapEntry chain, key) {
+    if (chain == null) return null;
+    if (chain.key == key) return chain.next;
+    _PersistentMapEntry rest = _removeFromChain(chain.next, key);
+    if (identical(rest, chain.next)) return chain;
+    return new _PersistentMapEntry(chain.hash, chain.key, chain.value, rest);
+  }
+
+  static void _forEachEntry(_PersistentNode node, void f(key, value)) {
+    for (int i = 0; i < _persistentNodeWidth; i++) {
+      var slot = node[i];
+      if (slot == null) continue;
+      if (slot is _PersistentNode) {
+        _forEachEntry(slot, f);
+      } else {
+        for (_PersistentMapEntry entry = slot;
+             entry != null;
+             entry = entry.next) {
+          f(entry.key, entry.value);
+        }
+      }
+    }
+  }
+}
+
+/// An immutable indexable sequence with cheap non-destructive updates.
+///
+/// [add] and [set] return a new vector that shares most of its structure with
+/// the original one. A vector of immutable elements is itself immutable (see
+/// [isImmutable]), so it can be sent through a [Port] without copying.
+class PersistentVector<E> {
+  final int length;
+  // The number of index bits below the root node.
+  final int _shift;
+  final _PersistentNode _root;
+
+  const PersistentVector._(this.length, this._shift, this._root);
+
+  factory PersistentVector() =>
+      const PersistentVector._(0, 0, _emptyPersistentNode);
+
+  factory PersistentVector.fromList(List<E> list) {
+    PersistentVector<E> result = new PersistentVector<E>();
+    for (int i = 0; i < list.length; i++) {
+      result = result.add(list[i]);
+    }
+    return result;
+  }
+
+  bool get isEmpty => length == 0;
+  bool get isNotEmpty => length != 0;
+
+  E operator[](int index) {
+    if (index is! int) throw new ArgumentError(index);
+    if (index < 0 || index >= length) throw new IndexError(index, this);
+    return _persistentVectorLookup(_root, _shift, index);
+  }
+
+  /// Returns a vector with [value] appended to the elements of this vector.
+  PersistentVector<E> add(E value) {
+    int capacity = _persistentNodeWidth << _shift;
+    if (length == capacity) {
+      // The trie is full. Grow it by a level.
+      _PersistentNode root = _emptyPersistentNode
+          .replace(0, _root)
+          .replace(1, _path(_shift, value));
+      return new PersistentVector<E>._(
+          length + 1, _shift + _persistentNodeBits, root);
+    }
+    return new PersistentVector<E>._(
+        length + 1, _shift, _set(_root, _shift, length, value));
+  }
+
+  /// Returns a vector with [value] at [index] that is otherwise the same as
+  /// this vector.
+  PersistentVector<E> set(int index, E value) {
+    if (index is! int) throw new ArgumentError(index);
+    if (index < 0 || index >= length) throw new IndexError(index, this);
+    return new PersistentVector<E>._(
+        length, _shift, _set(_root, _shift, index, value));
+  }
+
+  void forEach(void f(E element)) {
+    for (int i = 0; i < length; i++) f(this[i]);
+  }
+
+  List<E> toList() {
+    List<E> result = new List<E>(length);
+    for (int i = 0; i < length; i++) result[i] = this[i];
+    return result;
+  }
+
+  String toString() => toList().toString();
+
+  // Returns a fresh path of nodes of height [shift] leading to [value].
+  static _PersistentNode _path(int shift, value) {
+    if (shift == 0) return _emptyPersistentNode.replace(0, value);
+    return _emptyPersistentNode.replace(
+        0, _path(shift - _persistentNodeBits, value));
+  }
+
+  static _PersistentNode _set(
+      _PersistentNode node, int shift, int index, value) {
+    int slot = (index >> shift) & _persistentNodeMask;
+    if (shift == 0) return node.replace(slot, value);
+    _PersistentNode child = node[slot];
+    if (child == null) {
+      child = _path(shift - _persistentNodeBits, value);
+    } else {
+      child = _set(child, shift - _persistentNodeBits, index, value);
+    }
+    return node.replace(slot, child);
+  }
+}
+
+@dartino.native _persistentMapLookup(_PersistentNode root, int hash) {
+  throw new ArgumentError(hash);
+}
+
+@dartino.native _persistentVectorLookup(
+    _PersistentNode root, int shift, int index) {
+  throw new ArgumentError(index);
+}
@@ -5,10 +5,119 @@
 part of dart.dartino.os;
 
 class NativeProcess {
+  /// The pid of the process.
+  final int pid;
+
+  /// The file descriptor for writing to the standard input of the process.
+  final int stdin;
+
+  /// The file descriptor for reading the standard output of the process.
+  final int stdout;
+
+  /// The file descriptor for reading the standard error of the process.
+  final int stderr;
+
+  // Becomes readable when the process exits, or -1 if the platform has no
+  // such descriptor or it has been closed.
+  int _exitFd;
+  int _exitCode;
+
+  NativeProcess._(this.pid, this.stdin, this.stdout, this.stderr,
+                  this._exitFd);
+
+  /// Starts a native (OS) process with its stdin, stdout and stderr connected
+  /// to pipes.
+  ///
+  /// The [stdin], [stdout] and [stderr] file descriptors are non-blocking, so
+  /// they can be waited for with [eventHandler] like sockets. The caller must
+  /// close them, and must either wait for the process to exit or [close] it.
+  static NativeProcess start(String path, List<String> arguments) {
+    Struct32 fds = new Struct32(4);
+    try {
+      int pid = _withArguments(path, arguments, (int address) {
+        return _spawn(address, fds.address);
+      });
+      if (pid < 0) {
+        throw "Failed to start process from path '$path'. Got errno "
+            "${Foreign.errno}";
+      }
+      return new NativeProcess._(pid, fds.getField(0), fds.getField(1),
+                                 fds.getField(2), fds.getField(3));
+    } finally {
+      fds.free();
+    }
+  }
+
+  /// The exit code of the process, or null if it is still running.
+  ///
+  /// If the process was killed by a signal, the exit code is the negative
+  /// signal number.
+  int get exitCode {
+    if (_exitCode == null) {
+      try {
+        _exitCode = _wait(pid, _exitFd);
+      } on StateError {
+        // Waiting failed and the exit descriptor has been closed.
+        _exitFd = -1;
+        rethrow;
+      }
+    }
+    return _exitCode;
+  }
+
+  /// Waits for the process to exit and returns its [exitCode].
+  ///
+  /// Only the calling fiber waits. The exit is delivered through the event
+  /// handler where the platform supports it, so no thread is used per child.
+  int waitForExit() {
+    if (exitCode != null) return _exitCode;
+    if (_exitFd >= 0) {
+      Channel channel = new Channel();
+      Port port = new Port(channel);
+      while (exitCode == null) {
+        eventHandler.registerPortForNextEvent(_exitFd, port, READ_EVENT);
+        channel.receive();
+      }
+      return _exitCode;
+    }
+    // Poll for the exit where there is no exit descriptor.
+    int delay = 1;
+    while (exitCode == null) {
+      sleep(delay);
+      if (delay < 64) delay *= 2;
+    }
+    return _exitCode;
+  }
+
+  /// Reaps the process and releases its exit descriptor. The process is
+  /// killed first if it is still running. Returns the [exitCode].
+  ///
+  /// This does not close [stdin], [stdout] and [stderr].
+  int close() {
+    if (_exitCode != null) return _exitCode;
+    int exitFd = _exitFd;
+    _exitFd = -1;
+    _exitCode = _close(pid, exitFd);
+    return _exitCode;
+  }
 
   /// Starts a native (OS) process with stdin, stdout, and stderr detached.
   /// Returns the pid of the spawned process.
   static int startDetached(String path, List<String> arguments) {
+    int pid = _withArguments(path, arguments, (int address) {
+      return _spawnDetached(address);
+    });
+    if (pid < 0) {
+      throw "Failed to start process from path '$path'. Got errno "
+          "${Foreign.errno}";
+    }
+    return pid;
+  }
+
+  // Calls [spawn] with the address of a native NULL terminated array of the
+  // path and the arguments.
+  static int _withArguments(String path, List<String> arguments,
+                            int spawn(int argumentsAddress)) {
     List<ForeignMemory> allocated = [];
 
     // Helper method to ensure we know what to free.
@@ -39,12 +148,7 @@ class NativeProcess {
         arrayOfArgs.setField(1 + i, allocateString(arguments[i]));
       }
       arrayOfArgs.setField(numArgs - 1, 0);
-      int pid = _spawnDetached(arrayOfArgs.address);
-      if (pid < 0) {
-        throw "Failed to start process from path '$path'. Got errno "
-            "${Foreign.errno}";
-      }
-      return pid;
+      return spawn(arrayOfArgs.address);
     } finally {
       for (var memory in allocated) {
         memory.free();
@@ -55,5 +159,30 @@ class NativeProcess {
   @dartino.native static int _spawnDetached(int argumentsAddress) {
     throw new UnsupportedError('_spawnDetached');
   }
-}
 
+  @dartino.native static int _spawn(int argumentsAddress, int fdsAddress) {
+    throw new UnsupportedError('_spawn');
+  }
+
+  @dartino.native static int _wait(int pid, int exitFd) {
+    switch (dartino.nativeError) {
+      case dartino.wrongArgumentType:
+        throw new ArgumentError();
+      case dartino.illegalState:
+        throw new StateError("Failed to wait for process $pid.");
+      default:
+        throw dartino.nativeError;
+    }
+  }
+
+  @dartino.native static int _close(int pid, int exitFd) {
+    switch (dartino.nativeError) {
+      case dartino.wrongArgumentType:
+        throw new ArgumentError();
+      case dartino.illegalState:
+        throw new StateError("Failed to close process $pid.");
+      default:
+        throw dartino.nativeError;
+    }
+  }
+}
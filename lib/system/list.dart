@@ -44,6 +44,8 @@ abstract class FixedListBase<E>
   @native static ConstantList _new(int length) {
     throw new ArgumentError(length);
   }
+
+  Iterator<E> get iterator => new _FixedListIterator<E>(this);
 }
 
 class ConstantList<E> extends FixedListBase<E> with UnmodifiableListMixin<E> {
@@ -84,6 +86,8 @@ class GrowableList<E> extends ListBase<E> implements List<E> {
 
   int get length => _length;
 
+  Iterator<E> get iterator => new _GrowableListIterator<E>(this);
+
   void add(E value) {
     FixedList<E> list = _list;
     int length = _length;
@@ -217,3 +221,60 @@ class GrowableList<E> extends ListBase<E> implements List<E> {
     list[length] = null;
   }
 }
+
+// The iterators below are used by for-in loops over lists. Unlike the
+// generic ListIterator they do not go through length and elementAt, so
+// each step is a call to moveNext that only performs intrinsified field
+// and list accesses.
+
+class _FixedListIterator<E> implements Iterator<E> {
+  final FixedListBase<E> _iterable;
+  final int _length;
+  int _index = 0;
+  E _current;
+
+  _FixedListIterator(FixedListBase<E> iterable)
+      : _iterable = iterable,
+        _length = iterable.length;
+
+  E get current => _current;
+
+  bool moveNext() {
+    int index = _index;
+    if (index >= _length) {
+      _current = null;
+      return false;
+    }
+    _current = _iterable[index];
+    _index = index + 1;
+    return true;
+  }
+}
+
+class _GrowableListIterator<E> implements Iterator<E> {
+  final GrowableList<E> _iterable;
+  final int _length;
+  int _index = 0;
+  E _current;
+
+  _GrowableListIterator(GrowableList<E> iterable)
+      : _iterable = iterable,
+        _length = iterable._length;
+
+  E get current => _current;
+
+  bool moveNext() {
+    GrowableList<E> iterable = _iterable;
+    if (iterable._length != _length) {
+      throw new ConcurrentModificationError(iterable);
+    }
+    int index = _index;
+    if (index >= _length) {
+      _current = null;
+      return false;
+    }
+    _current = iterable._list[index];
+    _index = index + 1;
+    return true;
+  }
+}
@@ -7,17 +7,27 @@ part of dart.dartino._system;
 class _ConstantMap<K, V> implements Map<K, V> {
   final _keys;
   final _values;
+  // A hash index over the keys built by the VM for larger maps, or null.
+  final _index;
 
   bool containsValue(Object value) => _values.contains(value);
 
-  bool containsKey(Object key) => _keys.contains(key);
+  bool containsKey(Object key) => _indexOf(key) >= 0;
 
   V operator[](Object key) {
+    int index = _indexOf(key);
+    return index < 0 ? null : _values[index];
+  }
+
+  // Returns the position of [key] in [_keys] or -1. The native uses the
+  // index if there is one and can handle [key], otherwise the keys are
+  // scanned.
+  @native int _indexOf(Object key) {
     int length = _keys.length;
     for (int i = 0; i < length; i++) {
-      if (_keys[i] == key) return _values[i];
+      if (_keys[i] == key) return i;
     }
-    return null;
+    return -1;
   }
 
   void operator[]=(K key, V value) {
@@ -58,6 +58,9 @@ enum ClientCommandCode {
 
   /// Connection closed.
   ClientConnectionClosed,
+
+  /// Time spent on the request in the hub, in microseconds.
+  Timing,
 }
 
 class ClientCommand {
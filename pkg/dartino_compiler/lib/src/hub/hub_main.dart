@@ -145,6 +145,12 @@ class ClientCommandSender extends CommandSender {
         ..sendOn(sink, ClientCommandCode.ExitCode);
   }
 
+  void sendTiming(int microseconds) {
+    new CommandBuffer<ClientCommandCode>()
+        ..addUint64(microseconds)
+        ..sendOn(sink, ClientCommandCode.Timing);
+  }
+
   void sendDataCommand(ClientCommandCode code, List<int> data) {
     new CommandBuffer<ClientCommandCode>()
         ..addUint32(data.length)
@@ -380,6 +386,9 @@ class ClientConnection {
 
   Completer<List<String>> argumentsCompleter = new Completer<List<String>>();
 
+  /// Measures the time spent on the request, reported to the client on exit.
+  final Stopwatch requestStopwatch = new Stopwatch();
+
   /// The analysed version of the request from the client.
   /// Updated by [parseArguments].
   AnalyzedSentence sentence;
@@ -423,6 +432,7 @@ class ClientConnection {
     if (command.code == ClientCommandCode.Arguments) {
       // This intentionally throws if arguments are sent more than once.
       argumentsCompleter.complete(command.data);
+      requestStopwatch.start();
     } else if (responseCompleter != null) {
       if (command.code == ClientCommandCode.Stdin) {
         responseCompleter.complete(UTF8.decode(command.data));
@@ -511,6 +521,7 @@ class ClientConnection {
         exitCode = reportErrorToClient(error, stackTrace);
       }
     }
+    commandSender.sendTiming(requestStopwatch.elapsedMicroseconds);
     commandSender.sendExitCode(exitCode);
     endSession();
   }
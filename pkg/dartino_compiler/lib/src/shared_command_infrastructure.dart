@@ -108,6 +108,46 @@ Uint8List toUint8ListView(TypedData list, [int offset = 0, int length]) {
   return new Uint8List.view(list.buffer, list.offsetInBytes + offset, length);
 }
 
+/// Decompresses [input] into [length] bytes.
+///
+/// This is the decompressor of the format produced by the dartino-vm, see
+/// src/shared/compression.h.
+Uint8List decompress(Uint8List input, int length) {
+  const int minMatch = 4;
+  Uint8List output = new Uint8List(length);
+  int i = 0;
+  int position = 0;
+  while (i < input.length) {
+    int tag = input[i++];
+    if (tag < 0x80) {
+      int run = tag + 1;
+      if (i + run > input.length || position + run > length) {
+        throw new StateError("Malformed compressed data");
+      }
+      output.setRange(position, position + run, input, i);
+      i += run;
+      position += run;
+    } else {
+      if (i + 2 > input.length) {
+        throw new StateError("Malformed compressed data");
+      }
+      int match = (tag & 0x7f) + minMatch;
+      int distance = input[i] | (input[i + 1] << 8);
+      i += 2;
+      if (distance == 0 || distance > position || position + match > length) {
+        throw new StateError("Malformed compressed data");
+      }
+      // Copy byte by byte, the match may overlap the bytes it produces.
+      for (int j = 0; j < match; j++) {
+        output[position + j] = output[position + j - distance];
+      }
+      position += match;
+    }
+  }
+  if (position != length) throw new StateError("Malformed compressed data");
+  return output;
+}
+
 /// [E] is an enum.
 class CommandBuffer<E> {
   int position = headerSize;
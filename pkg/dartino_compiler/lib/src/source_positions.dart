@@ -0,0 +1,142 @@
+// Copyright (c) 2016, the Dartino project authors. Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE.md file.
+
+/// Compact source position tables that are embedded in snapshots, so the VM
+/// can symbolise uncaught exceptions without the compiler.
+///
+/// The format is described in src/vm/source_positions.h.
+library dartino_compiler.source_positions;
+
+import 'dart:convert' show
+    UTF8;
+
+import 'dart:typed_data' show
+    Uint8List;
+
+import 'package:compiler/src/elements/elements.dart' show
+    LibraryElement;
+
+import 'package:compiler/src/io/source_file.dart' show
+    SourceFile;
+
+import '../dartino_system.dart' show
+    DartinoFunction,
+    DartinoSystem;
+
+import '../incremental/dartino_compiler_incremental.dart' show
+    IncrementalCompiler;
+
+import '../program_info.dart' show
+    shortName;
+
+import '../vm_commands.dart' show
+    MapId,
+    PushFromMap,
+    PushNewArray,
+    PushNewByteArray,
+    PushNewOneByteString,
+    SetSourcePositions,
+    VmCommand;
+
+import 'debug_info.dart' show
+    DebugInfo,
+    SourceLocation;
+
+/// Returns the commands that set the source position tables of all functions
+/// in [system] that have source positions.
+List<VmCommand> sourcePositionCommands(
+    IncrementalCompiler compiler,
+    DartinoSystem system,
+    Iterable<LibraryElement> libraries) {
+  Map<int, String> names =
+      system.computeSymbolicSystemInfo(libraries)[MapId.methods];
+  Map<SourceFile, int> fileIndices = <SourceFile, int>{};
+  List<VmCommand> tableCommands = <VmCommand>[];
+  int tables = 0;
+  system.functionsById.forEach((pair) {
+    DartinoFunction function = pair.snd;
+    DebugInfo debugInfo = compiler.createDebugInfo(function, system);
+    if (debugInfo.locations.isEmpty) return;
+    String name = names[function.functionId];
+    name = (name == null) ? function.name : shortName(name);
+    Uint8List table = encodeSourcePositionTable(
+        name, debugInfo.locations, (SourceFile file) {
+          return fileIndices.putIfAbsent(file, () => fileIndices.length);
+        });
+    tableCommands
+        ..add(new PushFromMap(MapId.methods, function.functionId))
+        ..add(new PushNewByteArray(table));
+    tables++;
+  });
+
+  List<VmCommand> commands = <VmCommand>[];
+  for (SourceFile file in fileIndices.keys) {
+    commands.add(new PushNewOneByteString(
+        new Uint8List.fromList(UTF8.encode(file.filename))));
+  }
+  commands
+      ..add(new PushNewArray(fileIndices.length))
+      ..addAll(tableCommands)
+      ..add(new PushNewArray(1 + tables * 2))
+      ..add(const SetSourcePositions());
+  return commands;
+}
+
+Uint8List encodeSourcePositionTable(
+    String name,
+    List<SourceLocation> locations,
+    int fileIndex(SourceFile file)) {
+  List<int> bytes = <int>[];
+
+  void addUnsigned(int value) {
+    assert(value >= 0);
+    while (value >= 0x80) {
+      bytes.add((value & 0x7f) | 0x80);
+      value >>= 7;
+    }
+    bytes.add(value);
+  }
+
+  List<int> encodedName = UTF8.encode(name);
+  addUnsigned(encodedName.length);
+  bytes.addAll(encodedName);
+
+  int previousIndex = 0;
+  // File index 0 means that the position is unknown.
+  int previousFile = -1;
+  int previousLine = 0;
+  int previousColumn = 0;
+  for (SourceLocation location in locations) {
+    int file = 0;
+    int line = previousLine;
+    int column = 0;
+    if (location.span != null && location.file != null) {
+      SourceFile sourceFile = location.file;
+      int lineIndex = sourceFile.getLine(location.span.begin);
+      file = fileIndex(sourceFile) + 1;
+      line = lineIndex + 1;
+      column = sourceFile.getColumn(lineIndex, location.span.begin) + 1;
+    }
+    if (file == previousFile &&
+        line == previousLine &&
+        column == previousColumn) {
+      continue;
+    }
+    int delta = (location.bytecodeIndex - previousIndex) << 1;
+    if (file != previousFile) {
+      addUnsigned(delta | 1);
+      addUnsigned(file);
+    } else {
+      addUnsigned(delta);
+    }
+    int lineDelta = line - previousLine;
+    addUnsigned(lineDelta < 0 ? (-lineDelta << 1) - 1 : lineDelta << 1);
+    addUnsigned(column);
+    previousIndex = location.bytecodeIndex;
+    previousFile = file;
+    previousLine = line;
+    previousColumn = column;
+  }
+  return new Uint8List.fromList(bytes);
+}
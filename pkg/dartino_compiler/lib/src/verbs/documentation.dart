@@ -86,7 +86,9 @@ const String endDocumentation = """
 const String exportDocumentation = """
    export [<dartfile>] to <snapshot>
              Compile <dartfile> and create a snapshot in <snapshot>. If no
-             <dartfile> is given, export the previously compiled file
+             <dartfile> is given, export the previously compiled file.
+             With --embed-source-positions the snapshot includes line
+             tables, so uncaught exceptions print source positions
 """;
 
 const String quitDocumentation = """
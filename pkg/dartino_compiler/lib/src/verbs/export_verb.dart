@@ -22,7 +22,8 @@ const Action exportAction =
 
 Future<int> export(AnalyzedSentence sentence, VerbContext context) {
   return context.performTaskInWorker(
-      new ExportTask(sentence.targetUri, sentence.toTargetUri, sentence.base));
+      new ExportTask(sentence.targetUri, sentence.toTargetUri, sentence.base,
+          sentence.options.embedSourcePositions));
 }
 
 class ExportTask extends SharedTask {
@@ -34,14 +35,17 @@ class ExportTask extends SharedTask {
 
   final Uri base;
 
-  const ExportTask(this.script, this.snapshot, this.base);
+  final bool embedSourcePositions;
+
+  const ExportTask(
+      this.script, this.snapshot, this.base, this.embedSourcePositions);
 
   Future<int> call(
       CommandSender commandSender,
       StreamIterator<ClientCommand> commandIterator) {
     return exportTask(
         commandSender, commandIterator, SessionState.current, script, snapshot,
-        base);
+        base, embedSourcePositions);
   }
 }
 
@@ -51,7 +55,8 @@ Future<int> exportTask(
     SessionState state,
     Uri script,
     Uri snapshot,
-    Uri base) async {
+    Uri base,
+    bool embedSourcePositions) async {
   return compileAndAttachToVmThen(
       commandSender,
       commandIterator,
@@ -59,5 +64,6 @@ Future<int> exportTask(
       script,
       base,
       true,
-      () => developer.export(state, snapshot));
+      () => developer.export(
+          state, snapshot, embedSourcePositions: embedSourcePositions));
 }
@@ -22,6 +22,7 @@ enum OptionKind {
   terminateDebugger,
   debuggingMode,
   noWait,
+  embedSourcePositions,
 
   /// Not an option
   none,
@@ -40,6 +41,8 @@ const List<Option> supportedOptions = const <Option>[
       OptionKind.debuggingMode, null, 'debugging-mode'),
   const Option(
       OptionKind.noWait, null, 'no-wait'),
+  const Option(
+      OptionKind.embedSourcePositions, null, 'embed-source-positions'),
 ];
 
 final Map<String, Option> shortOptions = computeShortOptions();
@@ -122,6 +125,7 @@ class Options {
   final bool terminateDebugger;
   final bool debuggingMode;
   final bool noWait;
+  final bool embedSourcePositions;
 
   Options(
       this.help,
@@ -133,7 +137,8 @@ class Options {
       this.fatalIncrementalFailures,
       this.terminateDebugger,
       this.debuggingMode,
-      this.noWait);
+      this.noWait,
+      this.embedSourcePositions);
 
   /// Parse [options] which is a list of command-line arguments, such as those
   /// passed to `main`.
@@ -148,6 +153,7 @@ class Options {
     bool terminateDebugger = isBatchMode;
     bool debuggingMode = false;
     bool noWait = false;
+    bool embedSourcePositions = false;
 
     Iterator<String> iterator = options.iterator;
 
@@ -240,6 +246,10 @@ class Options {
           noWait = true;
           break;
 
+        case OptionKind.embedSourcePositions:
+          embedSourcePositions = true;
+          break;
+
         case OptionKind.none:
           break;
       }
@@ -248,6 +258,6 @@ class Options {
     return new Options(
         help, verbose, version, defines,
         nonOptionArguments, analyzeOnly, fatalIncrementalFailures,
-        terminateDebugger, debuggingMode, noWait);
+        terminateDebugger, debuggingMode, noWait, embedSourcePositions);
   }
 }
@@ -92,6 +92,9 @@ import '../verbs/infrastructure.dart' show
 import '../../cli_debugger.dart' show
     exceptionToString;
 
+import '../source_positions.dart' show
+    sourcePositionCommands;
+
 import '../../vm_context.dart' show
     DartinoVmContext;
 
@@ -825,7 +828,10 @@ Future<int> run(
   return exitCode;
 }
 
-Future<int> export(SessionState state, Uri snapshot) async {
+Future<int> export(
+    SessionState state,
+    Uri snapshot,
+    {bool embedSourcePositions: false}) async {
   List<DartinoDelta> compilationResults = state.compilationResults;
   DartinoVmContext vmContext = state.vmContext;
   state.vmContext = null;
@@ -835,6 +841,12 @@ Future<int> export(SessionState state, Uri snapshot) async {
     await vmContext.applyDelta(delta);
   }
 
+  if (embedSourcePositions) {
+    await vmContext.runCommands(sourcePositionCommands(
+        state.compiler, compilationResults.last.system,
+        state.compiler.compiler.libraryLoader.libraries));
+  }
+
   VmCommand result = await vmContext.createSnapshot(
       snapshotPath: snapshot.toFilePath());
   if (result is ProgramInfoCommand) {
@@ -43,8 +43,13 @@ abstract class VmCommand {
         int floatSize = CommandBuffer.readInt32FromBuffer(buffer, offset);
         offset += 4;
         int vmState = CommandBuffer.readInt32FromBuffer(buffer, offset);
-        return new HandShakeResult(
-            success, version, wordSize, floatSize, VmState.values[vmState]);
+        offset += 4;
+        // Older dartino-vms do not send the enabled features.
+        int features = buffer.length >= offset + 4
+            ? CommandBuffer.readInt32FromBuffer(buffer, offset)
+            : 0;
+        return new HandShakeResult(success, version, wordSize, floatSize,
+            VmState.values[vmState], features);
       case VmCommandCode.InstanceStructure:
         int classId =
             translateClass(CommandBuffer.readInt64FromBuffer(buffer, 0));
@@ -114,6 +119,15 @@ abstract class VmCommand {
       case VmCommandCode.ProcessSetBreakpoint:
         int value = CommandBuffer.readInt32FromBuffer(buffer, 0);
         return new ProcessSetBreakpoint(value);
+      case VmCommandCode.ProcessLogpoint:
+        int breakpointId = CommandBuffer.readInt32FromBuffer(buffer, 0);
+        int processId = CommandBuffer.readInt32FromBuffer(buffer, 4);
+        int hitCount = CommandBuffer.readInt64FromBuffer(buffer, 8);
+        int suppressedCount = CommandBuffer.readInt32FromBuffer(buffer, 16);
+        bool hasValue = CommandBuffer.readBoolFromBuffer(buffer, 20);
+        int value = CommandBuffer.readInt64FromBuffer(buffer, 21);
+        return new ProcessLogpoint(breakpointId, processId, hitCount,
+            suppressedCount, hasValue ? value : null);
       case VmCommandCode.ProcessTerminated:
         return const ProcessTerminated();
       case VmCommandCode.ProcessCompileTimeError:
@@ -128,6 +142,35 @@ abstract class VmCommand {
           ids[i] = CommandBuffer.readInt32FromBuffer(buffer, (i + 1) * 4);
         }
         return new ProcessGetProcessIdsResult(ids);
+      case VmCommandCode.SetTracepointResult:
+        int id = CommandBuffer.readInt32FromBuffer(buffer, 0);
+        return new SetTracepointResult(id);
+      case VmCommandCode.DeleteTracepointResult:
+        int id = CommandBuffer.readInt32FromBuffer(buffer, 0);
+        return new DeleteTracepointResult(id);
+      case VmCommandCode.TracepointHistograms:
+        int count = CommandBuffer.readInt32FromBuffer(buffer, 0);
+        int bucketCount = CommandBuffer.readInt32FromBuffer(buffer, 4);
+        int offset = 8;
+        List<TracepointHistogram> histograms =
+            new List<TracepointHistogram>(count);
+        for (int i = 0; i < count; ++i) {
+          int id = CommandBuffer.readInt32FromBuffer(buffer, offset);
+          offset += 4;
+          int calls = CommandBuffer.readInt64FromBuffer(buffer, offset);
+          offset += 8;
+          int totalMicroseconds =
+              CommandBuffer.readInt64FromBuffer(buffer, offset);
+          offset += 8;
+          List<int> buckets = new List<int>(bucketCount);
+          for (int j = 0; j < bucketCount; ++j) {
+            buckets[j] = CommandBuffer.readInt64FromBuffer(buffer, offset);
+            offset += 8;
+          }
+          histograms[i] =
+              new TracepointHistogram(id, calls, totalMicroseconds, buckets);
+        }
+        return new TracepointHistograms(histograms);
       case VmCommandCode.UncaughtException:
         int offset = 0;
         int processId = CommandBuffer.readInt32FromBuffer(buffer, offset);
@@ -212,10 +255,24 @@ abstract class VmCommand {
   String toString() => "$code(${valuesToString()})";
 }
 
+/// Optional features negotiated in the handshake. This should be kept in sync
+/// with `enum Feature` in 'src/shared/connection.h'.
+class VmFeatures {
+  /// Large messages from the dartino-vm are sent as
+  /// [VmCommandCode.CompressedMessage].
+  static const int compressedMessages = 1 << 0;
+
+  static const int all = compressedMessages;
+}
+
 class HandShake extends VmCommand {
   final String value;
 
-  const HandShake(this.value)
+  /// The [VmFeatures] supported by the compiler. Older dartino-vms ignore
+  /// them.
+  final int features;
+
+  const HandShake(this.value, [this.features = 0])
       : super(VmCommandCode.HandShake);
 
   void internalAddTo(
@@ -226,13 +283,14 @@ class HandShake extends VmCommand {
     buffer
         ..addUint32(payload.length)
         ..addUint8List(payload)
+        ..addUint32(features)
         ..sendOn(sink, code);
   }
 
   // Expects a HandShakeResult reply.
   int get numberOfResponsesExpected => 1;
 
-  String valuesToString() => "value: $value";
+  String valuesToString() => "value: $value, features: $features";
 }
 
 /// The state of a dartino-vm session.
@@ -255,12 +313,16 @@ class HandShakeResult extends VmCommand {
   final int dartinoDoubleSize;
   final VmState vmState;
 
+  /// The [VmFeatures] enabled for the session.
+  final int features;
+
   const HandShakeResult(
       this.success,
       this.version,
       this.wordSize,
       this.dartinoDoubleSize,
-      this.vmState)
+      this.vmState,
+      [this.features = 0])
       : super(VmCommandCode.HandShakeResult);
 
   void internalAddTo(
@@ -275,6 +337,7 @@ class HandShakeResult extends VmCommand {
         ..addUint32(wordSize)
         ..addUint32(dartinoDoubleSize)
         ..addUint32(vmState.index)
+        ..addUint32(features)
         ..sendOn(sink, code);
   }
 
@@ -282,7 +345,7 @@ class HandShakeResult extends VmCommand {
 
   String valuesToString() {
     return "success: $success, version: $version, wordsize: $wordSize, "
-        "floatSize: $dartinoDoubleSize";
+        "floatSize: $dartinoDoubleSize, features: $features";
   }
 }
 
@@ -339,6 +402,27 @@ class PushNewTwoByteString extends VmCommand {
   String valuesToString() => "value: '${new String.fromCharCodes(value)}'";
 }
 
+class PushNewByteArray extends VmCommand {
+  final Uint8List value;
+
+  const PushNewByteArray(this.value)
+      : super(VmCommandCode.PushNewByteArray);
+
+  void internalAddTo(
+      Sink<List<int>> sink,
+      CommandBuffer<VmCommandCode> buffer,
+      int translateObject(MapId mapId, int index)) {
+    buffer
+        ..addUint32(value.length)
+        ..addUint8List(value)
+        ..sendOn(sink, code);
+  }
+
+  int get numberOfResponsesExpected => 0;
+
+  String valuesToString() => "length: ${value.length}";
+}
+
 class PushNewInstance extends VmCommand {
   const PushNewInstance()
       : super(VmCommandCode.PushNewInstance);
@@ -473,6 +557,50 @@ class Generic extends VmCommand {
   String toString() => "Generic($code, ${valuesToString()})";
 }
 
+/// Sends [commands] as a single message. The dartino-vm processes them as if
+/// they had been sent one by one, but reads them from the connection at once.
+class CommandBatch extends VmCommand {
+  final List<VmCommand> commands;
+
+  const CommandBatch(this.commands)
+      : super(VmCommandCode.CommandBatch);
+
+  void internalAddTo(
+      Sink<List<int>> sink,
+      CommandBuffer<VmCommandCode> buffer,
+      int translateObject(MapId mapId, int index)) {
+    Sink<List<int>> batchSink = new _CommandBufferSink(buffer);
+    for (VmCommand command in commands) {
+      command.addTo(batchSink, translateObject);
+    }
+    buffer.sendOn(sink, code);
+  }
+
+  int get numberOfResponsesExpected {
+    int responses = 0;
+    for (VmCommand command in commands) {
+      int expected = command.numberOfResponsesExpected;
+      if (expected == null) return null;
+      responses += expected;
+    }
+    return responses;
+  }
+
+  String valuesToString() => "commands: ${commands.length}";
+}
+
+class _CommandBufferSink implements Sink<List<int>> {
+  final CommandBuffer<VmCommandCode> buffer;
+
+  _CommandBufferSink(this.buffer);
+
+  void add(List<int> data) {
+    buffer.addUint8List(data);
+  }
+
+  void close() {}
+}
+
 class NewMap extends VmCommand {
   final MapId map;
 
@@ -1038,6 +1166,58 @@ class ProcessSetBreakpoint extends VmCommand {
   String valuesToString() => "value: $value";
 }
 
+/// Sets a program breakpoint that only pauses when the small integer
+/// [slot] words up the stack compares to [value] as given by [comparison],
+/// after [ignoreCount] such hits. A logpoint does not pause the program but
+/// reports each hit with a [ProcessLogpoint], including the value in
+/// [logSlot] unless it is -1. If [maxLogsPerSecond] is positive the VM
+/// reports at most that many hits per second.
+class ProcessSetConditionalBreakpoint extends VmCommand {
+  final int bytecodeIndex;
+  final BreakpointComparison comparison;
+  final int slot;
+  final int value;
+  final int ignoreCount;
+  final bool isLogpoint;
+  final int logSlot;
+  final int maxLogsPerSecond;
+
+  const ProcessSetConditionalBreakpoint(
+      this.bytecodeIndex,
+      {this.comparison: BreakpointComparison.always,
+       this.slot: 0,
+       this.value: 0,
+       this.ignoreCount: 0,
+       this.isLogpoint: false,
+       this.logSlot: -1,
+       this.maxLogsPerSecond: 0})
+      : super(VmCommandCode.ProcessSetConditionalBreakpoint);
+
+  void internalAddTo(
+      Sink<List<int>> sink,
+      CommandBuffer<VmCommandCode> buffer,
+      int translateObject(MapId mapId, int index)) {
+    buffer
+        ..addUint32(bytecodeIndex)
+        ..addUint32(comparison.index)
+        ..addUint32(slot)
+        ..addUint64(value)
+        ..addUint32(ignoreCount)
+        ..addBool(isLogpoint)
+        ..addUint32(logSlot)
+        ..addUint32(maxLogsPerSecond)
+        ..sendOn(sink, code);
+  }
+
+  /// Peer will respond with [ProcessSetBreakpoint]
+  int get numberOfResponsesExpected => 1;
+
+  String valuesToString() =>
+      "bytecodeIndex: $bytecodeIndex, comparison: $comparison, slot: $slot, "
+      "value: $value, ignoreCount: $ignoreCount, isLogpoint: $isLogpoint, "
+      "logSlot: $logSlot, maxLogsPerSecond: $maxLogsPerSecond";
+}
+
 class ProcessDeleteBreakpoint extends VmCommand {
   final int id;
 
@@ -1185,6 +1365,35 @@ class ProcessBreakpoint extends VmCommand {
       "functionId: $functionId, bytecodeIndex: $bytecodeIndex";
 }
 
+/// Sent by the VM when a process passes a logpoint. The process keeps
+/// running. [suppressedCount] is the number of hits dropped by the rate
+/// limit since the previous report. [value] is null if no slot is logged or
+/// if it does not hold a small integer.
+class ProcessLogpoint extends VmCommand {
+  final int breakpointId;
+  final int processId;
+  final int hitCount;
+  final int suppressedCount;
+  final int value;
+
+  const ProcessLogpoint(this.breakpointId, this.processId, this.hitCount,
+      this.suppressedCount, this.value)
+      : super(VmCommandCode.ProcessLogpoint);
+
+  void internalAddTo(
+      Sink<List<int>> sink,
+      CommandBuffer<VmCommandCode> buffer,
+      int translateObject(MapId mapId, int index)) {
+    throw new UnimplementedError();
+  }
+
+  int get numberOfResponsesExpected => 0;
+
+  String valuesToString() =>
+      "breakpointId: $breakpointId, processId: $processId, "
+      "hitCount: $hitCount, suppressedCount: $suppressedCount, value: $value";
+}
+
 /// Request for a description of an instance object in the heap of the current
 /// process. [frame] and [slot] refers to a variable in the local scope to start
 /// the search, and [fieldAccesses] gives a path to follow from there
@@ -1420,6 +1629,103 @@ class ProcessGetProcessIdsResult extends VmCommand {
   String valuesToString() => "ids: $ids";
 }
 
+/// Installs entry and exit probes in the function on top of the session
+/// stack that count its calls and measure their latency. Does not require a
+/// debugging session and can be sent while the program is running.
+///
+/// The peer responds with a [SetTracepointResult]. Tracing a function twice
+/// returns the same id.
+class SetTracepoint extends VmCommand {
+  const SetTracepoint()
+      : super(VmCommandCode.SetTracepoint);
+
+  int get numberOfResponsesExpected => 1;
+
+  String valuesToString() => "";
+}
+
+class SetTracepointResult extends VmCommand {
+  final int id;
+
+  const SetTracepointResult(this.id)
+      : super(VmCommandCode.SetTracepointResult);
+
+  int get numberOfResponsesExpected => 0;
+
+  String valuesToString() => "id: $id";
+}
+
+/// Removes a tracepoint. The peer responds with a [DeleteTracepointResult]
+/// holding [id], or -1 if there was no such tracepoint.
+class DeleteTracepoint extends VmCommand {
+  final int id;
+
+  const DeleteTracepoint(this.id)
+      : super(VmCommandCode.DeleteTracepoint);
+
+  void internalAddTo(
+      Sink<List<int>> sink,
+      CommandBuffer<VmCommandCode> buffer,
+      int translateObject(MapId mapId, int index)) {
+    buffer
+        ..addUint32(id)
+        ..sendOn(sink, code);
+  }
+
+  int get numberOfResponsesExpected => 1;
+
+  String valuesToString() => "id: $id";
+}
+
+class DeleteTracepointResult extends VmCommand {
+  final int id;
+
+  const DeleteTracepointResult(this.id)
+      : super(VmCommandCode.DeleteTracepointResult);
+
+  int get numberOfResponsesExpected => 0;
+
+  String valuesToString() => "id: $id";
+}
+
+class TracepointHistogramsRequest extends VmCommand {
+  const TracepointHistogramsRequest()
+      : super(VmCommandCode.TracepointHistogramsRequest);
+
+  /// The peer will respond with [TracepointHistograms].
+  int get numberOfResponsesExpected => 1;
+
+  String valuesToString() => "";
+}
+
+/// The call statistics of a tracepoint. [buckets] is a latency histogram:
+/// bucket 0 counts calls that took less than a microsecond, bucket i > 0
+/// calls that took from 2^(i-1) up to 2^i microseconds. The last bucket
+/// also counts all longer calls.
+class TracepointHistogram {
+  final int id;
+  final int calls;
+  final int totalMicroseconds;
+  final List<int> buckets;
+
+  const TracepointHistogram(
+      this.id, this.calls, this.totalMicroseconds, this.buckets);
+
+  String toString() => "TracepointHistogram(id: $id, calls: $calls, "
+      "totalMicroseconds: $totalMicroseconds, buckets: $buckets)";
+}
+
+class TracepointHistograms extends VmCommand {
+  final List<TracepointHistogram> histograms;
+
+  const TracepointHistograms(this.histograms)
+      : super(VmCommandCode.TracepointHistograms);
+
+  int get numberOfResponsesExpected => 0;
+
+  String valuesToString() => "histograms: $histograms";
+}
+
 class SessionEnd extends VmCommand {
   const SessionEnd()
       : super(VmCommandCode.SessionEnd);
@@ -1518,6 +1824,16 @@ class SetEntryPoint extends VmCommand {
   String valuesToString() => "";
 }
 
+/// Pops the source position tables of the program, see
+/// src/vm/source_positions.h.
+class SetSourcePositions extends VmCommand {
+  const SetSourcePositions() : super(VmCommandCode.SetSourcePositions);
+
+  int get numberOfResponsesExpected => 0;
+
+  String valuesToString() => "";
+}
+
 class CreateSnapshot extends VmCommand {
   final String snapshotPath;
 
@@ -1764,6 +2080,18 @@ enum ErrorCode {
 
 // Any change in [VmCommandCode] must also be done in [Opcode] in
 // src/shared/connection.h.
+// Any change in [BreakpointComparison] must also be done in [Comparison] in
+// src/vm/debug_info.h.
+enum BreakpointComparison {
+  always,
+  equal,
+  notEqual,
+  less,
+  lessOrEqual,
+  greater,
+  greaterOrEqual,
+}
+
 enum VmCommandCode {
   // DO NOT MOVE! The handshake opcodes needs to be the first one as
   // it is used to verify the compiler and vm versions.
@@ -1788,6 +2116,7 @@ enum VmCommandCode {
   ProcessSpawnForMain,
   ProcessRun,
   ProcessSetBreakpoint,
+  ProcessSetConditionalBreakpoint,
   ProcessDeleteBreakpoint,
   ProcessDeleteOneShotBreakpoint,
   ProcessStep,
@@ -1800,6 +2129,7 @@ enum VmCommandCode {
   ProcessBacktrace,
   ProcessUncaughtExceptionRequest,
   ProcessBreakpoint,
+  ProcessLogpoint,
   ProcessInstance,
   ProcessInstanceStructure,
   ProcessRestartFrame,
@@ -1812,11 +2142,22 @@ enum VmCommandCode {
   ProcessGetProcessIds,
   ProcessGetProcessIdsResult,
 
+  SetTracepoint,
+  SetTracepointResult,
+  DeleteTracepoint,
+  DeleteTracepointResult,
+  TracepointHistogramsRequest,
+  TracepointHistograms,
+
   SetEntryPoint,
+  SetSourcePositions,
   CreateSnapshot,
   ProgramInfo,
   CollectGarbage,
 
+  CommandBatch,
+  CompressedMessage,
+
   NewMap,
   DeleteMap,
   PushFromMap,
@@ -1832,6 +2173,7 @@ enum VmCommandCode {
   PushNewDouble,
   PushNewOneByteString,
   PushNewTwoByteString,
+  PushNewByteArray,
   PushNewInstance,
   PushNewArray,
   PushNewFunction,
@@ -7,8 +7,12 @@ library dartino.vm_context;
 
 import 'dart:async';
 
+import 'dart:convert' show
+    UTF8;
+
 import 'dart:typed_data' show
-    ByteData;
+    ByteData,
+    Uint8List;
 
 import 'dart:io' show
     File;
@@ -27,7 +31,9 @@ import 'src/debug_info.dart';
 import 'debug_state.dart';
 
 import 'src/shared_command_infrastructure.dart' show
+    CommandBuffer,
     CommandTransformerBuilder,
+    decompress,
     toUint8ListView;
 
 import 'src/hub/session_manager.dart' show
@@ -55,6 +61,15 @@ class SessionCommandTransformerBuilder
     extends CommandTransformerBuilder<Pair<int, ByteData>> {
 
   Pair<int, ByteData> makeCommand(int code, ByteData payload) {
+    if (code == VmCommandCode.CompressedMessage.index) {
+      // The original opcode and length precede the compressed payload.
+      Uint8List bytes = toUint8ListView(payload);
+      int length = CommandBuffer.readInt32FromBuffer(bytes, 1);
+      Uint8List decompressed = decompress(
+          toUint8ListView(bytes, 5, bytes.length - 5), length);
+      return new Pair<int, ByteData>(
+          bytes[0], decompressed.buffer.asByteData());
+    }
     return new Pair<int, ByteData>(code, payload);
   }
 }
@@ -86,6 +101,10 @@ abstract class DebugListener {
   breakpointAdded(int processId, Breakpoint breakpoint) {}
   // A breakpoint has been removed.
   breakpointRemoved(int processId, Breakpoint breakpoint) {}
+  // A process has passed a logpoint without pausing. [value] is null unless
+  // the logpoint logs a slot holding a small integer.
+  logpoint(int processId, Breakpoint breakpoint, int hitCount,
+           int suppressedCount, int value) {}
   // A garbage collection event.
   gc(int processId) {}
   // Notification of bytes written to stdout.
@@ -110,6 +129,16 @@ class SinkDebugListener extends DebugListener {
   writeStdErr(int processId, List<int> data) {
     stderrSink.add(data);
   }
+
+  logpoint(int processId, Breakpoint breakpoint, int hitCount,
+           int suppressedCount, int value) {
+    StringBuffer message = new StringBuffer()
+        ..write("Logpoint ${breakpoint.id} hit $hitCount times");
+    if (value != null) message.write(", value: $value");
+    if (suppressedCount > 0) message.write(" ($suppressedCount suppressed)");
+    message.write("\n");
+    stdoutSink.add(UTF8.encode(message.toString()));
+  }
 }
 
 /// Encapsulates a connection to a running dartino-vm and provides a
@@ -215,12 +244,16 @@ class DartinoVmContext {
               'not specify how many commands the response will have.');
     }
 
-    VmCommand lastResponse;
+    // The dartino-vm answers commands in order, so all commands are sent
+    // before reading any response to save round trips.
+    int responses = 0;
     for (VmCommand command in commands) {
       await sendCommand(command);
-      for (int i = 0; i < command.numberOfResponsesExpected; i++) {
-        lastResponse = await readNextCommand();
-      }
+      responses += command.numberOfResponsesExpected;
+    }
+    VmCommand lastResponse;
+    for (int i = 0; i < responses; i++) {
+      lastResponse = await readNextCommand();
     }
     return lastResponse;
   }
@@ -270,6 +303,14 @@ class DartinoVmContext {
         notifyListeners((DebugListener listener) {
           listener.writeStdErr(0, command.value);
         });
+      } else if (command is ProcessLogpoint) {
+        Breakpoint breakpoint = debugState.breakpoints[command.breakpointId];
+        if (breakpoint != null) {
+          notifyListeners((DebugListener listener) {
+            listener.logpoint(command.processId, breakpoint, command.hitCount,
+                command.suppressedCount, command.value);
+          });
+        }
       } else {
         result = command;
       }
@@ -322,7 +363,9 @@ class DartinoVmContext {
   }
 
   Future applyDelta(DartinoDelta delta) async {
-    VmCommand response = await runCommands(delta.commands);
+    // Programs consist of many small commands, so send them as one batch.
+    VmCommand response =
+        await runCommand(new CommandBatch(delta.commands));
     dartinoSystem = delta.system;
     return response;
   }
@@ -349,7 +392,7 @@ class DartinoVmContext {
 
     retryLoop() async {
       while (!completer.isCompleted) {
-        sendCommand(new HandShake(version));
+        sendCommand(new HandShake(version, VmFeatures.all));
         if (maxTimeSpent == null) break;
         // TODO(sigurdm): The vm should allow several handshakes.
         await new Future.delayed(new Duration(seconds: 2));
@@ -634,6 +677,66 @@ class DartinoVmContext {
     return breakpoint;
   }
 
+  /// Sets a breakpoint that is filtered in the VM. See
+  /// [ProcessSetConditionalBreakpoint] for the meaning of the arguments.
+  /// Hits of logpoints are reported to [DebugListener.logpoint].
+  Future<Breakpoint> setConditionalBreakpoint(
+      DartinoFunction function,
+      int bytecodeIndex,
+      {BreakpointComparison comparison: BreakpointComparison.always,
+       int slot: 0,
+       int value: 0,
+       int ignoreCount: 0,
+       bool isLogpoint: false,
+       int logSlot: -1,
+       int maxLogsPerSecond: 0}) async {
+    ProcessSetBreakpoint response = await runCommands([
+        new PushFromMap(MapId.methods, function.functionId),
+        new ProcessSetConditionalBreakpoint(bytecodeIndex,
+            comparison: comparison, slot: slot, value: value,
+            ignoreCount: ignoreCount, isLogpoint: isLogpoint,
+            logSlot: logSlot, maxLogsPerSecond: maxLogsPerSecond),
+    ]);
+    int breakpointId = response.value;
+    if (breakpointId < 0) return null;
+    // Setting a conditional breakpoint replaces any breakpoint at the same
+    // location.
+    debugState.breakpoints.keys.where((int id) {
+      Breakpoint existing = debugState.breakpoints[id];
+      return existing.function == function &&
+          existing.bytecodeIndex == bytecodeIndex;
+    }).toList().forEach(debugState.breakpoints.remove);
+    Breakpoint breakpoint =
+        new Breakpoint(function, bytecodeIndex, breakpointId);
+    debugState.breakpoints[breakpointId] = breakpoint;
+    notifyListeners(
+        (DebugListener listener) => listener.breakpointAdded(0, breakpoint));
+    return breakpoint;
+  }
+
+  /// Starts counting the calls of [function] and measuring their latency.
+  /// Returns the id of the tracepoint. Can be called while the program is
+  /// running.
+  Future<int> setTracepoint(DartinoFunction function) async {
+    SetTracepointResult response = await runCommands([
+        new PushFromMap(MapId.methods, function.functionId),
+        const SetTracepoint(),
+    ]);
+    return response.id;
+  }
+
+  Future<bool> deleteTracepoint(int id) async {
+    DeleteTracepointResult response =
+        await runCommand(new DeleteTracepoint(id));
+    return response.id == id;
+  }
+
+  Future<List<TracepointHistogram>> tracepointHistograms() async {
+    TracepointHistograms response =
+        await runCommand(const TracepointHistogramsRequest());
+    return response.histograms;
+  }
+
   // TODO(ager): Let setBreakpoint return a stream instead and deal with
   // error situations such as bytecode indices that are out of bounds for
   // some of the methods with the given name.
@@ -6,6 +6,7 @@
 library http;
 
 import 'dart:collection';
+import 'dart:dartino' show intern;
 import 'dart:typed_data';
 
 import 'package:charcode/ascii.dart';
@@ -176,8 +177,10 @@ class HttpHeaders {
   }
 
   void add(String key, String value) {
+    // Header names repeat across responses, so share them through the intern
+    // table instead of keeping a copy per response.
     // If the key is already present, verify that it allows multiple values.
-    _values.putIfAbsent(key.toLowerCase(), () => []).add(value);
+    _values.putIfAbsent(intern(key.toLowerCase()), () => []).add(value);
   }
 
   List<String> values(String key) {
@@ -27,6 +27,10 @@ DARTINO_SRC_FLASHTOOL := $(DARTINO_ROOT)/src/tools/flashtool
 # to build the flashtool helper. So as long as flashtool still builds in
 # a crosscompilation setting it does not matter where a new file goes.
 DARTINO_SRC_VM_SRCS_RUNTIME := \
+	$(DARTINO_SRC_VM)/constant_map_index.cc \
+	$(DARTINO_SRC_VM)/constant_map_index.h \
+	$(DARTINO_SRC_VM)/coroutine_registry.cc \
+	$(DARTINO_SRC_VM)/coroutine_registry.h \
 	$(DARTINO_SRC_VM)/dartino_api_impl.cc \
 	$(DARTINO_SRC_VM)/dartino_api_impl.h \
 	$(DARTINO_SRC_VM)/dartino.cc \
@@ -54,17 +58,21 @@ DARTINO_SRC_VM_SRCS_RUNTIME := \
 	$(DARTINO_SRC_VM)/heap.h \
 	$(DARTINO_SRC_VM)/heap_validator.cc \
 	$(DARTINO_SRC_VM)/heap_validator.h \
+	$(DARTINO_SRC_VM)/intern_table.cc \
+	$(DARTINO_SRC_VM)/intern_table.h \
 	$(DARTINO_SRC_VM)/intrinsics.cc \
 	$(DARTINO_SRC_VM)/intrinsics.h \
 	$(DARTINO_SRC_VM)/links.cc \
 	$(DARTINO_SRC_VM)/links.h \
-	$(DARTINO_SRC_VM)/log_print_interceptor.cc \
-	$(DARTINO_SRC_VM)/log_print_interceptor.h \
+	$(DARTINO_SRC_VM)/log_writer.cc \
+	$(DARTINO_SRC_VM)/log_writer.h \
 	$(DARTINO_SRC_VM)/lookup_cache.cc \
 	$(DARTINO_SRC_VM)/lookup_cache.h \
 	$(DARTINO_SRC_VM)/mailbox.h \
 	$(DARTINO_SRC_VM)/message_mailbox.cc \
 	$(DARTINO_SRC_VM)/message_mailbox.h \
+	$(DARTINO_SRC_VM)/metrics.cc \
+	$(DARTINO_SRC_VM)/metrics.h \
 	$(DARTINO_SRC_VM)/multi_hashset.h \
 	$(DARTINO_SRC_VM)/native_process_disabled.cc \
 	$(DARTINO_SRC_VM)/native_process_posix.cc \
@@ -75,6 +83,8 @@ DARTINO_SRC_VM_SRCS_RUNTIME := \
 	$(DARTINO_SRC_VM)/natives_lk.cc \
 	$(DARTINO_SRC_VM)/natives_posix.cc \
 	$(DARTINO_SRC_VM)/natives_windows.cc \
+	$(DARTINO_SRC_VM)/number_conversion.cc \
+	$(DARTINO_SRC_VM)/number_conversion.h \
 	$(DARTINO_SRC_VM)/object.cc \
 	$(DARTINO_SRC_VM)/object.h \
 	$(DARTINO_SRC_VM)/object_list.cc \
@@ -113,10 +123,16 @@ DARTINO_SRC_VM_SRCS_RUNTIME := \
 	$(DARTINO_SRC_VM)/session.h \
 	$(DARTINO_SRC_VM)/session_no_debugging.h \
 	$(DARTINO_SRC_VM)/signal.h \
+	$(DARTINO_SRC_VM)/slab_allocator.cc \
+	$(DARTINO_SRC_VM)/slab_allocator.h \
 	$(DARTINO_SRC_VM)/snapshot.cc \
 	$(DARTINO_SRC_VM)/snapshot.h \
 	$(DARTINO_SRC_VM)/sort.cc \
 	$(DARTINO_SRC_VM)/sort.h \
+	$(DARTINO_SRC_VM)/source_positions.cc \
+	$(DARTINO_SRC_VM)/source_positions.h \
+	$(DARTINO_SRC_VM)/spinlock.cc \
+	$(DARTINO_SRC_VM)/spinlock.h \
 	$(DARTINO_SRC_VM)/thread_cmsis.cc \
 	$(DARTINO_SRC_VM)/thread_cmsis.h \
 	$(DARTINO_SRC_VM)/thread.h \
@@ -128,6 +144,10 @@ DARTINO_SRC_VM_SRCS_RUNTIME := \
 	$(DARTINO_SRC_VM)/thread_posix.h \
 	$(DARTINO_SRC_VM)/thread_windows.cc \
 	$(DARTINO_SRC_VM)/thread_windows.h \
+	$(DARTINO_SRC_VM)/timeline.cc \
+	$(DARTINO_SRC_VM)/timeline.h \
+	$(DARTINO_SRC_VM)/tracepoints.cc \
+	$(DARTINO_SRC_VM)/tracepoints.h \
 	$(DARTINO_SRC_VM)/unicode.cc \
 	$(DARTINO_SRC_VM)/unicode.h \
 	$(DARTINO_SRC_VM)/vector.cc \
@@ -180,6 +200,8 @@ DARTINO_SRC_SHARED_SRCS := \
 	$(DARTINO_SRC_SHARED)/atomic.h \
 	$(DARTINO_SRC_SHARED)/bytecodes.cc \
 	$(DARTINO_SRC_SHARED)/bytecodes.h \
+	$(DARTINO_SRC_SHARED)/compression.cc \
+	$(DARTINO_SRC_SHARED)/compression.h \
 	$(DARTINO_SRC_SHARED)/connection.cc \
 	$(DARTINO_SRC_SHARED)/connection.h \
 	$(DARTINO_SRC_SHARED)/flags.cc \
@@ -78,20 +78,11 @@ UartConnection::~UartConnection() {
   osSemaphoreDelete(uart_semaphore_);
 }
 
-void UartConnection::Send(Opcode opcode, const WriteBuffer& buffer) {
-  UartDevice *uart = DeviceManager::GetDeviceManager()->GetUart(uart_);
-  ScopedLock scoped_lock(send_mutex_);
-  int length = buffer.offset();
-  uint8 header[5];
-  Utils::WriteInt32(header, length);
-  header[4] = opcode;
-  uart->Write(header, 0, 5);
-  if (length != 0) {
-    BlockingWrite(buffer.GetBuffer(), length);
-  }
+void UartConnection::SendBytes(const uint8* bytes, int length) {
+  BlockingWrite(const_cast<uint8*>(bytes), length);
 }
 
-Connection::Opcode UartConnection::Receive() {
+Connection::Opcode UartConnection::ReceiveMessage() {
   incoming_.ClearBuffer();
   uint8 header[5];
   if (!BlockingRead(header, 5)) {
@@ -15,8 +15,10 @@ namespace dartino {
 class UartConnection : public Connection {
  public:
   static UartConnection* Connect(int uart_handle);
-  void Send(Opcode opcode, const WriteBuffer& buffer);
-  Connection::Opcode Receive();
+
+ protected:
+  void SendBytes(const uint8* bytes, int length);
+  Connection::Opcode ReceiveMessage();
 
  private:
   explicit UartConnection(int uart);
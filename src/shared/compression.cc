@@ -0,0 +1,106 @@
+// Copyright (c) 2016, the Dartino project authors. Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE.md file.
+
+#include "src/shared/compression.h"
+
+#include <string.h>
+
+#include "src/shared/assert.h"
+
+namespace dartino {
+
+static inline int Hash(const uint8* bytes) {
+  uint32 value = bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) |
+                 (static_cast<uint32>(bytes[3]) << 24);
+  return (value * 2654435761u) >> (32 - Compression::kHashBits);
+}
+
+static bool EmitLiterals(const uint8* literals, int count,
+                         uint8* output, int capacity, int* position) {
+  while (count > 0) {
+    int run = count < Compression::kMaxLiterals
+        ? count : Compression::kMaxLiterals;
+    if (*position + 1 + run > capacity) return false;
+    output[(*position)++] = run - 1;
+    memcpy(output + *position, literals, run);
+    *position += run;
+    literals += run;
+    count -= run;
+  }
+  return true;
+}
+
+int Compression::Compress(const uint8* input, int length,
+                          uint8* output, int capacity, int* table) {
+  // The last position each hash of four bytes was seen at, or -1.
+  for (int i = 0; i < kTableSize; i++) table[i] = -1;
+
+  int position = 0;
+  int literals = 0;
+  int i = 0;
+  while (i + kMinMatch <= length) {
+    int hash = Hash(input + i);
+    int candidate = table[hash];
+    table[hash] = i;
+    if (candidate < 0 || i - candidate > kMaxDistance ||
+        memcmp(input + candidate, input + i, kMinMatch) != 0) {
+      i++;
+      continue;
+    }
+    int match = kMinMatch;
+    while (match < kMaxMatch && i + match < length &&
+           input[candidate + match] == input[i + match]) {
+      match++;
+    }
+    if (!EmitLiterals(input + literals, i - literals,
+                      output, capacity, &position)) {
+      return -1;
+    }
+    if (position + 3 > capacity) return -1;
+    int distance = i - candidate;
+    output[position++] = 0x80 | (match - kMinMatch);
+    output[position++] = distance & 0xff;
+    output[position++] = distance >> 8;
+    i += match;
+    literals = i;
+  }
+  if (!EmitLiterals(input + literals, length - literals,
+                    output, capacity, &position)) {
+    return -1;
+  }
+  return position;
+}
+
+bool Compression::Decompress(const uint8* input, int length,
+                             uint8* output, int output_length) {
+  int i = 0;
+  int position = 0;
+  while (i < length) {
+    int tag = input[i++];
+    if (tag < 0x80) {
+      int run = tag + 1;
+      if (i + run > length || position + run > output_length) return false;
+      memcpy(output + position, input + i, run);
+      i += run;
+      position += run;
+    } else {
+      if (i + 2 > length) return false;
+      int match = (tag & 0x7f) + kMinMatch;
+      int distance = input[i] | (input[i + 1] << 8);
+      i += 2;
+      if (distance == 0 || distance > position ||
+          position + match > output_length) {
+        return false;
+      }
+      // Copy byte by byte, the match may overlap the bytes it produces.
+      for (int j = 0; j < match; j++) {
+        output[position + j] = output[position + j - distance];
+      }
+      position += match;
+    }
+  }
+  return position == output_length;
+}
+
+}  // namespace dartino
@@ -0,0 +1,48 @@
+// Copyright (c) 2016, the Dartino project authors. Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE.md file.
+
+#ifndef SRC_SHARED_COMPRESSION_H_
+#define SRC_SHARED_COMPRESSION_H_
+
+#include "src/shared/globals.h"
+
+namespace dartino {
+
+// A small LZ77 compressor for messages to the compiler. The caller passes
+// in the hash table, so compressing needs no allocation and only a few
+// words of stack, and can be used on devices with small thread stacks.
+//
+// The compressed data is a sequence of tokens. A tag byte below 0x80
+// starts a run of (tag + 1) literal bytes. Any other tag is a match of
+// ((tag & 0x7f) + kMinMatch) bytes, followed by the 16-bit little endian
+// distance back to the start of the match. Matches may overlap the bytes
+// they produce.
+//
+// The decompressor in pkg/dartino_compiler/lib/src/
+// shared_command_infrastructure.dart must be kept in sync with this format.
+class Compression {
+ public:
+  static const int kMinMatch = 4;
+  static const int kMaxMatch = 0x7f + kMinMatch;
+  static const int kMaxDistance = 0xffff;
+  static const int kMaxLiterals = 0x80;
+
+  static const int kHashBits = 10;
+  static const int kTableSize = 1 << kHashBits;
+
+  // Compresses [length] bytes of [input] into [output]. Returns the size of
+  // the compressed data or -1 if it does not fit in [capacity] bytes.
+  // [table] is scratch space of kTableSize entries.
+  static int Compress(const uint8* input, int length,
+                      uint8* output, int capacity, int* table);
+
+  // Decompresses [length] bytes of [input] into [output], which must be
+  // [output_length] bytes. Returns false if the input is malformed.
+  static bool Decompress(const uint8* input, int length,
+                         uint8* output, int output_length);
+};
+
+}  // namespace dartino
+
+#endif  // SRC_SHARED_COMPRESSION_H_
@@ -0,0 +1,96 @@
+// Copyright (c) 2016, the Dartino project authors. Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE.md file.
+
+#include <stdlib.h>
+
+#include "src/shared/assert.h"
+#include "src/shared/compression.h"
+#include "src/shared/test_case.h"
+#include "src/shared/utils.h"
+
+namespace dartino {
+
+static int table[Compression::kTableSize];
+
+static int RoundTrip(const uint8* input, int length) {
+  int capacity = length + length / Compression::kMaxLiterals + 1;
+  uint8* compressed = static_cast<uint8*>(malloc(capacity));
+  int compressed_length =
+      Compression::Compress(input, length, compressed, capacity, table);
+  EXPECT(compressed_length >= 0);
+  uint8* output = static_cast<uint8*>(malloc(length + 1));
+  EXPECT(Compression::Decompress(compressed, compressed_length,
+                                 output, length));
+  EXPECT_EQ(0, memcmp(input, output, length));
+  // The output length must match exactly.
+  if (length > 0) {
+    EXPECT(!Compression::Decompress(compressed, compressed_length,
+                                    output, length - 1));
+  }
+  EXPECT(!Compression::Decompress(compressed, compressed_length,
+                                  output, length + 1));
+  free(output);
+  free(compressed);
+  return compressed_length;
+}
+
+TEST_CASE(CompressionEmptyAndShort) {
+  const uint8 bytes[] = { 1, 2, 3, 4, 5 };
+  EXPECT_EQ(0, RoundTrip(bytes, 0));
+  EXPECT_EQ(2, RoundTrip(bytes, 1));
+  EXPECT_EQ(6, RoundTrip(bytes, 5));
+}
+
+TEST_CASE(CompressionBacktrace) {
+  // A backtrace of a deep recursion: pairs of 64-bit function ids and
+  // bytecode indices that mostly repeat.
+  const int kFrames = 1000;
+  int length = kFrames * 16;
+  uint8* input = static_cast<uint8*>(malloc(length));
+  for (int i = 0; i < kFrames; i++) {
+    Utils::WriteInt64(input + i * 16, 42 + (i % 3));
+    Utils::WriteInt64(input + i * 16 + 8, (i % 3) * 7);
+  }
+  int compressed = RoundTrip(input, length);
+  EXPECT(compressed < length / 10);
+  free(input);
+}
+
+TEST_CASE(CompressionIncompressible) {
+  const int kLength = 10000;
+  uint8* input = static_cast<uint8*>(malloc(kLength));
+  uint32 state = 12345;
+  for (int i = 0; i < kLength; i++) {
+    state = state * 1103515245 + 12345;
+    input[i] = state >> 24;
+  }
+  RoundTrip(input, kLength);
+  // Does not fit when it does not get smaller.
+  uint8* output = static_cast<uint8*>(malloc(kLength));
+  EXPECT_EQ(-1, Compression::Compress(input, kLength, output, kLength - 1,
+                                      table));
+  free(output);
+  free(input);
+}
+
+TEST_CASE(CompressionOverlappingMatch) {
+  const int kLength = 1000;
+  uint8 input[kLength];
+  for (int i = 0; i < kLength; i++) input[i] = i % 2;
+  EXPECT(RoundTrip(input, kLength) < 40);
+}
+
+TEST_CASE(CompressionMalformed) {
+  uint8 output[16];
+  const uint8 truncated_literals[] = { 3, 1, 2 };
+  EXPECT(!Compression::Decompress(truncated_literals, 3, output, 4));
+  const uint8 distance_too_far[] = { 0, 1, 0x80, 2, 0 };
+  EXPECT(!Compression::Decompress(distance_too_far, 5, output, 5));
+  const uint8 zero_distance[] = { 0, 1, 0x80, 0, 0 };
+  EXPECT(!Compression::Decompress(zero_distance, 5, output, 5));
+  const uint8 truncated_match[] = { 0, 1, 0x80, 1 };
+  EXPECT(!Compression::Decompress(truncated_match, 4, output, 5));
+}
+
+}  // namespace dartino
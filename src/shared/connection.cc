@@ -16,13 +16,19 @@ namespace dartino {
 // a large enough capacity.
 static const int kBufferGrowthSize = 64;
 
-Buffer::Buffer() : buffer_(NULL), buffer_offset_(0), buffer_length_(0) {}
-
-Buffer::~Buffer() { free(buffer_); }
+Buffer::Buffer()
+    : buffer_(NULL),
+      buffer_offset_(0),
+      buffer_length_(0),
+      owns_buffer_(true) {}
+
+Buffer::~Buffer() {
+  if (owns_buffer_) free(buffer_);
+}
 
 void Buffer::ClearBuffer() {
   ASSERT(buffer_offset_ == buffer_length_);
-  free(buffer_);
+  if (owns_buffer_) free(buffer_);
   buffer_ = NULL;
 }
 
@@ -30,6 +36,25 @@ void Buffer::SetBuffer(uint8* buffer, int length) {
   buffer_ = buffer;
   buffer_offset_ = 0;
   buffer_length_ = length;
+  owns_buffer_ = true;
+}
+
+void Buffer::SetBorrowedBuffer(uint8* buffer, int length) {
+  buffer_ = buffer;
+  buffer_offset_ = 0;
+  buffer_length_ = length;
+  owns_buffer_ = false;
+}
+
+void Buffer::TransferTo(Buffer* other) {
+  other->buffer_ = buffer_;
+  other->buffer_offset_ = buffer_offset_;
+  other->buffer_length_ = buffer_length_;
+  other->owns_buffer_ = owns_buffer_;
+  buffer_ = NULL;
+  buffer_offset_ = 0;
+  buffer_length_ = 0;
+  owns_buffer_ = true;
 }
 
 uint8* Buffer::GetBuffer() const {
@@ -64,8 +89,18 @@ void WriteBuffer::WriteBoolean(bool value) {
   buffer_[buffer_offset_++] = value ? 1 : 0;
 }
 
+void WriteBuffer::WriteByte(uint8 value) {
+  EnsureCapacity(1);
+  buffer_[buffer_offset_++] = value;
+}
+
 void WriteBuffer::WriteBytes(const uint8* bytes, int length) {
   WriteInt(length);
+  WriteRawBytes(bytes, length);
+}
+
+void WriteBuffer::WriteRawBytes(const uint8* bytes, int length) {
+  if (length == 0) return;
   EnsureCapacity(length);
   memcpy(buffer_ + buffer_offset_, bytes, length);
   buffer_offset_ += length;
@@ -99,6 +134,18 @@ bool ReadBuffer::ReadBoolean() {
   return buffer_[buffer_offset_++] == 1;
 }
 
+uint8 ReadBuffer::ReadByte() {
+  ASSERT(buffer_offset_ + 1 <= buffer_length_);
+  return buffer_[buffer_offset_++];
+}
+
+uint8* ReadBuffer::ReadView(int length) {
+  ASSERT(buffer_offset_ + length <= buffer_length_);
+  uint8* view = buffer_ + buffer_offset_;
+  buffer_offset_ += length;
+  return view;
+}
+
 uint8* ReadBuffer::ReadBytes(int* length) {
   int len = ReadInt();
   ASSERT(buffer_offset_ + len <= buffer_length_);
@@ -109,8 +156,97 @@ uint8* ReadBuffer::ReadBytes(int* length) {
   return buffer;
 }
 
+Connection::Connection()
+    : send_mutex_(Platform::CreateMutex()), batch_depth_(0), features_(0) {}
+
 Connection::~Connection() {
   delete send_mutex_;
 }
 
+void Connection::Send(Opcode opcode, const WriteBuffer& buffer) {
+  ScopedLock scoped_lock(send_mutex_);
+  const uint8* payload = buffer.GetBuffer();
+  int length = buffer.offset();
+  if ((features_ & kCompressedMessages) == 0 ||
+      length < kCompressionThreshold ||
+      !AddCompressedFrame(opcode, payload, length)) {
+    AddFrame(opcode, payload, length);
+  }
+  if (batch_depth_ == 0) Flush();
+}
+
+void Connection::BeginBatch() {
+  ScopedLock scoped_lock(send_mutex_);
+  batch_depth_++;
+}
+
+void Connection::EndBatch() {
+  ScopedLock scoped_lock(send_mutex_);
+  ASSERT(batch_depth_ > 0);
+  if (--batch_depth_ == 0) Flush();
+}
+
+int Connection::EnableFeatures(int features) {
+  ScopedLock scoped_lock(send_mutex_);
+  features_ = features & kCompressedMessages;
+  return features_;
+}
+
+void Connection::AddFrame(Opcode opcode, const uint8* payload, int length) {
+  // A frame is a 32-bit payload length and an opcode byte, followed by the
+  // payload.
+  outgoing_.WriteInt(length);
+  outgoing_.WriteByte(opcode);
+  outgoing_.WriteRawBytes(payload, length);
+}
+
+bool Connection::AddCompressedFrame(Opcode opcode, const uint8* payload,
+                                    int length) {
+  // The payload of a kCompressedMessage is the opcode and the length of the
+  // original payload, followed by the compressed payload. It is compressed
+  // directly into [outgoing_], which keeps its buffer between messages.
+  static const int kFrameHeaderSize = 5;
+  static const int kHeaderSize = 5;
+  int capacity = length - kHeaderSize - 1;
+  uint8* frame = outgoing_.Reserve(kFrameHeaderSize + kHeaderSize + capacity);
+  uint8* header = frame + kFrameHeaderSize;
+  int compressed_length = Compression::Compress(
+      payload, length, header + kHeaderSize, capacity, compression_table_);
+  if (compressed_length < 0) return false;
+  Utils::WriteInt32(frame, kHeaderSize + compressed_length);
+  frame[4] = kCompressedMessage;
+  header[0] = opcode;
+  Utils::WriteInt32(header + 1, length);
+  outgoing_.Advance(kFrameHeaderSize + kHeaderSize + compressed_length);
+  return true;
+}
+
+void Connection::Flush() {
+  if (outgoing_.offset() == 0) return;
+  SendBytes(outgoing_.GetBuffer(), outgoing_.offset());
+  outgoing_.Rewind();
+}
+
+Connection::Opcode Connection::Receive() {
+  if (batch_.offset() < batch_.length()) return ReceiveFromBatch();
+  batch_.ClearBuffer();
+  Opcode opcode = ReceiveMessage();
+  if (opcode != kCommandBatch) return opcode;
+  incoming_.TransferTo(&batch_);
+  if (batch_.length() == 0) return Receive();
+  return ReceiveFromBatch();
+}
+
+Connection::Opcode Connection::ReceiveFromBatch() {
+  // Commands in a batch are framed like messages on the wire: a 32-bit
+  // payload length and an opcode byte, followed by the payload. The payload
+  // is read directly from the batch.
+  incoming_.ClearBuffer();
+  int length = batch_.ReadInt();
+  Opcode opcode = static_cast<Opcode>(batch_.ReadByte());
+  ASSERT(opcode != kCommandBatch);
+  incoming_.SetBorrowedBuffer(batch_.ReadView(length), length);
+  return opcode;
+}
+
 }  // namespace dartino
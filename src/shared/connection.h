@@ -5,6 +5,7 @@
 #ifndef SRC_SHARED_CONNECTION_H_
 #define SRC_SHARED_CONNECTION_H_
 
+#include "src/shared/compression.h"
 #include "src/shared/globals.h"
 #include "src/shared/platform.h"
 
@@ -19,14 +20,21 @@ class Buffer {
 
   void ClearBuffer();
   void SetBuffer(uint8* buffer, int length);
+  // Uses [buffer] without taking ownership of it.
+  void SetBorrowedBuffer(uint8* buffer, int length);
   uint8* GetBuffer() const;
 
+  // Moves the contents and the ownership of this buffer to [other].
+  void TransferTo(Buffer* other);
+
   int offset() const { return buffer_offset_; }
+  int length() const { return buffer_length_; }
 
  protected:
   uint8* buffer_;
   int buffer_offset_;
   int buffer_length_;
+  bool owns_buffer_;
 };
 
 class ReadBuffer : public Buffer {
@@ -35,7 +43,10 @@ class ReadBuffer : public Buffer {
   int64 ReadInt64();
   double ReadDouble();
   bool ReadBoolean();
+  uint8 ReadByte();
   uint8* ReadBytes(int* length);
+  // Returns a pointer to the next [length] bytes without copying them.
+  uint8* ReadView(int length);
 };
 
 class WriteBuffer : public Buffer {
@@ -45,8 +56,22 @@ class WriteBuffer : public Buffer {
   void WriteInt64(int64 value);
   void WriteDouble(double value);
   void WriteBoolean(bool value);
+  void WriteByte(uint8 value);
+  // Writes the length of [bytes] followed by the bytes.
   void WriteBytes(const uint8* bytes, int length);
+  // Writes [bytes] without their length.
+  void WriteRawBytes(const uint8* bytes, int length);
+  // Returns space for [bytes] bytes at the current offset, to be filled in
+  // directly. [Advance] adds the bytes that were actually written.
+  uint8* Reserve(int bytes) {
+    EnsureCapacity(bytes);
+    return buffer_ + buffer_offset_;
+  }
+  void Advance(int bytes) { buffer_offset_ += bytes; }
   void WriteString(const char* str);
+
+  // Discards the contents but keeps the allocated buffer for reuse.
+  void Rewind() { buffer_offset_ = 0; }
 };
 
 class Connection {
@@ -58,6 +83,13 @@ class Connection {
     kSnapshotCreationError,
   };
 
+  // Optional features negotiated during the handshake. Any change in
+  // [Feature] must also be done in pkg/dartino_compiler/lib/vm_commands.dart.
+  enum Feature {
+    // Large messages to the compiler are sent as kCompressedMessage.
+    kCompressedMessages = 1 << 0,
+  };
+
   // Any change in [Opcode] must also be done in [VMCommandCode] in
   // pkg/dartino_compiler/lib/vm_commands.dart.
   enum Opcode {
@@ -80,6 +112,7 @@ class Connection {
     kProcessSpawnForMain,
     kProcessRun,
     kProcessSetBreakpoint,
+    kProcessSetConditionalBreakpoint,
     kProcessDeleteBreakpoint,
     kProcessDeleteOneShotBreakpoint,
     kProcessStep,
@@ -92,6 +125,7 @@ class Connection {
     kProcessBacktrace,
     kProcessUncaughtExceptionRequest,
     kProcessBreakpoint,
+    kProcessLogpoint,
     kProcessInstance,
     kProcessInstanceStructure,
     kProcessRestartFrame,
@@ -104,11 +138,22 @@ class Connection {
     kProcessGetProcessIds,
     kProcessGetProcessIdsResult,
 
+    kSetTracepoint,
+    kSetTracepointResult,
+    kDeleteTracepoint,
+    kDeleteTracepointResult,
+    kTracepointHistogramsRequest,
+    kTracepointHistograms,
+
     kSetEntryPoint,
+    kSetSourcePositions,
     kCreateSnapshot,
     kProgramInfo,
     kCollectGarbage,
 
+    kCommandBatch,
+    kCompressedMessage,
+
     kNewMap,
     kDeleteMap,
     kPushFromMap,
@@ -124,6 +169,7 @@ class Connection {
     kPushNewDouble,
     kPushNewOneByteString,
     kPushNewTwoByteString,
+    kPushNewByteArray,
     kPushNewInstance,
     kPushNewArray,
     kPushNewFunction,
@@ -171,12 +217,74 @@ class Connection {
   bool ReadBoolean() { return incoming_.ReadBoolean(); }
   uint8* ReadBytes(int* length) { return incoming_.ReadBytes(length); }
 
-  virtual void Send(Opcode opcode, const WriteBuffer& buffer) = 0;
-  virtual Opcode Receive() = 0;
+  bool HasMoreData() const { return incoming_.offset() < incoming_.length(); }
+
+  // Sends a message. Within a batch the message is only written to the
+  // transport when the outermost batch ends. Messages larger than
+  // kCompressionThreshold are compressed if the compiler supports it.
+  void Send(Opcode opcode, const WriteBuffer& buffer);
+
+  void BeginBatch();
+  void EndBatch();
+
+  // Enables the features in [features] the connection supports and returns
+  // them.
+  int EnableFeatures(int features);
+
+  // Returns the next command. A kCommandBatch message holds a sequence of
+  // framed commands that are returned one by one, without further reads
+  // from the underlying transport.
+  Opcode Receive();
+
+  // Returns the commands of the current batch that have not been received
+  // yet, framed as on the wire, or NULL if there are none.
+  uint8* BatchedCommands(int* length) const {
+    *length = batch_.length() - batch_.offset();
+    return (*length > 0) ? batch_.GetBuffer() + batch_.offset() : NULL;
+  }
 
  protected:
+  // Writes [length] bytes of framed messages to the transport.
+  virtual void SendBytes(const uint8* bytes, int length) = 0;
+
+  // Reads the next message from the transport into [incoming_].
+  virtual Opcode ReceiveMessage() = 0;
+
   ReadBuffer incoming_;
   Mutex* send_mutex_;
+
+ private:
+  static const int kCompressionThreshold = 1024;
+
+  Opcode ReceiveFromBatch();
+
+  // Appends the frame of a message to [outgoing_].
+  void AddFrame(Opcode opcode, const uint8* payload, int length);
+  // Returns false if the message does not get smaller by compression.
+  bool AddCompressedFrame(Opcode opcode, const uint8* payload, int length);
+  void Flush();
+
+  ReadBuffer batch_;
+
+  // The framed messages that have not been written to the transport yet.
+  // Guarded by [send_mutex_], like the fields below.
+  WriteBuffer outgoing_;
+  int batch_depth_;
+  int features_;
+  int compression_table_[Compression::kTableSize];
+};
+
+// Coalesces the messages sent in a scope into a single write.
+class ScopedSendBatch {
+ public:
+  explicit ScopedSendBatch(Connection* connection) : connection_(connection) {
+    connection_->BeginBatch();
+  }
+
+  ~ScopedSendBatch() { connection_->EndBatch(); }
+
+ private:
+  Connection* connection_;
 };
 
 }  // namespace dartino
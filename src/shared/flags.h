@@ -44,11 +44,33 @@ namespace dartino {
                "Print statistics about the program")                      \
   FLAG_BOOLEAN(release, print_heap_statistics, false,                     \
                "Print heap statistics before GC")                         \
+  FLAG_BOOLEAN(release, print_lock_statistics, false,                     \
+               "Print spinlock contention statistics on exit")            \
   FLAG_INTEGER(release, max_heap_size, 0,                                 \
                "Max heap size in kbytes (default unlimited)")             \
   FLAG_INTEGER(release, semispace_size, 16,                               \
                "New-space semispace size in kbytes (default 16)")         \
+  FLAG_INTEGER(release, scheduler_threads, 4,                             \
+               "Number of scheduler worker threads")                      \
+  FLAG_BOOLEAN(release, pin_scheduler_threads, false,                     \
+               "Pin each scheduler worker thread to a CPU")               \
+  FLAG_BOOLEAN(release, print_scheduler_statistics, false,                \
+               "Print statistics for each scheduler worker on exit")      \
+  FLAG_INTEGER(release, initial_stack_size, 256,                          \
+               "Initial stack size of processes in words")                \
+  FLAG_INTEGER(release, max_stack_size, 0,                                \
+               "Max stack size of processes in words, 0 for default")     \
+  FLAG_BOOLEAN(release, shrink_idle_stacks, true,                         \
+               "Shrink mostly unused stacks when processes go idle")      \
+  FLAG_INTEGER(release, lookup_cache_secondary_size, 2111,                \
+               "Entries in each worker's secondary lookup cache")         \
+  FLAG_INTEGER(release, metrics_port, 0,                                  \
+               "Serve VM metrics over HTTP on this localhost port")       \
   FLAG_BOOLEAN(release, verbose, false, "Verbose output")                 \
+  FLAG_BOOLEAN(release, async_print, false,                               \
+               "Write stdout and stderr from a background thread")        \
+  FLAG_BOOLEAN(release, drop_print_output, false,                         \
+               "Drop output when buffered output can't keep up")          \
   FLAG_BOOLEAN(debug, print_flags, false, "Print flags")                  \
   FLAG_INTEGER(release, profile_interval, 1000, "Profile interval in us") \
   FLAG_CSTRING(release, filter, NULL, "Filter string for unit testing")   \
@@ -56,6 +78,8 @@ namespace dartino {
                "Collect execution time sampels of the entire VM")         \
   FLAG_CSTRING(release, tick_file, "dartino.ticks",                       \
                "Write tick samples in this file")                         \
+  FLAG_CSTRING(release, timeline_file, NULL,                              \
+               "Write a Chrome trace of scheduler, GC and I/O events")    \
   /* Temporary compiler flags */                                          \
   FLAG_BOOLEAN(release, trace_compiler, false, "")                        \
   FLAG_BOOLEAN(release, trace_library, false, "")
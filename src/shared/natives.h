@@ -123,6 +123,7 @@ namespace dartino {
   N(ListIndexGet, "FixedListBase", "[]", true)                                 \
                                                                                \
   N(ByteListIndexGet, "_ConstantByteList", "[]", true)                         \
+  N(ConstantMapIndexOf, "_ConstantMap", "_indexOf", true)                      \
                                                                                \
   N(ListIndexSet, "FixedList", "[]=", true)                                    \
                                                                                \
@@ -138,6 +139,7 @@ namespace dartino {
                                                                                \
   N(CoroutineCurrent, "Coroutine", "_coroutineCurrent", true)                  \
   N(CoroutineNewStack, "Coroutine", "_coroutineNewStack", true)                \
+  N(CoroutineExit, "Coroutine", "_coroutineExit", true)                        \
                                                                                \
   N(StopwatchFrequency, "Stopwatch", "_frequency", true)                       \
   N(StopwatchNow, "Stopwatch", "_now", true)                                   \
@@ -263,8 +265,15 @@ namespace dartino {
                                                                                \
   N(IsImmutable, "<none>", "_isImmutable", true)                               \
   N(IdentityHashCode, "<none>", "_identityHashCode", true)                     \
+  N(StringIntern, "<none>", "_intern", true)                                   \
+  N(VmMetrics, "<none>", "_vmMetrics", true)                                   \
+  N(PersistentMapLookup, "<none>", "_persistentMapLookup", true)               \
+  N(PersistentVectorLookup, "<none>", "_persistentVectorLookup", true)         \
                                                                                \
   N(NativeProcessSpawnDetached, "NativeProcess", "_spawnDetached", true)       \
+  N(NativeProcessSpawn, "NativeProcess", "_spawn", true)                       \
+  N(NativeProcessWait, "NativeProcess", "_wait", true)                         \
+  N(NativeProcessClose, "NativeProcess", "_close", true)                       \
                                                                                \
   N(Uint32DigitsAllocate, "_Uint32Digits", "_allocate", true)                  \
   N(Uint32DigitsGet, "_Uint32Digits", "_getUint32", true)                      \
@@ -5,7 +5,10 @@
 #ifndef SRC_SHARED_PLATFORM_H_
 #define SRC_SHARED_PLATFORM_H_
 
+#include <limits.h>
+
 #include "src/shared/assert.h"
+#include "src/shared/atomic.h"
 #include "src/shared/globals.h"
 #include "src/shared/list.h"
 
@@ -114,8 +117,8 @@ int FormatString(char* buffer, size_t length, const char* format, ...);
 int GetLastError();
 void SetLastError(int value);
 
-// Platform dependent max Dart stack size.
-// TODO(ager): Make this configurable through the embedding API?
+// Platform dependent default max Dart stack size. It can be overridden with
+// --max_stack_size, DartinoConfigureStackSizes or per spawned process.
 int MaxStackSizeInWords();
 
 inline OperatingSystem OS() {
@@ -164,6 +167,15 @@ struct HeapMemoryRange {
 // need 3.2% of the largest arena size for metadata.
 int GetHeapMemoryRanges(HeapMemoryRange* ranges, int number);
 
+#if defined(DARTINO_TARGET_OS_LINUX)
+// Sleeps until woken by FutexWake if the value at address is value.
+// Can return spuriously.
+void FutexWait(Atomic<int32>* address, int32 value);
+
+// Wakes up to count threads sleeping in FutexWait on address.
+void FutexWake(Atomic<int32>* address, int count);
+#endif
+
 }  // namespace Platform
 
 // Interface for manipulating virtual memory.
@@ -284,6 +296,89 @@ inline Mutex* Platform::CreateMutex() { return new Mutex(); }
 
 inline Monitor* Platform::CreateMonitor() { return new Monitor(); }
 
+#if defined(DARTINO_TARGET_OS_LINUX)
+
+// A counting semaphore on a futex. Up and Down only enter the kernel when a
+// thread has to sleep or be woken up.
+class Semaphore {
+ public:
+  explicit Semaphore(int count) : count_(count), waiters_(0) {}
+
+  void Down() {
+    while (true) {
+      int32 count = count_;
+      if (count > 0) {
+        if (count_.compare_exchange_weak(count, count - 1)) return;
+        continue;
+      }
+      ++waiters_;
+      Platform::FutexWait(&count_, 0);
+      --waiters_;
+    }
+  }
+
+  void Up() {
+    ++count_;
+    if (waiters_ > 0) Platform::FutexWake(&count_, 1);
+  }
+
+ private:
+  Atomic<int32> count_;
+  Atomic<int32> waiters_;
+};
+
+// An event count lets a thread sleep until a condition that is not protected
+// by a lock might have become true, without losing wakeups:
+//
+//   while (!condition) {
+//     int32 key = event_count->PrepareWait();
+//     if (condition) {
+//       event_count->CancelWait();
+//       break;
+//     }
+//     event_count->Wait(key);
+//   }
+//
+// Threads that make the condition true call NotifyOne or NotifyAll after
+// doing so. Wait can return without a notification, so the condition must be
+// checked again.
+//
+// This implementation uses a futex. Notifying an event count without waiters
+// does not enter the kernel, and NotifyOne wakes up a single waiter.
+class EventCount {
+ public:
+  EventCount() : epoch_(0), waiters_(0) {}
+
+  int32 PrepareWait() {
+    ++waiters_;
+    return epoch_;
+  }
+
+  void CancelWait() { --waiters_; }
+
+  void Wait(int32 key) {
+    Platform::FutexWait(&epoch_, key);
+    --waiters_;
+  }
+
+  void NotifyOne() { Notify(1); }
+  void NotifyAll() { Notify(INT_MAX); }
+
+ private:
+  void Notify(int count) {
+    // The read-modify-write orders the update of the condition by the caller
+    // before the check for waiters.
+    if (waiters_.fetch_add(0) == 0) return;
+    ++epoch_;
+    Platform::FutexWake(&epoch_, count);
+  }
+
+  Atomic<int32> epoch_;
+  Atomic<int32> waiters_;
+};
+
+#else  // defined(DARTINO_TARGET_OS_LINUX)
+
 // TODO(kustermann): We should use native sempahores instead of basing them on
 // monitors.
 class Semaphore {
@@ -316,6 +411,44 @@ class Semaphore {
   int count_;
 };
 
+// An event count on a monitor. See the Linux version for how to use it.
+class EventCount {
+ public:
+  EventCount() : monitor_(Platform::CreateMonitor()), epoch_(0) {}
+
+  ~EventCount() { delete monitor_; }
+
+  int32 PrepareWait() {
+    ScopedMonitorLock locker(monitor_);
+    return epoch_;
+  }
+
+  void CancelWait() {}
+
+  void Wait(int32 key) {
+    ScopedMonitorLock locker(monitor_);
+    while (epoch_ == key) monitor_->Wait();
+  }
+
+  void NotifyOne() {
+    ScopedMonitorLock locker(monitor_);
+    epoch_++;
+    monitor_->Notify();
+  }
+
+  void NotifyAll() {
+    ScopedMonitorLock locker(monitor_);
+    epoch_++;
+    monitor_->NotifyAll();
+  }
+
+ private:
+  Monitor* monitor_;
+  int32 epoch_;
+};
+
+#endif  // defined(DARTINO_TARGET_OS_LINUX)
+
 }  // namespace dartino
 
 #endif  // SRC_SHARED_PLATFORM_H_
@@ -5,7 +5,9 @@
 #if defined(DARTINO_TARGET_OS_LINUX)
 
 #include <errno.h>
+#include <linux/futex.h>
 #include <stdlib.h>
+#include <sys/syscall.h>
 #include <unistd.h>
 #include <time.h>
 
@@ -33,6 +35,16 @@ int Platform::GetLocalTimeZoneOffset() {
   return static_cast<int>(-timezone);
 }
 
+void Platform::FutexWait(Atomic<int32>* address, int32 value) {
+  syscall(SYS_futex, reinterpret_cast<int32*>(address), FUTEX_WAIT_PRIVATE,
+          value, NULL, NULL, 0);
+}
+
+void Platform::FutexWake(Atomic<int32>* address, int count) {
+  syscall(SYS_futex, reinterpret_cast<int32*>(address), FUTEX_WAKE_PRIVATE,
+          count, NULL, NULL, 0);
+}
+
 }  // namespace dartino
 
 #endif  // defined(DARTINO_TARGET_OS_LINUX)
@@ -38,6 +38,8 @@
         'atomic.h',
         'bytecodes.cc',
         'bytecodes.h',
+        'compression.cc',
+        'compression.h',
         'connection.cc',
         'connection.h',
         'socket_connection.cc',
@@ -99,6 +101,7 @@
       ],
       'sources': [
         'assert_test.cc',
+        'compression_test.cc',
         'flags_test.cc',
         'globals_test.cc',
         'random_test.cc',
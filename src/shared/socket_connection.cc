@@ -26,7 +26,7 @@ SocketConnection::~SocketConnection() {
   delete socket_;
 }
 
-Connection::Opcode SocketConnection::Receive() {
+Connection::Opcode SocketConnection::ReceiveMessage() {
   incoming_.ClearBuffer();
   uint8* bytes = socket_->Read(5);
   if (bytes == NULL) return kConnectionError;
@@ -41,19 +41,10 @@ Connection::Opcode SocketConnection::Receive() {
   return opcode;
 }
 
-void SocketConnection::Send(Opcode opcode, const WriteBuffer& buffer) {
-  ScopedLock scoped_lock(send_mutex_);
-  uint8 header[5];
-  Utils::WriteInt32(header, buffer.offset());
-  header[4] = opcode;
-  socket_->Write(header, 5);
-  if (buffer.offset() != 0) {
-    socket_->Write(buffer.GetBuffer(), buffer.offset());
-  }
+void SocketConnection::SendBytes(const uint8* bytes, int length) {
+  socket_->Write(const_cast<uint8*>(bytes), length);
 }
 
-Connection::Connection() : send_mutex_(Platform::CreateMutex()) {}
-
 SocketConnection::SocketConnection(const char* host, int port, Socket* socket)
     : socket_(socket) {}
 
@@ -13,8 +13,10 @@ class SocketConnection : public Connection {
  public:
   static SocketConnection* Connect(const char* host, int port);
   ~SocketConnection();
-  void Send(Opcode opcode, const WriteBuffer& buffer);
-  Connection::Opcode Receive();
+
+ protected:
+  void SendBytes(const uint8* bytes, int length);
+  Connection::Opcode ReceiveMessage();
 
  private:
   Socket* socket_;
@@ -18,29 +18,38 @@ Atomic<bool> Print::standard_output_enabled_(true);
 #ifdef DARTINO_ENABLE_PRINT_INTERCEPTORS
 Mutex* Print::mutex_ = Platform::CreateMutex();
 PrintInterceptor* Print::interceptor_ = NULL;
+
+static const int kMessageBufferSize = 256;
 #endif
 
 void Print::Out(const char* format, ...) {
 #ifdef DARTINO_ENABLE_PRINT_INTERCEPTORS
+  // Most messages fit in the stack buffer and need no allocation.
+  char buffer[kMessageBufferSize];
+  char* message = buffer;
   va_list args;
   va_start(args, format);
-  int size = vsnprintf(NULL, 0, format, args);
-  va_end(args);
-  char* message = reinterpret_cast<char*>(malloc(size + 1));
-  va_start(args, format);
-  int printed = vsnprintf(message, size + 1, format, args);
-  ASSERT(printed == size);
+  int size = vsnprintf(buffer, kMessageBufferSize, format, args);
   va_end(args);
+  if (size >= kMessageBufferSize) {
+    message = reinterpret_cast<char*>(malloc(size + 1));
+    va_start(args, format);
+    int printed = vsnprintf(message, size + 1, format, args);
+    ASSERT(printed == size);
+    va_end(args);
+  }
   if (standard_output_enabled_) {
     fputs(message, stdout);
     fflush(stdout);
   }
-  ScopedLock scope(mutex_);
-  for (PrintInterceptor* interceptor = interceptor_; interceptor != NULL;
-       interceptor = interceptor->next_) {
-    interceptor->Out(message);
+  {
+    ScopedLock scope(mutex_);
+    for (PrintInterceptor* interceptor = interceptor_; interceptor != NULL;
+         interceptor = interceptor->next_) {
+      interceptor->Out(message);
+    }
   }
-  free(message);
+  if (message != buffer) free(message);
 #else
   if (standard_output_enabled_) {
     va_list args;
@@ -53,25 +62,32 @@ void Print::Out(const char* format, ...) {
 
 void Print::Error(const char* format, ...) {
 #ifdef DARTINO_ENABLE_PRINT_INTERCEPTORS
+  // Most messages fit in the stack buffer and need no allocation.
+  char buffer[kMessageBufferSize];
+  char* message = buffer;
   va_list args;
   va_start(args, format);
-  int size = vsnprintf(NULL, 0, format, args);
-  va_end(args);
-  char* message = reinterpret_cast<char*>(malloc(size + 1));
-  va_start(args, format);
-  int printed = vsnprintf(message, size + 1, format, args);
-  ASSERT(printed == size);
+  int size = vsnprintf(buffer, kMessageBufferSize, format, args);
   va_end(args);
+  if (size >= kMessageBufferSize) {
+    message = reinterpret_cast<char*>(malloc(size + 1));
+    va_start(args, format);
+    int printed = vsnprintf(message, size + 1, format, args);
+    ASSERT(printed == size);
+    va_end(args);
+  }
   if (standard_output_enabled_) {
     fputs(message, stderr);
     fflush(stderr);
   }
-  ScopedLock scope(mutex_);
-  for (PrintInterceptor* interceptor = interceptor_; interceptor != NULL;
-       interceptor = interceptor->next_) {
-    interceptor->Error(message);
+  {
+    ScopedLock scope(mutex_);
+    for (PrintInterceptor* interceptor = interceptor_; interceptor != NULL;
+         interceptor = interceptor->next_) {
+      interceptor->Error(message);
+    }
   }
-  free(message);
+  if (message != buffer) free(message);
 #else
   if (standard_output_enabled_) {
     va_list args;
@@ -12,43 +12,70 @@
 
 namespace dartino {
 
-DriverConnection::DriverConnection(Socket* socket) : socket_(socket) {}
+DriverConnection::DriverConnection(Socket* socket)
+    : socket_(socket),
+      input_(static_cast<uint8*>(malloc(kInitialInputCapacity))),
+      input_capacity_(kInitialInputCapacity),
+      input_start_(0),
+      input_end_(0) {}
 
-DriverConnection::~DriverConnection() { delete socket_; }
+DriverConnection::~DriverConnection() {
+  delete socket_;
+  free(input_);
+}
 
-DriverConnection::Command DriverConnection::Receive() {
-  incoming_.ClearBuffer();
-  uint8 header[kHeaderSize];
-  size_t offset = 0;
+bool DriverConnection::HasBufferedCommand() const {
+  int available = input_end_ - input_start_;
+  if (available < static_cast<int>(kHeaderSize)) return false;
+  int length = Utils::ReadInt32(input_ + input_start_);
+  return available - static_cast<int>(kHeaderSize) >= length;
+}
+
+bool DriverConnection::Fill(int bytes, Command* error) {
+  if (input_end_ - input_start_ >= bytes) return true;
+  // Move the unparsed bytes to the front and grow the buffer if needed. The
+  // previous command has been consumed, so nothing points into [input_].
+  memmove(input_, input_ + input_start_, input_end_ - input_start_);
+  input_end_ -= input_start_;
+  input_start_ = 0;
+  if (bytes > input_capacity_) {
+    input_capacity_ = Utils::Maximum(bytes, input_capacity_ * 2);
+    input_ = static_cast<uint8*>(realloc(input_, input_capacity_));
+  }
   int fd = socket_->FileDescriptor();
-  while (offset < sizeof(header)) {
-    int bytes =
-        TEMP_FAILURE_RETRY(read(fd, header + offset, sizeof(header) - offset));
-    if (bytes == 0) {
-      return kDriverConnectionClosed;
-    } else if (bytes < 0) {
-      return kDriverConnectionError;
+  while (input_end_ < bytes) {
+    int read_bytes = TEMP_FAILURE_RETRY(
+        read(fd, input_ + input_end_, input_capacity_ - input_end_));
+    if (read_bytes <= 0) {
+      *error = (read_bytes == 0)
+          ? kDriverConnectionClosed : kDriverConnectionError;
+      return false;
     }
-    offset += bytes;
-  }
-  int buffer_length = Utils::ReadInt32(header);
-  Command command = static_cast<Command>(header[4]);
-  if (buffer_length > 0) {
-    uint8* buffer = socket_->Read(buffer_length);
-    incoming_.SetBuffer(buffer, buffer_length);
-    if (buffer == NULL) return kDriverConnectionError;
+    input_end_ += read_bytes;
   }
+  return true;
+}
+
+DriverConnection::Command DriverConnection::Receive() {
+  incoming_.ClearBuffer();
+  Command error;
+  if (!Fill(kHeaderSize, &error)) return error;
+  int buffer_length = Utils::ReadInt32(input_ + input_start_);
+  Command command = static_cast<Command>(input_[input_start_ + 4]);
+  if (!Fill(kHeaderSize + buffer_length, &error)) return error;
+  incoming_.SetBorrowedBuffer(input_ + input_start_ + kHeaderSize,
+                              buffer_length);
+  input_start_ += kHeaderSize + buffer_length;
   return command;
 }
 
 void DriverConnection::Send(Command command, const WriteBuffer& buffer) {
-  uint8 header[5];
-  Utils::WriteInt32(header, buffer.offset());
-  header[4] = command;
-  socket_->Write(header, 5);
-  if (buffer.offset() != 0) {
-    socket_->Write(buffer.GetBuffer(), buffer.offset());
-  }
+  // Write the header and the payload at once.
+  WriteBuffer message;
+  message.WriteInt(buffer.offset());
+  message.WriteByte(command);
+  message.WriteRawBytes(buffer.GetBuffer(), buffer.offset());
+  socket_->Write(message.GetBuffer(), message.offset());
 }
 
 }  // namespace dartino
@@ -31,6 +31,8 @@ class DriverConnection {
 
     kDriverConnectionError,   // Error in connection.
     kDriverConnectionClosed,  // Connection closed.
+
+    kTiming,  // Time spent on the request in the persistent process.
   };
 
   // Four bytes package length and one byte Command code.
@@ -45,13 +47,34 @@ class DriverConnection {
   double ReadDouble() { return incoming_.ReadDouble(); }
   bool ReadBoolean() { return incoming_.ReadBoolean(); }
   uint8* ReadBytes(int* length) { return incoming_.ReadBytes(length); }
+  // Returns a pointer to the next [length] bytes of the current command. It
+  // is valid until the next call to [Receive].
+  uint8* ReadView(int length) { return incoming_.ReadView(length); }
 
   void Send(Command command, const WriteBuffer& buffer);
   Command Receive();
 
+  // Returns true if a complete command has already been read from the
+  // socket, so [Receive] will not block.
+  bool HasBufferedCommand() const;
+
  private:
+  static const int kInitialInputCapacity = 64 * KB;
+
+  // Reads from the socket until at least [bytes] bytes are buffered. On
+  // failure returns false and sets [error] to kDriverConnectionClosed or
+  // kDriverConnectionError.
+  bool Fill(int bytes, Command* error);
+
   Socket* socket_;
   ReadBuffer incoming_;
+
+  // Commands are read from the socket in large chunks and parsed from
+  // [input_]. The unparsed bytes are [input_start_, input_end_).
+  uint8* input_;
+  int input_capacity_;
+  int input_start_;
+  int input_end_;
 };
 
 }  // namespace dartino
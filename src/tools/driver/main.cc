@@ -76,6 +76,10 @@ static int dartino_config_fd;
 
 static const char dart_vm_env_name[] = "DART_VM";
 
+// If set, the time the persistent process spent on the request is printed on
+// stderr.
+static const char report_timing_env_name[] = "DARTINO_REPORT_TIMING";
+
 static const char interactive_token[] = "interactive";
 
 static const char detached_token[] = "detached";
@@ -86,6 +90,15 @@ static int daemon_stderr = -1;
 
 static pid_t daemon_pid = -1;
 
+// The time the persistent process spent on the request or -1.
+static int64 daemon_microseconds = -1;
+
+// Output from the persistent process is collected here and written when no
+// more commands are buffered, so bursts of small chunks cost one write.
+static WriteBuffer pending_output;
+static int pending_output_fd = -1;
+static const int kMaxPendingOutput = 64 * KB;
+
 static void WriteFully(int fd, uint8* data, ssize_t length);
 
 void Die(const char* format, ...) {
@@ -743,6 +756,22 @@ static int CommandFileDescriptor(DriverConnection::Command command) {
   }
 }
 
+static void FlushOutput() {
+  if (pending_output.offset() == 0) return;
+  WriteFully(pending_output_fd, pending_output.GetBuffer(),
+             pending_output.offset());
+  pending_output.Rewind();
+}
+
+static void BufferOutput(int fd, uint8* bytes, int size) {
+  if (fd != pending_output_fd ||
+      pending_output.offset() + size > kMaxPendingOutput) {
+    FlushOutput();
+    pending_output_fd = fd;
+  }
+  pending_output.WriteRawBytes(bytes, size);
+}
+
 static DriverConnection::Command HandleCommand(DriverConnection* connection) {
   DriverConnection::Command command = connection->Receive();
   switch (command) {
@@ -752,13 +781,16 @@ static DriverConnection::Command HandleCommand(DriverConnection* connection) {
 
     case DriverConnection::kStdout:
     case DriverConnection::kStderr: {
-      int size = 0;
-      uint8* bytes = connection->ReadBytes(&size);
-      WriteFully(CommandFileDescriptor(command), bytes, size);
-      free(bytes);
+      int size = connection->ReadInt();
+      BufferOutput(CommandFileDescriptor(command),
+                   connection->ReadView(size), size);
       return command;
     }
 
+    case DriverConnection::kTiming:
+      daemon_microseconds = connection->ReadInt64();
+      return command;
+
     case DriverConnection::kDriverConnectionError:
     case DriverConnection::kDriverConnectionClosed:
       return command;
@@ -995,15 +1027,20 @@ static int Main(int argc, char** argv) {
       }
       if (control_socket != NULL &&
           FD_ISSET(control_socket->FileDescriptor(), &readfds)) {
-        DriverConnection::Command command = HandleCommand(connection);
-        if (command == DriverConnection::kDriverConnectionError) {
-          Die("%s: lost connection to persistent process: %s", program_name,
-              strerror(errno));
-        } else if (command == DriverConnection::kDriverConnectionClosed) {
-          // Connection was closed.
-          delete control_socket;
-          control_socket = NULL;
-        }
+        // Handle all the commands that arrived with the same read.
+        do {
+          DriverConnection::Command command = HandleCommand(connection);
+          if (command == DriverConnection::kDriverConnectionError) {
+            FlushOutput();
+            Die("%s: lost connection to persistent process: %s",
+                program_name, strerror(errno));
+          } else if (command == DriverConnection::kDriverConnectionClosed) {
+            // Connection was closed.
+            delete control_socket;
+            control_socket = NULL;
+          }
+        } while (control_socket != NULL && connection->HasBufferedCommand());
+        FlushOutput();
       }
       if (control_socket == NULL && daemon_stderr == -1) break;
     }
@@ -1019,6 +1056,11 @@ static int Main(int argc, char** argv) {
     WaitForDaemon(daemon_pid);
   }
 
+  if (daemon_microseconds >= 0 && getenv(report_timing_env_name) != NULL) {
+    fprintf(stderr, "%s: persistent process took %.3f ms\n", program_name,
+            daemon_microseconds / 1000.0);
+  }
+
   Exit(exit_code);
   return exit_code;
 }
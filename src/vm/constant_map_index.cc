@@ -0,0 +1,73 @@
+// Copyright (c) 2016, the Dartino project authors. Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE.md file.
+
+#include "src/vm/constant_map_index.h"
+
+#include "src/shared/utils.h"
+#include "src/vm/object.h"
+
+namespace dartino {
+
+static bool IsIndexableKey(Object* key) {
+  if (key->IsSmi()) {
+    return Smi::IsValidAsPortable(Smi::cast(key)->value());
+  }
+  return key->IsOneByteString();
+}
+
+// Smi keys are often dense ranges, so their hashes are scrambled to avoid
+// long runs of occupied slots. Only portable smis are hashed, so the result
+// does not depend on the word size.
+static uint32 HashOf(Object* key) {
+  if (key->IsSmi()) {
+    return static_cast<uint32>(Smi::cast(key)->value()) * 2654435761u;
+  }
+  return static_cast<uint32>(OneByteString::cast(key)->Hash());
+}
+
+static bool KeyEquals(Object* key, Object* other) {
+  if (key == other) return true;
+  if (!key->IsOneByteString() || !other->IsOneByteString()) return false;
+  return OneByteString::cast(key)->Equals(OneByteString::cast(other));
+}
+
+int ConstantMapIndex::IndexSize(Array* keys) {
+  int length = keys->length();
+  if (length < kMinimumKeys) return 0;
+  for (int i = 0; i < length; i++) {
+    if (!IsIndexableKey(keys->get(i))) return 0;
+  }
+  // Keep the index at most half full.
+  return Utils::RoundUpToPowerOfTwo(length * 2);
+}
+
+void ConstantMapIndex::Fill(Array* keys, Array* index) {
+  ASSERT(Utils::IsPowerOfTwo(index->length()));
+  uint32 mask = index->length() - 1;
+  for (int i = 0; i < keys->length(); i++) {
+    uint32 slot = HashOf(keys->get(i)) & mask;
+    while (index->get(slot)->IsSmi()) slot = (slot + 1) & mask;
+    index->set(slot, Smi::FromWord(i));
+  }
+}
+
+int ConstantMapIndex::Lookup(Array* keys, Array* index, Object* key) {
+  if (key->IsSmi()) {
+    // Non-portable smis are never keys of an index.
+    if (!Smi::IsValidAsPortable(Smi::cast(key)->value())) return -1;
+  } else if (!key->IsOneByteString()) {
+    // Doubles may equal integer keys, and two-byte strings may equal
+    // one-byte keys, so they are compared in Dart.
+    return kUnsupportedKey;
+  }
+  uint32 mask = index->length() - 1;
+  for (uint32 slot = HashOf(key) & mask;; slot = (slot + 1) & mask) {
+    Object* entry = index->get(slot);
+    if (!entry->IsSmi()) return -1;
+    int position = Smi::cast(entry)->value();
+    if (KeyEquals(keys->get(position), key)) return position;
+  }
+}
+
+}  // namespace dartino
@@ -0,0 +1,44 @@
+// Copyright (c) 2016, the Dartino project authors. Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE.md file.
+
+#ifndef SRC_VM_CONSTANT_MAP_INDEX_H_
+#define SRC_VM_CONSTANT_MAP_INDEX_H_
+
+#include "src/shared/globals.h"
+
+namespace dartino {
+
+class Array;
+class Object;
+
+// A hash index over the keys of a compile-time constant map. The index is an
+// array of slots holding the positions of the keys as smis, or null for empty
+// slots, probed linearly from the hash of the key. It is only built for maps
+// with enough keys, all of which are small integers or one-byte strings, so
+// that the hashes can be computed in the VM and are the same on all
+// platforms. The index lives in program space next to the map and ends up in
+// snapshots with it.
+class ConstantMapIndex {
+ public:
+  // Maps with fewer keys are scanned linearly.
+  static const int kMinimumKeys = 8;
+
+  // Returned by Lookup if the key cannot be looked up in the index.
+  static const int kUnsupportedKey = -2;
+
+  // Returns the number of slots of the index for [keys], or 0 if [keys]
+  // should not be indexed.
+  static int IndexSize(Array* keys);
+
+  // Adds the positions of all [keys] to the empty [index].
+  static void Fill(Array* keys, Array* index);
+
+  // Returns the position of [key] in [keys], -1 if it is not there, or
+  // kUnsupportedKey if [key] must be compared in Dart.
+  static int Lookup(Array* keys, Array* index, Object* key);
+};
+
+}  // namespace dartino
+
+#endif  // SRC_VM_CONSTANT_MAP_INDEX_H_
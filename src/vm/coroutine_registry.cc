@@ -0,0 +1,83 @@
+// Copyright (c) 2016, the Dartino project authors. Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE.md file.
+
+#include "src/vm/coroutine_registry.h"
+
+#include <stdlib.h>
+
+#include "src/vm/object.h"
+#include "src/vm/object_memory.h"
+
+namespace dartino {
+
+CoroutineRegistry::CoroutineRegistry()
+    : coroutines_(NULL), capacity_(0), size_(0), removed_(0) {}
+
+CoroutineRegistry::~CoroutineRegistry() { free(coroutines_); }
+
+void CoroutineRegistry::Add(Coroutine* coroutine) {
+  if (size_ == capacity_) {
+    if (2 * removed_ >= size_ && removed_ > 0) {
+      Compact();
+    } else {
+      Resize(capacity_ == 0 ? kInitialCapacity : capacity_ * 2);
+    }
+  }
+  indices_[coroutine] = size_;
+  coroutines_[size_++] = coroutine;
+}
+
+void CoroutineRegistry::Remove(Coroutine* coroutine) {
+  auto it = indices_.Find(coroutine);
+  if (it == indices_.End()) return;
+  coroutines_[it->second] = NULL;
+  indices_.Erase(it);
+  removed_++;
+  if (2 * removed_ > size_) Compact();
+}
+
+void CoroutineRegistry::CleanupAfterGC(Space* space) {
+  // Only the pointers are updated here. The coroutines may not have been
+  // moved to their new location yet, so their fields cannot be read.
+  for (word i = 0; i < size_; i++) {
+    Coroutine* coroutine = coroutines_[i];
+    if (coroutine == NULL) continue;
+    if (!space->Includes(coroutine->address())) continue;
+    if (space->IsAlive(coroutine)) {
+      coroutines_[i] =
+          reinterpret_cast<Coroutine*>(space->NewLocation(coroutine));
+    } else {
+      coroutines_[i] = NULL;
+      removed_++;
+    }
+  }
+  // The index is keyed by address, so it is rebuilt even if no coroutine
+  // died.
+  Compact();
+  // Give back the memory if most of the coroutines died.
+  if (capacity_ > kInitialCapacity && 4 * size_ < capacity_) {
+    Resize(Utils::Maximum(kInitialCapacity, size_ * 2));
+  }
+}
+
+void CoroutineRegistry::Compact() {
+  indices_.Clear();
+  word live = 0;
+  for (word i = 0; i < size_; i++) {
+    Coroutine* coroutine = coroutines_[i];
+    if (coroutine == NULL) continue;
+    indices_[coroutine] = live;
+    coroutines_[live++] = coroutine;
+  }
+  size_ = live;
+  removed_ = 0;
+}
+
+void CoroutineRegistry::Resize(word capacity) {
+  capacity_ = capacity;
+  coroutines_ = reinterpret_cast<Coroutine**>(
+      realloc(coroutines_, capacity_ * sizeof(Coroutine*)));
+}
+
+}  // namespace dartino
@@ -0,0 +1,63 @@
+// Copyright (c) 2016, the Dartino project authors. Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE.md file.
+
+#ifndef SRC_VM_COROUTINE_REGISTRY_H_
+#define SRC_VM_COROUTINE_REGISTRY_H_
+
+#include "src/shared/globals.h"
+
+#include "src/vm/hash_map.h"
+
+namespace dartino {
+
+class Coroutine;
+class Space;
+
+// The coroutines created by a process, in order of creation. It lets the
+// debugger and samplers enumerate the stacks of a process without a GC.
+//
+// Coroutines are added when they get their stack and removed when their
+// fiber exits. The registry does not keep its coroutines alive: after each
+// collection of a space that may contain coroutines, CleanupAfterGC must be
+// called with that space to drop dead coroutines and update moved ones, the
+// same way ports are cleaned up. Coroutines that are done or were unwound
+// by a throw have no stack and should be skipped by users.
+//
+// Removing a coroutine finds its slot through an index and clears it, so
+// fibers can exit in any order in constant time. Cleared slots are
+// compacted away after GCs and when they make up half of the registry.
+class CoroutineRegistry {
+ public:
+  CoroutineRegistry();
+  ~CoroutineRegistry();
+
+  void Add(Coroutine* coroutine);
+  void Remove(Coroutine* coroutine);
+
+  void CleanupAfterGC(Space* space);
+
+  // The slots of removed coroutines are NULL until they are compacted.
+  word size() const { return size_; }
+  Coroutine* at(word index) const { return coroutines_[index]; }
+
+  // The number of coroutines in the registry.
+  word live() const { return size_ - removed_; }
+
+ private:
+  static const word kInitialCapacity = 4;
+
+  // Drops the cleared slots and rebuilds the index.
+  void Compact();
+  void Resize(word capacity);
+
+  Coroutine** coroutines_;
+  word capacity_;
+  word size_;
+  word removed_;
+  HashMap<Coroutine*, word> indices_;
+};
+
+}  // namespace dartino
+
+#endif  // SRC_VM_COROUTINE_REGISTRY_H_
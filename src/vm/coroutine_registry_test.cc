@@ -0,0 +1,80 @@
+// Copyright (c) 2016, the Dartino project authors. Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE.md file.
+
+#include "src/shared/assert.h"
+#include "src/shared/test_case.h"
+
+#include "src/vm/coroutine_registry.h"
+#include "src/vm/object.h"
+#include "src/vm/object_memory.h"
+
+namespace dartino {
+
+// The registry only reads the fields of coroutines in the space it cleans
+// up, so coroutines outside of it can be fake.
+static Coroutine* FakeCoroutine(uword* words, int index) {
+  return reinterpret_cast<Coroutine*>(HeapObject::FromAddress(
+      reinterpret_cast<uword>(&words[index * 4])));
+}
+
+TEST_CASE(CoroutineRegistryAddRemove) {
+  static const int kCount = 100;
+  static uword words[kCount * 4];
+  CoroutineRegistry registry;
+  for (int i = 0; i < kCount; i++) registry.Add(FakeCoroutine(words, i));
+  EXPECT_EQ(kCount, registry.live());
+
+  // Remove in creation order, like fibers that exit first in, first out.
+  for (int i = 0; i < kCount / 2; i++) registry.Remove(FakeCoroutine(words, i));
+  // Removing a coroutine twice or one that was never added does nothing.
+  registry.Remove(FakeCoroutine(words, 0));
+  EXPECT_EQ(kCount / 2, registry.live());
+
+  // The remaining coroutines keep their order.
+  int expected = kCount / 2;
+  for (word i = 0; i < registry.size(); i++) {
+    Coroutine* coroutine = registry.at(i);
+    if (coroutine == NULL) continue;
+    EXPECT(coroutine == FakeCoroutine(words, expected++));
+  }
+  EXPECT_EQ(kCount, expected);
+
+  for (int i = kCount - 1; i >= kCount / 2; i--) {
+    registry.Remove(FakeCoroutine(words, i));
+  }
+  EXPECT_EQ(0, registry.live());
+  registry.Add(FakeCoroutine(words, 0));
+  EXPECT_EQ(1, registry.live());
+}
+
+TEST_CASE(CoroutineRegistryCleanupAfterGC) {
+  static uword words[4 * 4];
+  SemiSpace space(Space::kCanResize, kUnknownSpacePage, 4 * KB);
+  HeapObject* dead = HeapObject::FromAddress(space.Allocate(Coroutine::kSize));
+  HeapObject* moved = HeapObject::FromAddress(space.Allocate(Coroutine::kSize));
+  Coroutine* outside = FakeCoroutine(words, 0);
+  Coroutine* new_location = FakeCoroutine(words, 1);
+  // An object is alive if it has been forwarded to its new location.
+  dead->set_class(reinterpret_cast<Class*>(dead));
+  moved->set_forwarding_address(new_location);
+
+  CoroutineRegistry registry;
+  registry.Add(reinterpret_cast<Coroutine*>(dead));
+  registry.Add(outside);
+  registry.Add(reinterpret_cast<Coroutine*>(moved));
+  registry.CleanupAfterGC(&space);
+
+  EXPECT_EQ(2, registry.live());
+  EXPECT_EQ(2, registry.size());
+  EXPECT(registry.at(0) == outside);
+  EXPECT(registry.at(1) == new_location);
+
+  // The index follows the moved coroutine.
+  registry.Remove(new_location);
+  EXPECT_EQ(1, registry.live());
+  registry.Remove(outside);
+  EXPECT_EQ(0, registry.live());
+}
+
+}  // namespace dartino
@@ -4,15 +4,20 @@
 
 #include "src/shared/dartino.h"
 
+#include "src/shared/flags.h"
 #include "src/shared/platform.h"
 
 #include "src/vm/event_handler.h"
 #include "src/vm/ffi.h"
+#include "src/vm/metrics.h"
 #include "src/vm/object_memory.h"
 #include "src/vm/object.h"
 #include "src/vm/preempter.h"
 #include "src/vm/scheduler.h"
+#include "src/vm/slab_allocator.h"
+#include "src/vm/spinlock.h"
 #include "src/vm/thread.h"
+#include "src/vm/timeline.h"
 
 namespace dartino {
 
@@ -25,19 +30,28 @@ void Dartino::Setup() {
 #endif
   Platform::Setup();
   Thread::Setup();
+  SlabAllocator::Setup();
+  Timeline::Setup();
   ObjectMemory::Setup();
   StaticClassStructures::Setup();
   ForeignFunctionInterface::Setup();
   EventHandler::Setup();
   Scheduler::Setup();
   Preempter::Setup();
+  if (Flags::metrics_port != 0) Metrics::StartServer(Flags::metrics_port);
 }
 
 void Dartino::TearDown() {
+  Metrics::StopServer();
   Preempter::TearDown();
-  Thread::TearDown();
   Scheduler::TearDown();
   EventHandler::TearDown();
+  if (Flags::print_lock_statistics) Spinlock::PrintStatistics();
+  // The worker and event handler threads record into the timeline and cache
+  // slab objects, so these are only torn down once they have been joined.
+  Timeline::TearDown();
+  SlabAllocator::TearDown();
+  Thread::TearDown();
   ForeignFunctionInterface::TearDown();
   StaticClassStructures::TearDown();
   ObjectMemory::TearDown();
@@ -11,9 +11,12 @@
 #include "src/shared/connection.h"
 #endif
 #include "src/shared/dartino.h"
+#include "src/shared/flags.h"
 #include "src/shared/list.h"
 
 #include "src/vm/ffi.h"
+#include "src/vm/log_writer.h"
+#include "src/vm/metrics.h"
 #include "src/vm/program.h"
 #include "src/vm/program_folder.h"
 #include "src/vm/program_info_block.h"
@@ -37,6 +40,21 @@ class PrintInterceptorImpl : public PrintInterceptor {
   void* data_;
 };
 
+class PrintFunctionLogSink : public LogSink {
+ public:
+  typedef PrintInterceptorImpl::PrintFunction PrintFunction;
+
+  PrintFunctionLogSink(PrintFunction fn, void* data) : fn_(fn), data_(data) {}
+
+  virtual void Write(bool is_error, const char* text, int length) {
+    fn_(text, is_error ? 3 : 2, data_);
+  }
+
+ private:
+  PrintFunction fn_;
+  void* data_;
+};
+
 static bool IsSnapshot(List<uint8> snapshot) {
   return snapshot.length() > 2 && snapshot[0] == 0xbe && snapshot[1] == 0xef;
 }
@@ -110,6 +128,24 @@ void DartinoSetup() { dartino::Dartino::Setup(); }
 
 void DartinoTearDown() { dartino::Dartino::TearDown(); }
 
+void DartinoConfigureScheduler(int worker_count, bool pin_workers) {
+  if (worker_count > 0) dartino::Flags::scheduler_threads = worker_count;
+  dartino::Flags::pin_scheduler_threads = pin_workers;
+}
+
+void DartinoConfigureMetricsServer(int port) {
+  dartino::Flags::metrics_port = port;
+}
+
+void DartinoConfigureStackSizes(int initial_size, int max_size) {
+  if (initial_size > 0) dartino::Flags::initial_stack_size = initial_size;
+  if (max_size > 0) dartino::Flags::max_stack_size = max_size;
+}
+
+int DartinoFormatMetrics(char* buffer, int length) {
+  return dartino::Metrics::Format(buffer, length);
+}
+
 int DartinoRunWithDebuggerConnection(
     DartinoProgram program,
     DartinoConnectionListenerCallback connection_listener_callback,
@@ -221,12 +257,24 @@ DartinoPrintInterceptor DartinoRegisterPrintInterceptor(
   return reinterpret_cast<void*>(impl);
 }
 
+DartinoPrintInterceptor DartinoRegisterBufferedPrintInterceptor(
+    PrintInterceptionFunction function, void* data, bool drop_when_full) {
+  dartino::LogWriter* writer = new dartino::LogWriter(
+      new dartino::PrintFunctionLogSink(function, data),
+      drop_when_full ? dartino::LogWriter::kDropWhenFull
+                     : dartino::LogWriter::kBlockWhenFull,
+      false);
+  dartino::PrintInterceptor* interceptor = writer;
+  dartino::Print::RegisterPrintInterceptor(interceptor);
+  return reinterpret_cast<void*>(interceptor);
+}
+
 void DartinoUnregisterPrintInterceptor(
     DartinoPrintInterceptor raw_interceptor) {
-  dartino::PrintInterceptorImpl* impl =
-      reinterpret_cast<dartino::PrintInterceptorImpl*>(raw_interceptor);
-  dartino::Print::UnregisterPrintInterceptor(impl);
-  delete impl;
+  dartino::PrintInterceptor* interceptor =
+      reinterpret_cast<dartino::PrintInterceptor*>(raw_interceptor);
+  dartino::Print::UnregisterPrintInterceptor(interceptor);
+  delete interceptor;
 }
 
 DartinoProgramGroup DartinoCreateProgramGroup(const char *name) {
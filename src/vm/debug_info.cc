@@ -7,6 +7,7 @@
 #include "src/vm/debug_info.h"
 
 #include "src/shared/bytecodes.h"
+#include "src/shared/platform.h"
 #include "src/vm/object.h"
 #include "src/vm/process.h"
 
@@ -23,7 +24,66 @@ Breakpoint::Breakpoint(Function* function, int bytecode_index, int id,
       id_(id),
       is_one_shot_(is_one_shot),
       coroutine_(coroutine),
-      stack_height_(stack_height) {}
+      stack_height_(stack_height),
+      ignore_count_(0),
+      is_logpoint_(false),
+      log_slot_(kNoLogSlot),
+      max_logs_per_second_(0),
+      hit_count_(0),
+      suppressed_count_(0),
+      window_start_(0),
+      logs_in_window_(0) {}
+
+bool BreakpointCondition::Holds(Object** sp, word height) const {
+  if (comparison_ == kAlways) return true;
+  // The slot is supplied by the debugger and may be beyond the stack.
+  if (slot_ < 0 || slot_ >= height) return false;
+  Object* object = *(sp + slot_);
+  if (!object->IsSmi()) return false;
+  int64 value = Smi::cast(object)->value();
+  switch (comparison_) {
+    case kEqual:
+      return value == value_;
+    case kNotEqual:
+      return value != value_;
+    case kLess:
+      return value < value_;
+    case kLessOrEqual:
+      return value <= value_;
+    case kGreater:
+      return value > value_;
+    case kGreaterOrEqual:
+      return value >= value_;
+    default:
+      UNREACHABLE();
+      return false;
+  }
+}
+
+Breakpoint::HitAction Breakpoint::Hit(Object** sp, word height) const {
+  if (!condition_.Holds(sp, height)) return kIgnoreHit;
+  if (++hit_count_ <= ignore_count_) return kIgnoreHit;
+  if (!is_logpoint_) return kBreakOnHit;
+  if (max_logs_per_second_ > 0) {
+    uint64 now = Platform::GetMicroseconds();
+    if (now - window_start_ >= 1000000) {
+      window_start_ = now;
+      logs_in_window_ = 0;
+    }
+    if (logs_in_window_ == max_logs_per_second_) {
+      suppressed_count_++;
+      return kIgnoreHit;
+    }
+    logs_in_window_++;
+  }
+  return kLogHit;
+}
+
+int Breakpoint::TakeSuppressedCount() const {
+  int result = suppressed_count_;
+  suppressed_count_ = 0;
+  return result;
+}
 
 void Breakpoint::VisitPointers(PointerVisitor* visitor) {
   if (coroutine_ != NULL) {
@@ -129,6 +189,21 @@ int ProgramDebugInfo::CreateBreakpoint(Function* function, int bytecode_index) {
   return breakpoint.id();
 }
 
+int ProgramDebugInfo::CreateConditionalBreakpoint(
+    Function* function, int bytecode_index,
+    const BreakpointCondition& condition, int ignore_count, bool is_logpoint,
+    int log_slot, int max_logs_per_second) {
+  uint8_t* bcp = function->bytecode_address_for(0) + bytecode_index;
+  const Breakpoint* existing = breakpoints_.Lookup(bcp);
+  if (existing != NULL) breakpoints_.Delete(existing->id());
+  Breakpoint breakpoint(
+      function, bytecode_index, NextBreakpointId(), false, NULL, 0);
+  breakpoint.SetCondition(condition, ignore_count);
+  if (is_logpoint) breakpoint.SetLogpoint(log_slot, max_logs_per_second);
+  breakpoints_.Insert({bcp, breakpoint});
+  return breakpoint.id();
+}
+
 int ProcessDebugInfo::CreateBreakpoint(
     Function* function,
     int bytecode_index,
@@ -181,8 +256,24 @@ void ProcessDebugInfo::ClearSteppingInterrupted() {
   is_stepping_ = false;
 }
 
+void ProgramDebugInfo::HitTracepoint(Process* process, uint8_t* bcp,
+                                     Object** sp) {
+  if (!tracepoints_.MayHaveProbeAt(bcp)) return;
+  const TracepointProbe* probe = tracepoints_.Lookup(bcp);
+  if (probe == NULL) return;
+  TraceStack* trace_stack = process->EnsureTraceStack();
+  Stack* stack = process->stack();
+  word height = stack->length() - (sp - stack->Pointer(0));
+  int64 now = Platform::GetMicroseconds();
+  if (probe->is_entry) {
+    trace_stack->Enter(probe->tracepoint->id(), height, now);
+  }
+  if (probe->is_exit) trace_stack->Exit(probe->tracepoint, height, now);
+}
+
 void ProgramDebugInfo::VisitProgramPointers(PointerVisitor* visitor) {
   breakpoints_.VisitProgramPointers(visitor);
+  tracepoints_.VisitProgramPointers(visitor);
 }
 
 void ProcessDebugInfo::VisitPointers(PointerVisitor* visitor) {
@@ -195,6 +286,7 @@ void ProcessDebugInfo::VisitProgramPointers(PointerVisitor* visitor) {
 
 void ProgramDebugInfo::UpdateBreakpoints() {
   breakpoints_.UpdateBreakpoints();
+  tracepoints_.UpdateProbes();
 }
 
 void ProcessDebugInfo::UpdateBreakpoints() {
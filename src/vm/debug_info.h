@@ -11,14 +11,59 @@
 
 #include "src/vm/hash_map.h"
 #include "src/vm/object.h"
+#include "src/vm/tracepoints.h"
 
 namespace dartino {
 
+// A predicate evaluated by the VM when a breakpoint is hit. It compares the
+// value [slot] words up the stack of the process with a small integer, so
+// that a breakpoint does not have to stop the program to be filtered.
+class BreakpointCondition {
+ public:
+  // Any change in [Comparison] must also be done in [BreakpointComparison]
+  // in pkg/dartino_compiler/lib/vm_commands.dart.
+  enum Comparison {
+    kAlways,
+    kEqual,
+    kNotEqual,
+    kLess,
+    kLessOrEqual,
+    kGreater,
+    kGreaterOrEqual,
+  };
+
+  BreakpointCondition() : comparison_(kAlways), slot_(0), value_(0) {}
+  BreakpointCondition(Comparison comparison, int slot, int64 value)
+      : comparison_(comparison), slot_(slot), value_(value) {}
+
+  static bool IsValidComparison(int comparison) {
+    return comparison >= kAlways && comparison <= kGreaterOrEqual;
+  }
+
+  // A condition on a value that is not a Smi never holds. Neither does a
+  // condition on a slot at or above [height], the number of words between
+  // [sp] and the end of the stack.
+  bool Holds(Object** sp, word height) const;
+
+ private:
+  Comparison comparison_;
+  int slot_;
+  int64 value_;
+};
+
 class Breakpoint {
  public:
   static const int kNoBreakpointId = -1;
+  static const int kNoLogSlot = -1;
   static Breakpoint kBreakOnAllBytecodes;
 
+  // What the interpreter should do when it reaches a breakpoint.
+  enum HitAction {
+    kIgnoreHit,
+    kBreakOnHit,
+    kLogHit,
+  };
+
   Breakpoint(Function* function, int bytecode_index, int id, bool is_one_shot,
              Coroutine* coroutine = NULL, word stack_height = 0);
 
@@ -32,6 +77,42 @@ class Breakpoint {
   }
   word stack_height() const { return stack_height_; }
 
+  // Only hits for which [condition] holds are counted. The first
+  // [ignore_count] of those are ignored.
+  void SetCondition(const BreakpointCondition& condition, int ignore_count) {
+    condition_ = condition;
+    ignore_count_ = ignore_count;
+  }
+
+  // Turns the breakpoint into a logpoint that reports hits to the session
+  // without pausing the process. If [log_slot] is not kNoLogSlot the value
+  // in that stack slot is reported as well. At most [max_logs_per_second]
+  // hits are reported each second if it is positive; the rest are counted
+  // as suppressed and reported with the next hit that is not.
+  void SetLogpoint(int log_slot, int max_logs_per_second) {
+    is_logpoint_ = true;
+    log_slot_ = log_slot;
+    max_logs_per_second_ = max_logs_per_second;
+  }
+
+  bool is_logpoint() const { return is_logpoint_; }
+  int log_slot() const { return log_slot_; }
+  int64 hit_count() const { return hit_count_; }
+
+  // Evaluates the condition and updates the counters. The counters of
+  // program breakpoints are shared by all processes and are not
+  // synchronized, so they are approximate if several processes hit the
+  // breakpoint at the same time.
+  HitAction Hit(Object** sp, word height) const;
+
+  // Returns the number of hits suppressed by the rate limit since the last
+  // call and resets it.
+  int TakeSuppressedCount() const;
+
+  // Counts hits that could not be reported as suppressed, so they are
+  // included in the suppressed count of the next reported hit.
+  void AddSuppressedCount(int count) const { suppressed_count_ += count; }
+
   // GC support for process GCs.
   void VisitPointers(PointerVisitor* visitor);
 
@@ -45,6 +126,18 @@ class Breakpoint {
   bool is_one_shot_;
   Coroutine* coroutine_;
   word stack_height_;
+
+  BreakpointCondition condition_;
+  int ignore_count_;
+  bool is_logpoint_;
+  int log_slot_;
+  int max_logs_per_second_;
+
+  // Statistics updated by the interpreter through const pointers.
+  mutable int64 hit_count_;
+  mutable int suppressed_count_;
+  mutable uint64 window_start_;
+  mutable int logs_in_window_;
 };
 
 class Breakpoints {
@@ -79,6 +172,14 @@ class ProgramDebugInfo {
 
   int CreateBreakpoint(Function* function, int bytecode_index);
 
+  // Creates a breakpoint that is filtered by [condition] and
+  // [ignore_count], and that is a logpoint if [is_logpoint] is set. An
+  // existing breakpoint at the same bytecode is replaced.
+  int CreateConditionalBreakpoint(Function* function, int bytecode_index,
+                                  const BreakpointCondition& condition,
+                                  int ignore_count, bool is_logpoint,
+                                  int log_slot, int max_logs_per_second);
+
   bool DeleteBreakpoint(int id);
 
   const Breakpoint* GetBreakpointAt(uint8_t* bcp) const;
@@ -89,6 +190,13 @@ class ProgramDebugInfo {
 
   const Breakpoints* breakpoints() const { return &breakpoints_; }
 
+  Tracepoints* tracepoints() { return &tracepoints_; }
+  const Tracepoints* tracepoints() const { return &tracepoints_; }
+
+  // Records the passing of [process] through a tracepoint probe at [bcp],
+  // if there is one.
+  void HitTracepoint(Process* process, uint8_t* bcp, Object** sp);
+
   // GC support for program GCs.
   void VisitProgramPointers(PointerVisitor* visitor);
   void UpdateBreakpoints();
@@ -99,6 +207,7 @@ class ProgramDebugInfo {
   int next_process_id_;
   int next_breakpoint_id_;
   Breakpoints breakpoints_;
+  Tracepoints tracepoints_;
 };
 
 class ProcessDebugInfo {
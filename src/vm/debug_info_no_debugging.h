@@ -13,11 +13,51 @@
 
 namespace dartino {
 
-class Breakpoint;
 class Coroutine;
 class Function;
 class Object;
 class PointerVisitor;
+class Process;
+
+class Breakpoint {
+ public:
+  static const int kNoLogSlot = -1;
+
+  enum HitAction {
+    kIgnoreHit,
+    kBreakOnHit,
+    kLogHit,
+  };
+
+  int id() const {
+    UNIMPLEMENTED();
+    return -1;
+  }
+
+  int log_slot() const {
+    UNIMPLEMENTED();
+    return kNoLogSlot;
+  }
+
+  int64 hit_count() const {
+    UNIMPLEMENTED();
+    return 0;
+  }
+
+  HitAction Hit(Object** sp, word height) const {
+    UNIMPLEMENTED();
+    return kIgnoreHit;
+  }
+
+  int TakeSuppressedCount() const {
+    UNIMPLEMENTED();
+    return 0;
+  }
+
+  void AddSuppressedCount(int count) const { UNIMPLEMENTED(); }
+};
+
+class TraceStack {};
 
 class ProgramDebugInfo {
  public:
@@ -26,6 +66,10 @@ class ProgramDebugInfo {
     return NULL;
   }
 
+  void HitTracepoint(Process* process, uint8* bcp, Object** sp) {
+    UNIMPLEMENTED();
+  }
+
   void VisitProgramPointers(PointerVisitor* visitor) { UNIMPLEMENTED(); }
   void UpdateBreakpoints() { UNIMPLEMENTED(); }
 };
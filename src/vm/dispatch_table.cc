@@ -14,39 +14,60 @@ namespace dartino {
 void DispatchTable::ResetBreakpoints(
     const ProgramDebugInfo* program_info,
     const ProcessDebugInfo* process_info) {
-  // If stepping, we don't need to clear any previous state.
+  OpcodeSet wanted;
   if (process_info != NULL && process_info->is_stepping()) {
-    SetStepping();
-    return;
+    wanted.AddAll();
+  } else {
+    if (program_info != NULL) {
+      wanted.AddBreakpoints(program_info->breakpoints());
+      wanted.AddTracepoints(program_info->tracepoints());
+    }
+    if (process_info != NULL) {
+      wanted.AddBreakpoints(process_info->breakpoints());
+    }
   }
-  // Otherwise, clear and restore global and local breaks in the table.
-  ClearAllBreakpoints();
-  if (program_info != NULL) SetBreakpoints(program_info->breakpoints());
-  if (process_info != NULL) SetBreakpoints(process_info->breakpoints());
+  if (wanted.Equals(applied_)) return;
+
+  for (int i = 0; i < Bytecode::kNumBytecodes; i++) {
+    Opcode opcode = static_cast<Opcode>(i);
+    bool is_wanted = wanted.Contains(opcode);
+    if (is_wanted == applied_.Contains(opcode)) continue;
+    if (is_wanted) {
+      SetBytecodeBreak(opcode);
+    } else {
+      ClearBytecodeBreak(opcode);
+    }
+  }
+  applied_ = wanted;
 }
 
-void DispatchTable::SetBreakpoints(const Breakpoints* breakpoints) {
-  if (state_ == kStepping || breakpoints->IsEmpty()) return;
-  state_ = kDirty;
+void DispatchTable::OpcodeSet::Clear() {
+  for (int i = 0; i < kWords; i++) bits_[i] = 0;
+}
+
+void DispatchTable::OpcodeSet::AddAll() {
+  for (int i = 0; i < Bytecode::kNumBytecodes; i++) {
+    Add(static_cast<Opcode>(i));
+  }
+}
+
+void DispatchTable::OpcodeSet::AddBreakpoints(const Breakpoints* breakpoints) {
   for (auto& pair : breakpoints->map()) {
-    SetBytecodeBreak(static_cast<Opcode>(*pair.first));
+    Add(static_cast<Opcode>(*pair.first));
   }
 }
 
-void DispatchTable::SetStepping() {
-  if (state_ == kStepping) return;
-  state_ = kStepping;
-  for (int i = 0; i < Bytecode::kNumBytecodes; i++) {
-    SetBytecodeBreak(static_cast<Opcode>(i));
+void DispatchTable::OpcodeSet::AddTracepoints(const Tracepoints* tracepoints) {
+  for (auto& pair : tracepoints->probes()) {
+    Add(static_cast<Opcode>(*pair.first));
   }
 }
 
-void DispatchTable::ClearAllBreakpoints() {
-  if (state_ == kClean) return;
-  state_ = kClean;
-  for (int i = 0; i < Bytecode::kNumBytecodes; i++) {
-    ClearBytecodeBreak(static_cast<Opcode>(i));
+bool DispatchTable::OpcodeSet::Equals(const OpcodeSet& other) const {
+  for (int i = 0; i < kWords; i++) {
+    if (bits_[i] != other.bits_[i]) return false;
   }
+  return true;
 }
 
 }  // namespace dartino
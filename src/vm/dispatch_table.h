@@ -9,32 +9,58 @@
 #include "src/vm/dispatch_table_no_debugging.h"
 #else  // DARTINO_ENABLE_DEBUGGING
 
+#include "src/shared/bytecodes.h"
+#include "src/shared/globals.h"
+
 namespace dartino {
 
 class Breakpoints;
 class ProcessDebugInfo;
 class ProgramDebugInfo;
+class Tracepoints;
 
 class DispatchTable {
  public:
-  DispatchTable() : state_(kClean) {}
+  DispatchTable() {}
 
+  // Makes the interpreter break on the bytecodes that have breakpoints or
+  // tracepoint probes for the given program and process, or on all
+  // bytecodes if the process is stepping. Only the entries that differ from
+  // the current state of the table are patched, so switching between
+  // processes with the same breakpoints costs no more than a few word
+  // comparisons.
   void ResetBreakpoints(
       const ProgramDebugInfo* program_info,
       const ProcessDebugInfo* process_info);
 
  private:
-  enum State {
-    kClean,
-    kDirty,
-    kStepping
-  };
+  // A set of opcodes.
+  class OpcodeSet {
+   public:
+    OpcodeSet() { Clear(); }
+
+    void Clear();
+    void AddAll();
+    void Add(Opcode opcode) {
+      bits_[opcode / kBitsPerWord] |= static_cast<uword>(1)
+                                      << (opcode % kBitsPerWord);
+    }
+    void AddBreakpoints(const Breakpoints* breakpoints);
+    void AddTracepoints(const Tracepoints* tracepoints);
+    bool Contains(Opcode opcode) const {
+      return (bits_[opcode / kBitsPerWord] >> (opcode % kBitsPerWord)) & 1;
+    }
 
-  void SetBreakpoints(const Breakpoints* breakpoints);
-  void SetStepping();
-  void ClearAllBreakpoints();
+    bool Equals(const OpcodeSet& other) const;
+
+   private:
+    static const int kWords =
+        (Bytecode::kNumBytecodes + kBitsPerWord - 1) / kBitsPerWord;
+    uword bits_[kWords];
+  };
 
-  State state_;
+  // The opcodes whose entries currently point to the debug versions.
+  OpcodeSet applied_;
 };
 
 }  // namespace dartino
@@ -5,11 +5,13 @@
 #include "src/vm/event_handler.h"
 
 #include "src/shared/utils.h"
+#include "src/vm/metrics.h"
 #include "src/vm/object.h"
 #include "src/vm/port.h"
 #include "src/vm/process.h"
 #include "src/vm/scheduler.h"
 #include "src/vm/thread.h"
+#include "src/vm/timeline.h"
 
 namespace dartino {
 
@@ -105,6 +107,7 @@ void EventHandler::ReceiverForPortsDied(Port* ports) {
 
 void* EventHandler::RunEventHandler(void* peer) {
   EventHandler* event_handler = reinterpret_cast<EventHandler*>(peer);
+  Timeline::SetThreadName("Event handler");
   event_handler->Run();
   return NULL;
 }
@@ -150,7 +153,8 @@ void EventHandler::ScheduleTimeout(int64 timeout, Port* port) {
 
 void EventHandler::HandleTimeouts() {
   // Check timeouts.
-  int64 current_time = Platform::GetMicroseconds() / 1000;
+  uint64 now = Platform::GetMicroseconds();
+  int64 current_time = now / 1000;
 
   ScopedMonitorLock scoped_lock(monitor_);
   if (next_timeout_ > current_time) return;
@@ -159,6 +163,7 @@ void EventHandler::HandleTimeouts() {
   while (!timeouts_.IsEmpty()) {
     auto minimum = timeouts_.Minimum();
     if (minimum.priority <= current_time) {
+      Metrics::timer_latency_us.Record(now - minimum.priority * 1000);
       Send(minimum.value, 0, true);
       timeouts_.RemoveMinimum();
     } else {
@@ -173,6 +178,7 @@ void EventHandler::Send(Port* port, int64 value, bool release_port) {
   port->Lock();
   Process* port_process = port->process();
   if (port_process != NULL) {
+    Timeline::Instant("EventHandler::Send", port_process);
     port_process->mailbox()->EnqueueLargeInteger(port, value);
     port_process->program()->scheduler()->ResumeProcess(port_process);
   }
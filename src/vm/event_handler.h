@@ -7,6 +7,7 @@
 
 #include "src/shared/globals.h"
 #include "src/vm/priority_heap.h"
+#include "src/vm/slab_allocator.h"
 #include "src/vm/thread.h"
 
 namespace dartino {
@@ -16,7 +17,7 @@ class Port;
 class Object;
 class Process;
 
-class EventListener {
+class EventListener : public SlabAllocated<SlabAllocator::kEventListener> {
  public:
   virtual ~EventListener() {}
   virtual void Send(int64 value) = 0;
@@ -84,6 +84,7 @@ static Object* AllocateCoroutine(Process* process) {
   *previous_frame.LastArgumentAddress() = process->coroutine();
 
   Coroutine::cast(raw_coroutine)->set_stack(stack);
+  process->coroutines()->Add(Coroutine::cast(raw_coroutine));
 
   return raw_coroutine;
 }
@@ -93,6 +94,7 @@ static void RestoreOriginalCoroutine(Process* process,
   Stack* stack = process->coroutine()->stack();
 
   Coroutine* old_coroutine = Coroutine::cast(stack->get(coroutine_slot_index));
+  process->coroutines()->Remove(process->coroutine());
   process->UpdateCoroutine(old_coroutine);
 }
 
@@ -0,0 +1,102 @@
+// Copyright (c) 2016, the Dartino project authors. Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE.md file.
+
+#include "src/vm/intern_table.h"
+
+#include <stdlib.h>
+
+#include "src/shared/utils.h"
+#include "src/vm/object.h"
+#include "src/vm/object_memory.h"
+
+namespace dartino {
+
+// Marks slots whose string died. It is never a valid heap object pointer.
+static OneByteString* const kDeletedEntry =
+    reinterpret_cast<OneByteString*>(HeapObject::kTag);
+
+InternTable::InternTable()
+    : table_(NULL), capacity_(0), size_(0), deleted_(0) {}
+
+InternTable::~InternTable() { free(table_); }
+
+word InternTable::FindIndex(OneByteString* string) {
+  ASSERT(Utils::IsPowerOfTwo(capacity_));
+  word mask = capacity_ - 1;
+  word index = string->Hash() & mask;
+  word insertion_index = -1;
+  while (true) {
+    OneByteString* entry = table_[index];
+    if (entry == NULL) {
+      return insertion_index == -1 ? index : insertion_index;
+    }
+    if (entry == kDeletedEntry) {
+      if (insertion_index == -1) insertion_index = index;
+    } else if (entry->Equals(string)) {
+      return index;
+    }
+    index = (index + 1) & mask;
+  }
+}
+
+OneByteString* InternTable::Lookup(OneByteString* string) {
+  if (size_ == 0) return NULL;
+  OneByteString* entry = table_[FindIndex(string)];
+  return entry == kDeletedEntry ? NULL : entry;
+}
+
+OneByteString* InternTable::Intern(OneByteString* string) {
+  // Keep the load factor, including deleted slots, at or below one half.
+  if (2 * (size_ + deleted_ + 1) > capacity_) {
+    word new_capacity = capacity_ == 0 ? kInitialCapacity : capacity_;
+    while (2 * (size_ + 1) > new_capacity) new_capacity *= 2;
+    // Shrink again if most of the strings died.
+    while (new_capacity > kInitialCapacity && 8 * (size_ + 1) < new_capacity) {
+      new_capacity /= 2;
+    }
+    Rehash(new_capacity);
+  }
+  word index = FindIndex(string);
+  OneByteString* entry = table_[index];
+  if (entry != NULL && entry != kDeletedEntry) return entry;
+  if (entry == kDeletedEntry) deleted_--;
+  table_[index] = string;
+  size_++;
+  return string;
+}
+
+void InternTable::Rehash(word new_capacity) {
+  OneByteString** old_table = table_;
+  word old_capacity = capacity_;
+  table_ = reinterpret_cast<OneByteString**>(
+      calloc(new_capacity, sizeof(OneByteString*)));
+  capacity_ = new_capacity;
+  deleted_ = 0;
+  for (word i = 0; i < old_capacity; i++) {
+    OneByteString* entry = old_table[i];
+    if (entry != NULL && entry != kDeletedEntry) {
+      table_[FindIndex(entry)] = entry;
+    }
+  }
+  free(old_table);
+}
+
+void InternTable::CleanupAfterGC(Space* space) {
+  // Only the pointers are updated here. The strings may not have been moved
+  // to their new location yet, so their contents cannot be read.
+  for (word i = 0; i < capacity_; i++) {
+    OneByteString* entry = table_[i];
+    if (entry == NULL || entry == kDeletedEntry) continue;
+    if (!space->Includes(entry->address())) continue;
+    if (space->IsAlive(entry)) {
+      table_[i] = reinterpret_cast<OneByteString*>(space->NewLocation(entry));
+    } else {
+      table_[i] = kDeletedEntry;
+      size_--;
+      deleted_++;
+    }
+  }
+}
+
+}  // namespace dartino
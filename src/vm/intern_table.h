@@ -0,0 +1,57 @@
+// Copyright (c) 2016, the Dartino project authors. Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE.md file.
+
+#ifndef SRC_VM_INTERN_TABLE_H_
+#define SRC_VM_INTERN_TABLE_H_
+
+#include "src/shared/globals.h"
+
+namespace dartino {
+
+class OneByteString;
+class Space;
+
+// A weak set of canonical one-byte strings. Interning a string returns the
+// first string with the same contents that was interned, so equal interned
+// strings are identical and compare with a single pointer comparison.
+//
+// The table does not keep its strings alive. After each collection of a
+// space that may contain interned strings, CleanupAfterGC must be called
+// with that space to drop dead strings and update moved ones. Since the
+// hash codes of strings are based on their contents, moved strings keep
+// their position in the table, and dead ones leave a deleted marker behind
+// until the next rehash.
+class InternTable {
+ public:
+  InternTable();
+  ~InternTable();
+
+  // Returns the canonical string equal to [string], adding [string] to the
+  // table if there is none yet.
+  OneByteString* Intern(OneByteString* string);
+
+  // Returns the canonical string equal to [string] or NULL.
+  OneByteString* Lookup(OneByteString* string);
+
+  void CleanupAfterGC(Space* space);
+
+  word size() const { return size_; }
+
+ private:
+  static const word kInitialCapacity = 64;
+
+  // Returns the index of the slot holding a string equal to [string], or of
+  // the slot where it should be inserted.
+  word FindIndex(OneByteString* string);
+  void Rehash(word new_capacity);
+
+  OneByteString** table_;
+  word capacity_;
+  word size_;
+  word deleted_;
+};
+
+}  // namespace dartino
+
+#endif  // SRC_VM_INTERN_TABLE_H_
@@ -17,6 +17,8 @@
 #include "src/vm/natives.h"
 #include "src/vm/port.h"
 #include "src/vm/process.h"
+#include "src/vm/scheduler.h"
+#include "src/vm/session.h"
 
 namespace dartino {
 
@@ -376,11 +378,37 @@ Function* HandleInvokeSelector(Process* process) {
   return target;
 }
 
+static void SendLogpoint(Process* process, const Breakpoint* breakpoint,
+                         Object** sp, word height) {
+  Session* session = process->program()->session();
+  if (session == NULL) return;
+  process->EnsureDebuggerAttached();
+  int log_slot = breakpoint->log_slot();
+  Object* value = NULL;
+  if (log_slot >= 0 && log_slot < height) value = *(sp + log_slot);
+  int suppressed_count = breakpoint->TakeSuppressedCount();
+  if (!session->Logpoint(process, breakpoint->id(), breakpoint->hit_count(),
+                         suppressed_count, value)) {
+    // The session's queue is full. Report this hit and the suppressed ones
+    // as suppressed with the next hit that gets through.
+    breakpoint->AddSuppressedCount(suppressed_count + 1);
+  }
+}
+
 int HandleAtBytecode(Process* process, uint8* bcp, Object** sp) {
   // TODO(ajohnsen): Support validate stack.
 
-  // Always hit process-local/one-shot breakpoints first.
   ProcessDebugInfo* process_info = process->debug_info();
+  ProgramDebugInfo* program_info = process->program()->debug_info();
+
+  // Tracepoint probes are recorded before breaking, so they must not be
+  // recorded again when resuming from a breakpoint.
+  bool is_resuming = process_info != NULL && process_info->is_at_breakpoint();
+  if (program_info != NULL && !is_resuming) {
+    program_info->HitTracepoint(process, bcp, sp);
+  }
+
+  // Always hit process-local/one-shot breakpoints first.
   if (process_info != NULL) {
     // If resuming from a breakpoint, clear the breakpoint and ignore the call.
     if (process_info->is_at_breakpoint()) {
@@ -394,10 +422,22 @@ int HandleAtBytecode(Process* process, uint8* bcp, Object** sp) {
     }
   }
 
-  ProgramDebugInfo* program_info = process->program()->debug_info();
   if (program_info != NULL) {
     const Breakpoint* breakpoint = program_info->GetBreakpointAt(bcp);
     if (breakpoint != NULL) {
+      // The number of words between [sp] and the end of the stack, which
+      // bounds the slots conditions and logpoints may read.
+      Stack* stack = process->stack();
+      word height = stack->length() - (sp - stack->Pointer(0));
+      switch (breakpoint->Hit(sp, height)) {
+        case Breakpoint::kIgnoreHit:
+          return Interpreter::kReady;
+        case Breakpoint::kLogHit:
+          SendLogpoint(process, breakpoint, sp, height);
+          return Interpreter::kReady;
+        case Breakpoint::kBreakOnHit:
+          break;
+      }
       process->EnsureDebuggerAttached();
       process->debug_info()->SetCurrentBreakpoint(breakpoint);
       return Interpreter::kBreakpoint;
@@ -0,0 +1,260 @@
+// Copyright (c) 2016, the Dartino project authors. Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE.md file.
+
+#include "src/vm/log_writer.h"
+
+#include <string.h>
+
+namespace dartino {
+
+FileLogSink::FileLogSink() : out_(stdout), error_(stderr), owns_files_(false) {}
+
+FileLogSink::FileLogSink(const char* path)
+    : out_(fopen(path, "a")), error_(out_), owns_files_(true) {}
+
+FileLogSink::~FileLogSink() {
+  if (owns_files_ && out_ != NULL) fclose(out_);
+}
+
+void FileLogSink::Write(bool is_error, const char* text, int length) {
+  if (out_ == NULL) return;
+  fwrite(text, 1, length, is_error ? error_ : out_);
+}
+
+void FileLogSink::Flush() {
+  if (out_ == NULL) return;
+  fflush(out_);
+  if (error_ != out_) fflush(error_);
+}
+
+static void* RunLogWriter(void* data) {
+  reinterpret_cast<LogWriter*>(data)->Run();
+  return NULL;
+}
+
+LogWriter::LogWriter(LogSink* sink, Policy policy, bool annotate)
+    : sink_(sink),
+      policy_(policy),
+      annotate_(annotate),
+      next_record_(0),
+      first_unwritten_(0),
+      dropped_(0),
+      monitor_(Platform::CreateMonitor()),
+      wake_up_(false),
+      stopping_(false),
+      writer_idle_(false),
+      written_(0),
+      batch_length_(0),
+      batch_is_error_(false),
+      reported_dropped_(0) {
+  // A record is free for position p when its sequence is p, and written
+  // and ready for the writer thread when its sequence is p + 1.
+  for (int i = 0; i < kRecordCount; i++) records_[i].sequence = i;
+  at_line_start_[0] = true;
+  at_line_start_[1] = true;
+  thread_ = Thread::Run(RunLogWriter, this);
+}
+
+LogWriter::~LogWriter() {
+  {
+    ScopedMonitorLock lock(monitor_);
+    stopping_ = true;
+    monitor_->NotifyAll();
+  }
+  thread_.Join();
+  delete monitor_;
+  delete sink_;
+}
+
+void LogWriter::Flush() {
+  uword end = next_record_;
+  ScopedMonitorLock lock(monitor_);
+  wake_up_ = true;
+  monitor_->NotifyAll();
+  while (written_ < end) monitor_->Wait();
+}
+
+void LogWriter::Add(bool is_error, const char* message) {
+  uint64 timestamp = Platform::GetMicroseconds();
+  Process* process = Thread::GetProcess();
+  int length = strlen(message);
+  do {
+    int chunk = Utils::Minimum(length, kRecordTextLength);
+    if (!AddRecord(is_error, message, chunk, timestamp, process)) {
+      ++dropped_;
+      return;
+    }
+    message += chunk;
+    length -= chunk;
+  } while (length > 0);
+}
+
+bool LogWriter::AddRecord(bool is_error, const char* text, int length,
+                          uint64 timestamp, Process* process) {
+  uword position = next_record_.load(kRelaxed);
+  Record* record;
+  while (true) {
+    record = &records_[position % kRecordCount];
+    uword sequence = record->sequence.load(kAcquire);
+    word difference = static_cast<word>(sequence - position);
+    if (difference == 0) {
+      if (next_record_.compare_exchange_weak(position, position + 1,
+                                             kRelaxed)) {
+        break;
+      }
+    } else if (difference < 0) {
+      // The ring is full.
+      if (policy_ == kDropWhenFull) return false;
+      ScopedMonitorLock lock(monitor_);
+      wake_up_ = true;
+      monitor_->NotifyAll();
+      while (first_unwritten_ + kRecordCount <= position) monitor_->Wait();
+      position = next_record_.load(kRelaxed);
+    } else {
+      // Another thread claimed the record first.
+      position = next_record_.load(kRelaxed);
+    }
+  }
+
+  record->is_error = is_error;
+  record->length = length;
+  record->timestamp = timestamp;
+  record->process = process;
+  memcpy(record->text, text, length);
+  // Sequentially consistent, so either the writer sees the record before it
+  // goes idle or we see that it is idle.
+  record->sequence.store(position + 1);
+
+  if (writer_idle_.load()) {
+    ScopedMonitorLock lock(monitor_);
+    monitor_->NotifyAll();
+  } else if (position - first_unwritten_ == kRecordCount / 2) {
+    // Don't wait for the flush interval if the ring is filling up.
+    WakeWriter();
+  }
+  return true;
+}
+
+void LogWriter::WakeWriter() {
+  ScopedMonitorLock lock(monitor_);
+  wake_up_ = true;
+  monitor_->NotifyAll();
+}
+
+bool LogWriter::HasUnwrittenRecord() const {
+  uword position = first_unwritten_;
+  return records_[position % kRecordCount].sequence.load() == position + 1;
+}
+
+void LogWriter::Run() {
+  monitor_->Lock();
+  while (true) {
+    bool stopping = stopping_;
+    wake_up_ = false;
+    monitor_->Unlock();
+    WriteRecords();
+    monitor_->Lock();
+    // Wake up threads waiting for the ring to drain.
+    written_ = first_unwritten_;
+    monitor_->NotifyAll();
+    if (stopping) break;
+    if (!wake_up_ && !stopping_ && !HasUnwrittenRecord()) {
+      // Sleep until a message is added, so an idle VM has no wakeups.
+      writer_idle_.store(true);
+      while (!wake_up_ && !stopping_ && !HasUnwrittenRecord()) {
+        monitor_->Wait();
+      }
+      writer_idle_.store(false);
+    }
+    // Give the printing threads a moment to add more output to the batch.
+    if (!wake_up_ && !stopping_) monitor_->Wait(kFlushIntervalUs);
+  }
+  monitor_->Unlock();
+}
+
+void LogWriter::WriteRecords() {
+  uword position = first_unwritten_;
+  bool wrote = false;
+  while (true) {
+    Record* record = &records_[position % kRecordCount];
+    if (record->sequence.load(kAcquire) != position + 1) break;
+    bool is_error = record->is_error;
+    const char* text = record->text;
+    int length = record->length;
+    while (length > 0) {
+      const char* newline =
+          reinterpret_cast<const char*>(memchr(text, '\n', length));
+      int line_length = (newline == NULL) ? length : newline - text + 1;
+      if (annotate_ && at_line_start_[is_error]) {
+        AppendPrefix(is_error, record->timestamp, record->process);
+      }
+      Append(is_error, text, line_length);
+      at_line_start_[is_error] = newline != NULL;
+      text += line_length;
+      length -= line_length;
+    }
+    record->sequence.store(position + kRecordCount, kRelease);
+    first_unwritten_.store(++position, kRelease);
+    wrote = true;
+  }
+
+  word dropped = dropped_;
+  if (dropped != reported_dropped_) {
+    if (!at_line_start_[true]) Append(true, "\n", 1);
+    if (annotate_) AppendPrefix(true, Platform::GetMicroseconds(), NULL);
+    char message[64];
+    int length = snprintf(message, sizeof(message),
+                          "[%d messages dropped]\n",
+                          static_cast<int>(dropped - reported_dropped_));
+    Append(true, message, length);
+    at_line_start_[true] = true;
+    reported_dropped_ = dropped;
+    wrote = true;
+  }
+
+  if (wrote) {
+    WriteBatch();
+    sink_->Flush();
+  }
+}
+
+void LogWriter::Append(bool is_error, const char* text, int length) {
+  if (batch_length_ > 0 && is_error != batch_is_error_) WriteBatch();
+  batch_is_error_ = is_error;
+  while (length > 0) {
+    int chunk = Utils::Minimum(length, kBatchSize - batch_length_);
+    memcpy(batch_ + batch_length_, text, chunk);
+    batch_length_ += chunk;
+    text += chunk;
+    length -= chunk;
+    if (batch_length_ == kBatchSize) WriteBatch();
+  }
+}
+
+void LogWriter::AppendPrefix(bool is_error, uint64 timestamp,
+                             Process* process) {
+  const char* severity = is_error ? "ERROR" : "INFO";
+  long long seconds = timestamp / 1000000;  // NOLINT
+  int microseconds = timestamp % 1000000;
+  char prefix[96];
+  int length;
+  if (process != NULL) {
+    length = snprintf(prefix, sizeof(prefix), "Dartino VM %s: [%lld.%06d %p] ",
+                      severity, seconds, microseconds,
+                      reinterpret_cast<void*>(process));
+  } else {
+    length = snprintf(prefix, sizeof(prefix), "Dartino VM %s: [%lld.%06d] ",
+                      severity, seconds, microseconds);
+  }
+  Append(is_error, prefix, length);
+}
+
+void LogWriter::WriteBatch() {
+  if (batch_length_ == 0) return;
+  batch_[batch_length_] = '\0';
+  sink_->Write(batch_is_error_, batch_, batch_length_);
+  batch_length_ = 0;
+}
+
+}  // namespace dartino
@@ -0,0 +1,156 @@
+// Copyright (c) 2016, the Dartino project authors. Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE.md file.
+
+#ifndef SRC_VM_LOG_WRITER_H_
+#define SRC_VM_LOG_WRITER_H_
+
+#include <stdio.h>
+
+#include "src/shared/atomic.h"
+#include "src/shared/platform.h"
+#include "src/shared/utils.h"
+
+#include "src/vm/thread.h"
+
+namespace dartino {
+
+// Destination of the output of a LogWriter. All calls are made on the
+// writer thread.
+class LogSink {
+ public:
+  virtual ~LogSink() {}
+
+  // Writes a batch of output for stdout or stderr. The text is
+  // null-terminated.
+  virtual void Write(bool is_error, const char* text, int length) = 0;
+
+  // Called when there is no more output to write for now.
+  virtual void Flush() {}
+};
+
+// Writes to stdout and stderr, or appends both to a single file.
+class FileLogSink : public LogSink {
+ public:
+  // Uses stdout and stderr.
+  FileLogSink();
+  // Appends to the file at path. The file is kept open until the sink
+  // is deleted.
+  explicit FileLogSink(const char* path);
+  virtual ~FileLogSink();
+
+  bool is_open() const { return out_ != NULL; }
+
+  virtual void Write(bool is_error, const char* text, int length);
+  virtual void Flush();
+
+ private:
+  FILE* out_;
+  FILE* error_;
+  bool owns_files_;
+};
+
+// A print interceptor that moves writing and flushing the output off the
+// printing threads. Messages are copied into a fixed size ring of records
+// that printing threads claim without taking a lock, and a background
+// thread writes them to the sink in batches. Long messages are split over
+// several records.
+//
+// When the ring is full, messages are either dropped, in which case the
+// writer reports how many were lost, or the printing thread waits for the
+// writer to catch up. Errors are written to the sink before Error returns, so
+// the message of a failing assertion is not lost when the VM aborts.
+//
+// The writer thread sleeps until output arrives and then waits at most
+// kFlushIntervalUs for more output to batch with it.
+//
+// If annotate is true, each line of output is prefixed with its severity,
+// the time it was printed and the process that printed it.
+class LogWriter : public PrintInterceptor {
+ public:
+  enum Policy {
+    kDropWhenFull,
+    kBlockWhenFull,
+  };
+
+  // Takes ownership of the sink and starts the writer thread.
+  LogWriter(LogSink* sink, Policy policy, bool annotate);
+
+  // Writes all buffered output and stops the writer thread.
+  virtual ~LogWriter();
+
+  virtual void Out(char* message) { Add(false, message); }
+  virtual void Error(char* message) {
+    Add(true, message);
+    Flush();
+  }
+
+  // Waits until everything printed before the call has been written to
+  // the sink.
+  void Flush();
+
+  // The number of messages that were dropped because the ring was full.
+  word dropped() const { return dropped_; }
+
+  void Run();
+
+ private:
+  static const int kRecordCount = 256;
+  static const int kRecordTextLength = 232;
+  static const int kBatchSize = 16 * KB;
+  // How long buffered output may wait for the writer thread.
+  static const uint64 kFlushIntervalUs = 10 * 1000;
+
+  struct Record {
+    Atomic<uword> sequence;
+    bool is_error;
+    int length;
+    uint64 timestamp;
+    Process* process;
+    char text[kRecordTextLength];
+  };
+
+  void Add(bool is_error, const char* message);
+  bool AddRecord(bool is_error, const char* text, int length,
+                 uint64 timestamp, Process* process);
+  void WakeWriter();
+  bool HasUnwrittenRecord() const;
+
+  // Writes out all complete records. Only called on the writer thread.
+  void WriteRecords();
+  void Append(bool is_error, const char* text, int length);
+  void AppendPrefix(bool is_error, uint64 timestamp, Process* process);
+  void WriteBatch();
+
+  LogSink* const sink_;
+  const Policy policy_;
+  const bool annotate_;
+
+  Record records_[kRecordCount];
+  Atomic<uword> next_record_;
+  // Only written by the writer thread.
+  Atomic<uword> first_unwritten_;
+  Atomic<word> dropped_;
+
+  Monitor* monitor_;
+  bool wake_up_;
+  bool stopping_;
+  // Set while the writer thread waits for output without a timeout.
+  Atomic<bool> writer_idle_;
+  // The records that have been passed to the sink.
+  uword written_;
+  ThreadIdentifier thread_;
+
+  // State of the writer thread.
+  char batch_[kBatchSize + 1];
+  int batch_length_;
+  bool batch_is_error_;
+  bool at_line_start_[2];
+  word reported_dropped_;
+
+  DISALLOW_COPY_AND_ASSIGN(LogWriter);
+};
+
+}  // namespace dartino
+
+#endif  // SRC_VM_LOG_WRITER_H_
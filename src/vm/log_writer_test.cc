@@ -0,0 +1,120 @@
+// Copyright (c) 2016, the Dartino project authors. Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE.md file.
+
+#include <string.h>
+
+#include "src/shared/assert.h"
+#include "src/shared/test_case.h"
+
+#include "src/vm/log_writer.h"
+
+namespace dartino {
+
+// Collects the output written by a LogWriter.
+class TestLogSink : public LogSink {
+ public:
+  TestLogSink() : out_length_(0), error_length_(0), flushes_(0) {
+    out_[0] = '\0';
+    error_[0] = '\0';
+  }
+
+  virtual void Write(bool is_error, const char* text, int length) {
+    EXPECT_EQ(length, static_cast<int>(strlen(text)));
+    char* buffer = is_error ? error_ : out_;
+    int* buffer_length = is_error ? &error_length_ : &out_length_;
+    ASSERT(*buffer_length + length < kBufferSize);
+    memcpy(buffer + *buffer_length, text, length + 1);
+    *buffer_length += length;
+  }
+
+  virtual void Flush() { flushes_++; }
+
+  const char* out() const { return out_; }
+  const char* error() const { return error_; }
+  int flushes() const { return flushes_; }
+
+ private:
+  static const int kBufferSize = 64 * KB;
+
+  char out_[kBufferSize];
+  int out_length_;
+  char error_[kBufferSize];
+  int error_length_;
+  int flushes_;
+};
+
+TEST_CASE(LogWriterOrder) {
+  TestLogSink* sink = new TestLogSink();
+  LogWriter writer(sink, LogWriter::kBlockWhenFull, false);
+  char out[] = "out ";
+  char error[] = "error\n";
+  char line[] = "line\n";
+  writer.Out(out);
+  writer.Error(error);
+  writer.Out(line);
+  writer.Flush();
+  EXPECT_STREQ("out line\n", sink->out());
+  EXPECT_STREQ("error\n", sink->error());
+  EXPECT(sink->flushes() > 0);
+  EXPECT_EQ(0, writer.dropped());
+}
+
+TEST_CASE(LogWriterLongMessages) {
+  TestLogSink* sink = new TestLogSink();
+  LogWriter writer(sink, LogWriter::kBlockWhenFull, false);
+  // Enough output to fill the ring several times over.
+  char message[1001];
+  for (int i = 0; i < 1000; i++) message[i] = 'a' + (i % 26);
+  message[1000] = '\0';
+  for (int i = 0; i < 50; i++) writer.Out(message);
+  writer.Flush();
+  const char* out = sink->out();
+  EXPECT_EQ(50 * 1000, static_cast<int>(strlen(out)));
+  for (int i = 0; i < 50; i++) {
+    EXPECT_EQ(0, strncmp(message, out + i * 1000, 1000));
+  }
+}
+
+TEST_CASE(LogWriterAnnotate) {
+  TestLogSink* sink = new TestLogSink();
+  LogWriter writer(sink, LogWriter::kBlockWhenFull, true);
+  char message[] = "one\ntwo";
+  char end[] = "\n";
+  writer.Out(message);
+  writer.Out(end);
+  writer.Flush();
+  // Each line is prefixed once, also when it is printed in several parts.
+  const char* out = sink->out();
+  EXPECT_EQ(0, strncmp(out, "Dartino VM INFO: [", 18));
+  const char* one = strstr(out, "] one\nDartino VM INFO: [");
+  EXPECT(one != NULL);
+  EXPECT(strstr(one, "] two\n") != NULL);
+  EXPECT(strstr(out, "twoDartino") == NULL);
+  char error[] = "failed\n";
+  writer.Error(error);
+  EXPECT_EQ(0, strncmp(sink->error(), "Dartino VM ERROR: [", 19));
+}
+
+TEST_CASE(LogWriterErrorIsSynchronous) {
+  TestLogSink* sink = new TestLogSink();
+  LogWriter writer(sink, LogWriter::kBlockWhenFull, false);
+  char error[] = "fatal\n";
+  writer.Error(error);
+  // No Flush: the message must already be with the sink, as the VM may
+  // abort right after printing it.
+  EXPECT_STREQ("fatal\n", sink->error());
+}
+
+TEST_CASE(LogWriterDrop) {
+  TestLogSink* sink = new TestLogSink();
+  LogWriter writer(sink, LogWriter::kDropWhenFull, false);
+  char message[] = "x";
+  for (int i = 0; i < 20000; i++) writer.Out(message);
+  word dropped = writer.dropped();
+  writer.Flush();
+  EXPECT_EQ(20000 - dropped, static_cast<word>(strlen(sink->out())));
+  if (dropped > 0) EXPECT(strstr(sink->error(), "dropped]") != NULL);
+}
+
+}  // namespace dartino
@@ -6,8 +6,18 @@
 
 namespace dartino {
 
-LookupCache::LookupCache()
-    : primary_(new Entry[kPrimarySize]), secondary_(new Entry[kSecondarySize]) {
+Atomic<uword> LookupCache::epoch_(0);
+
+LookupCache::LookupCache(int secondary_size)
+    : secondary_size_(secondary_size),
+      primary_(new Entry[kPrimarySize]),
+      secondary_(new Entry[secondary_size]),
+      epoch_seen_(epoch_.load(kAcquire)),
+      secondary_hits_(0),
+      misses_(0) {
+  // A power of two would only use the low bits of the class address, which
+  // are the same for all classes.
+  ASSERT(secondary_size > 0 && !Utils::IsPowerOfTwo(secondary_size));
   Clear();
   // These asserts need to hold when running on the target, but they don't need
   // to hold on the host (the build machine, where the interpreter-generating
@@ -26,7 +36,7 @@ LookupCache::~LookupCache() {
 
 void LookupCache::Clear() {
   memset(primary_, 0, sizeof(Entry) * kPrimarySize);
-  memset(secondary_, 0, sizeof(Entry) * kSecondarySize);
+  memset(secondary_, 0, sizeof(Entry) * secondary_size_);
 }
 
 }  // namespace dartino
@@ -5,6 +5,7 @@
 #ifndef SRC_VM_LOOKUP_CACHE_H_
 #define SRC_VM_LOOKUP_CACHE_H_
 
+#include "src/shared/atomic.h"
 #include "src/shared/globals.h"
 #include "src/shared/utils.h"
 
@@ -13,10 +14,17 @@ namespace dartino {
 class Class;
 class Function;
 
+// Each scheduler worker thread owns a lookup cache that is used by the
+// processes it interprets. The primary table is probed by the interpreter
+// stubs, which embed its size, so only the secondary table can be sized at
+// runtime.
+//
+// Caches are invalidated by bumping a global epoch. A cache notices the new
+// epoch and clears itself the next time a process takes it.
 class LookupCache {
  public:
   static const int kPrimarySize = 4096;
-  static const int kSecondarySize = 2111;
+  static const int kDefaultSecondarySize = 2111;
 
   // If you add an offset here, remember to add the corresponding static_assert
   // in lookup_cache.cc.
@@ -32,22 +40,51 @@ class LookupCache {
     void* code;
   };
 
-  LookupCache();
+  explicit LookupCache(int secondary_size = kDefaultSecondarySize);
   ~LookupCache();
 
   Entry* primary() const { return primary_; }
   Entry* secondary() const { return secondary_; }
+  int secondary_size() const { return secondary_size_; }
 
   inline void DemotePrimary(Entry* primary);
 
   void Clear();
 
+  // Clears the cache if it was filled before the last call to
+  // [InvalidateAll].
+  void Validate() {
+    uword epoch = epoch_.load(kAcquire);
+    if (epoch_seen_ != epoch) {
+      Clear();
+      epoch_seen_ = epoch;
+    }
+  }
+
+  // Invalidates all lookup caches, e.g. after the methods of a program have
+  // changed or moved.
+  static void InvalidateAll() { epoch_.fetch_add(1, kRelease); }
+
+  // Statistics. Only updated by the thread owning the cache. Hits in the
+  // primary table happen in the interpreter stubs and are not counted.
+  void RecordSecondaryHit() { secondary_hits_++; }
+  void RecordMiss() { misses_++; }
+  uword secondary_hits() const { return secondary_hits_; }
+  uword misses() const { return misses_; }
+
   static inline uword ComputePrimaryIndex(Class* clazz, int selector);
-  static inline uword ComputeSecondaryIndex(Class* clazz, int selector);
+  inline uword ComputeSecondaryIndex(Class* clazz, int selector) const;
 
  private:
+  static Atomic<uword> epoch_;
+
+  const int secondary_size_;
   Entry* const primary_;
   Entry* const secondary_;
+  uword epoch_seen_;
+
+  uword secondary_hits_;
+  uword misses_;
 };
 
 inline void LookupCache::DemotePrimary(LookupCache::Entry* primary) {
@@ -63,10 +100,9 @@ uword LookupCache::ComputePrimaryIndex(Class* clazz, int selector) {
   return hash & (kPrimarySize - 1);
 }
 
-uword LookupCache::ComputeSecondaryIndex(Class* clazz, int selector) {
-  ASSERT(!Utils::IsPowerOfTwo(kSecondarySize));
+uword LookupCache::ComputeSecondaryIndex(Class* clazz, int selector) const {
   uword hash = reinterpret_cast<uword>(clazz) - selector;
-  return hash % kSecondarySize;
+  return hash % secondary_size_;
 }
 
 }  // namespace dartino
@@ -0,0 +1,42 @@
+// Copyright (c) 2016, the Dartino project authors. Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE.md file.
+
+#include "src/shared/assert.h"
+#include "src/shared/test_case.h"
+
+#include "src/vm/lookup_cache.h"
+
+namespace dartino {
+
+TEST_CASE(LookupCacheInvalidation) {
+  LookupCache first(101);
+  LookupCache second;
+  EXPECT_EQ(101, first.secondary_size());
+  EXPECT_EQ(2111, second.secondary_size());
+
+  Class* clazz = reinterpret_cast<Class*>(0x1000);
+  LookupCache::Entry* entry = &first.primary()[0];
+  entry->clazz = clazz;
+  entry->selector = 42;
+  first.DemotePrimary(entry);
+  uword index = first.ComputeSecondaryIndex(clazz, 42);
+  EXPECT(index < 101);
+  EXPECT(first.secondary()[index].clazz == clazz);
+  second.primary()[0].clazz = clazz;
+
+  // Validating without a new epoch keeps the entries.
+  first.Validate();
+  EXPECT(first.primary()[0].clazz == clazz);
+
+  // After invalidation, each cache is cleared when it is validated.
+  LookupCache::InvalidateAll();
+  first.Validate();
+  EXPECT(first.primary()[0].clazz == NULL);
+  EXPECT(first.secondary()[index].clazz == NULL);
+  EXPECT(second.primary()[0].clazz == clazz);
+  second.Validate();
+  EXPECT(second.primary()[0].clazz == NULL);
+}
+
+}  // namespace dartino
@@ -8,6 +8,7 @@
 #include "src/shared/globals.h"
 #include "src/shared/atomic.h"
 
+#include "src/vm/metrics.h"
 #include "src/vm/object.h"
 
 namespace dartino {
@@ -21,11 +22,13 @@ class Mailbox {
       MessageType* entry = last_message_;
       last_message_ = entry->next();
       delete entry;
+      Metrics::queued_messages.Decrement(this);
     }
     while (current_message_ != NULL) {
       MessageType* entry = current_message_;
       current_message_ = entry->next();
       delete entry;
+      Metrics::queued_messages.Decrement(this);
     }
     ASSERT(last_message_.load() == NULL);
   }
@@ -37,6 +40,8 @@ class Mailbox {
       entry->set_next(last);
       if (last_message_.compare_exchange_weak(last, entry)) break;
     }
+    Metrics::messages.Increment(this);
+    Metrics::queued_messages.Increment(this);
   }
 
   // Thread-safe way of asking if the mailbox is empty.
@@ -60,6 +65,7 @@ class Mailbox {
     MessageType* temp = current_message_;
     current_message_ = current_message_->next();
     delete temp;
+    Metrics::queued_messages.Decrement(this);
   }
 
   void IteratePointers(PointerVisitor* visitor) {
@@ -16,7 +16,7 @@
 #include "src/shared/globals.h"
 
 #include "src/vm/session.h"
-#include "src/vm/log_print_interceptor.h"
+#include "src/vm/log_writer.h"
 
 namespace dartino {
 
@@ -104,6 +104,10 @@ static void PrintUsage() {
 
 static void PrintVersion() { Print::Out("%s\n", GetVersion()); }
 
+static void FlushPrintOutput() {
+  Print::UnregisterPrintInterceptors();
+}
+
 static int Main(int argc, char** argv) {
   Flags::ExtractFromCommandLine(&argc, argv);
   DartinoSetup();
@@ -179,6 +183,10 @@ static int Main(int argc, char** argv) {
 
   int result = 0;
 
+  LogWriter::Policy policy = Flags::drop_print_output
+      ? LogWriter::kDropWhenFull
+      : LogWriter::kBlockWhenFull;
+
   // Check if we should add a log print interceptor.
   if (log_dir != NULL) {
     int pid = Platform::GetPid();
@@ -186,9 +194,19 @@ static int Main(int argc, char** argv) {
     char log_path[MAXPATHLEN + 1];
     Platform::FormatString(log_path, sizeof(log_path), "%s/vm-%d.log",
                            log_dir, pid);
-    Print::RegisterPrintInterceptor(new LogPrintInterceptor(log_path));
+    Print::RegisterPrintInterceptor(
+        new LogWriter(new FileLogSink(log_path), policy, true));
   }
 
+  if (Flags::async_print) {
+    Print::RegisterPrintInterceptor(
+        new LogWriter(new FileLogSink(), policy, false));
+    Print::DisableStandardOutput();
+  }
+
+  // Write out the buffered output when exiting.
+  if (log_dir != NULL || Flags::async_print) atexit(FlushPrintOutput);
+
   DartinoProgram program;
 
   // Check if we're passed an snapshot file directly.
@@ -11,6 +11,7 @@
 #include "src/vm/heap.h"
 #include "src/vm/mailbox.h"
 #include "src/vm/port.h"
+#include "src/vm/slab_allocator.h"
 
 namespace dartino {
 
@@ -29,7 +30,8 @@ class ExitReference {
   Object* message_;
 };
 
-class Message : public MailboxMessage<Message> {
+class Message : public MailboxMessage<Message>,
+                public SlabAllocated<SlabAllocator::kMessage> {
  public:
   enum Kind {
     IMMEDIATE,
@@ -0,0 +1,275 @@
+// Copyright (c) 2016, the Dartino project authors. Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE.md file.
+
+#include "src/vm/metrics.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+#if defined(DARTINO_TARGET_OS_POSIX)
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#endif
+
+#include "src/vm/thread.h"
+
+namespace dartino {
+
+#define DEFINE_COUNTER(name, doc) Counter Metrics::name;
+#define DEFINE_STRIPED_COUNTER(name, doc) StripedCounter Metrics::name;
+#define DEFINE_GAUGE(name, doc) Gauge Metrics::name;
+#define DEFINE_STRIPED_GAUGE(name, doc) StripedGauge Metrics::name;
+#define DEFINE_HISTOGRAM(name, doc) Histogram Metrics::name;
+METRICS_DO(DEFINE_COUNTER, DEFINE_STRIPED_COUNTER, DEFINE_GAUGE,
+           DEFINE_STRIPED_GAUGE, DEFINE_HISTOGRAM)
+#undef DEFINE_COUNTER
+#undef DEFINE_STRIPED_COUNTER
+#undef DEFINE_GAUGE
+#undef DEFINE_STRIPED_GAUGE
+#undef DEFINE_HISTOGRAM
+
+// Appends formatted text to a fixed buffer and keeps counting the length
+// of the output once the buffer is full.
+class MetricsFormatter {
+ public:
+  MetricsFormatter(char* buffer, int length)
+      : buffer_(buffer), length_(length), position_(0) {
+    if (length_ > 0) buffer_[0] = '\0';
+  }
+
+  int position() const { return position_; }
+
+  void Printf(const char* format, ...) {
+    int remaining = (position_ < length_) ? length_ - position_ : 0;
+    char* destination = (remaining > 0) ? buffer_ + position_ : NULL;
+    va_list args;
+    va_start(args, format);
+    int written = vsnprintf(destination, remaining, format, args);
+    va_end(args);
+    if (written > 0) position_ += written;
+  }
+
+  void Header(const char* name, const char* suffix, const char* type,
+              const char* doc) {
+    Printf("# HELP dartino_%s%s %s\n", name, suffix, doc);
+    Printf("# TYPE dartino_%s%s %s\n", name, suffix, type);
+  }
+
+  void FormatCounter(const char* name, const char* doc, uword value) {
+    Header(name, "_total", "counter", doc);
+    Printf("dartino_%s_total %llu\n", name,
+           static_cast<unsigned long long>(value));  // NOLINT
+  }
+
+  void FormatGauge(const char* name, const char* doc, word value) {
+    Header(name, "", "gauge", doc);
+    Printf("dartino_%s %lld\n", name, static_cast<long long>(value));  // NOLINT
+  }
+
+  void FormatHistogram(const char* name, const char* doc,
+                       const Histogram* histogram) {
+    Header(name, "", "histogram", doc);
+    // Prometheus buckets are cumulative.
+    uword count = 0;
+    int last = Histogram::kBucketCount - 1;
+    for (int i = 0; i < last; i++) {
+      count += histogram->bucket(i);
+      Printf("dartino_%s_bucket{le=\"%llu\"} %llu\n", name,
+             1ULL << i, static_cast<unsigned long long>(count));  // NOLINT
+    }
+    count += histogram->bucket(last);
+    Printf("dartino_%s_bucket{le=\"+Inf\"} %llu\n", name,
+           static_cast<unsigned long long>(count));  // NOLINT
+    Printf("dartino_%s_sum %llu\n", name,
+           static_cast<unsigned long long>(histogram->sum()));  // NOLINT
+    Printf("dartino_%s_count %llu\n", name,
+           static_cast<unsigned long long>(count));  // NOLINT
+  }
+
+ private:
+  char* const buffer_;
+  const int length_;
+  int position_;
+};
+
+int Metrics::Format(char* buffer, int length) {
+  MetricsFormatter formatter(buffer, length);
+#define FORMAT_COUNTER(name, doc) \
+  formatter.FormatCounter(#name, doc, name.value());
+#define FORMAT_GAUGE(name, doc) formatter.FormatGauge(#name, doc, name.value());
+#define FORMAT_HISTOGRAM(name, doc) \
+  formatter.FormatHistogram(#name, doc, &name);
+  // Striped metrics are read and formatted like the plain ones.
+  METRICS_DO(FORMAT_COUNTER, FORMAT_COUNTER, FORMAT_GAUGE, FORMAT_GAUGE,
+             FORMAT_HISTOGRAM)
+#undef FORMAT_COUNTER
+#undef FORMAT_GAUGE
+#undef FORMAT_HISTOGRAM
+  return formatter.position();
+}
+
+#if defined(DARTINO_TARGET_OS_POSIX)
+
+#if !defined(MSG_NOSIGNAL)
+#define MSG_NOSIGNAL 0
+#endif
+
+// A minimal HTTP/1.0 server answering GET /metrics on localhost. It runs
+// on its own thread and uses only the buffers below, so serving a request
+// never allocates and never touches a Dart heap.
+class MetricsServer {
+ public:
+  explicit MetricsServer(int fd) : fd_(fd), stopping_(false) {}
+
+  void Start() { thread_ = Thread::Run(RunMetricsServer, this); }
+
+  void Stop() {
+    stopping_ = true;
+    thread_.Join();
+    close(fd_);
+  }
+
+ private:
+  static const int kRequestSize = 1 * KB;
+  static const int kResponseSize = 32 * KB;
+  // How often the server checks whether it should stop.
+  static const int kPollIntervalMs = 100;
+
+  static void* RunMetricsServer(void* data) {
+    reinterpret_cast<MetricsServer*>(data)->Run();
+    return NULL;
+  }
+
+  void Run() {
+    while (!stopping_) {
+      struct pollfd poll_fd;
+      poll_fd.fd = fd_;
+      poll_fd.events = POLLIN;
+      poll_fd.revents = 0;
+      if (poll(&poll_fd, 1, kPollIntervalMs) <= 0) continue;
+      int client = accept(fd_, NULL, NULL);
+      if (client < 0) continue;
+      HandleRequest(client);
+      close(client);
+    }
+  }
+
+  void HandleRequest(int client) {
+    // Don't let a slow client block the server for long.
+    struct timeval timeout = {1, 0};
+    setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    setsockopt(client, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+#if defined(SO_NOSIGPIPE)
+    int one = 1;
+    setsockopt(client, SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof(one));
+#endif
+
+    int length = 0;
+    while (length < kRequestSize - 1) {
+      ssize_t bytes =
+          recv(client, request_ + length, kRequestSize - 1 - length, 0);
+      if (bytes <= 0) break;
+      length += bytes;
+      request_[length] = '\0';
+      if (strstr(request_, "\r\n\r\n") != NULL) break;
+    }
+    request_[length] = '\0';
+
+    const char* status = "404 Not Found";
+    int body_length = 0;
+    response_[0] = '\0';
+    if (strncmp(request_, "GET /metrics ", 13) == 0 ||
+        strncmp(request_, "GET / ", 6) == 0) {
+      status = "200 OK";
+      body_length = Utils::Minimum(Metrics::Format(response_, kResponseSize),
+                                   kResponseSize - 1);
+    }
+
+    char header[128];
+    int header_length = snprintf(
+        header, sizeof(header),
+        "HTTP/1.0 %s\r\n"
+        "Content-Type: text/plain; version=0.0.4\r\n"
+        "Content-Length: %d\r\n"
+        "\r\n",
+        status, body_length);
+    if (SendAll(client, header, header_length)) {
+      SendAll(client, response_, body_length);
+    }
+  }
+
+  static bool SendAll(int client, const char* data, int length) {
+    while (length > 0) {
+      ssize_t bytes = send(client, data, length, MSG_NOSIGNAL);
+      if (bytes < 0 && errno == EINTR) continue;
+      if (bytes <= 0) return false;
+      data += bytes;
+      length -= bytes;
+    }
+    return true;
+  }
+
+  const int fd_;
+  Atomic<bool> stopping_;
+  ThreadIdentifier thread_;
+  char request_[kRequestSize];
+  char response_[kResponseSize];
+
+  DISALLOW_COPY_AND_ASSIGN(MetricsServer);
+};
+
+static MetricsServer* server_ = NULL;
+
+void Metrics::StartServer(int port) {
+  ASSERT(server_ == NULL);
+  int fd = socket(AF_INET, SOCK_STREAM, 0);
+  if (fd < 0) {
+    Print::Error("Failed to create metrics server socket\n");
+    return;
+  }
+  fcntl(fd, F_SETFD, FD_CLOEXEC);
+  int one = 1;
+  setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+  struct sockaddr_in address;
+  memset(&address, 0, sizeof(address));
+  address.sin_family = AF_INET;
+  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  address.sin_port = htons(port);
+  if (bind(fd, reinterpret_cast<struct sockaddr*>(&address),
+           sizeof(address)) != 0 ||
+      listen(fd, 8) != 0) {
+    Print::Error("Failed to serve metrics on port %d\n", port);
+    close(fd);
+    return;
+  }
+
+  server_ = new MetricsServer(fd);
+  server_->Start();
+}
+
+void Metrics::StopServer() {
+  if (server_ == NULL) return;
+  server_->Stop();
+  delete server_;
+  server_ = NULL;
+}
+
+#else  // defined(DARTINO_TARGET_OS_POSIX)
+
+void Metrics::StartServer(int port) {
+  Print::Error("Serving metrics is not supported on this platform\n");
+}
+
+void Metrics::StopServer() {}
+
+#endif  // defined(DARTINO_TARGET_OS_POSIX)
+
+}  // namespace dartino
@@ -0,0 +1,188 @@
+// Copyright (c) 2016, the Dartino project authors. Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE.md file.
+
+#ifndef SRC_VM_METRICS_H_
+#define SRC_VM_METRICS_H_
+
+#include "src/shared/atomic.h"
+#include "src/shared/globals.h"
+#include "src/shared/utils.h"
+
+namespace dartino {
+
+// The VM-wide metrics. Counters only go up, gauges go up and down and
+// histograms count values in power-of-two buckets. Metrics updated on the
+// messaging paths are striped, so threads working on different objects do
+// not contend for a single cache line.
+//
+// Each metric is exported as dartino_<name>, counters with a _total suffix.
+#define METRICS_DO(COUNTER, STRIPED_COUNTER, GAUGE, STRIPED_GAUGE, HISTOGRAM) \
+  COUNTER(new_space_collections, "Number of new-space garbage collections")   \
+  COUNTER(old_space_collections, "Number of old-space garbage collections")   \
+  COUNTER(new_space_allocated_bytes,                                          \
+          "Bytes allocated in new-space, counted at each collection")         \
+  COUNTER(new_space_survived_bytes,                                           \
+          "Bytes that survived a new-space collection, including promoted")   \
+  STRIPED_COUNTER(messages, "Messages added to process mailboxes")            \
+  STRIPED_GAUGE(queued_messages, "Messages waiting in process mailboxes")     \
+  GAUGE(ready_processes, "Processes waiting in the scheduler ready queue")    \
+  GAUGE(processes, "Processes that are alive")                                \
+  HISTOGRAM(new_space_collection_us,                                          \
+            "Duration of new-space garbage collections in microseconds")      \
+  HISTOGRAM(old_space_collection_us,                                          \
+            "Duration of old-space garbage collections in microseconds")      \
+  HISTOGRAM(timer_latency_us,                                                 \
+            "Delay between a timeout and its message in microseconds")
+
+class Counter {
+ public:
+  Counter() : value_(0) {}
+
+  void Increment(uword amount = 1) { value_.fetch_add(amount, kRelaxed); }
+  uword value() const { return value_.load(kRelaxed); }
+
+ private:
+  Atomic<uword> value_;
+};
+
+class Gauge {
+ public:
+  Gauge() : value_(0) {}
+
+  void Increment(word amount = 1) { value_.fetch_add(amount, kRelaxed); }
+  void Decrement(word amount = 1) { value_.fetch_sub(amount, kRelaxed); }
+
+  // Publishes a value that is maintained elsewhere, for example under a
+  // lock the caller already holds.
+  void Set(word value) { value_.store(value, kRelaxed); }
+
+  word value() const { return value_.load(kRelaxed); }
+
+ private:
+  Atomic<word> value_;
+};
+
+// A sum split over cache-line sized cells. Updates go to the cell picked by
+// a key, such as the object being worked on, and reads add up all cells.
+template <typename T>
+class MetricStripes {
+ public:
+  static const int kStripeBits = 4;
+  static const int kStripeCount = 1 << kStripeBits;
+
+  MetricStripes() {
+    for (int i = 0; i < kStripeCount; i++) cells_[i].value = 0;
+  }
+
+  void Add(const void* key, T amount) {
+    cells_[Index(key)].value.fetch_add(amount, kRelaxed);
+  }
+
+  T Sum() const {
+    T sum = 0;
+    for (int i = 0; i < kStripeCount; i++) {
+      sum += cells_[i].value.load(kRelaxed);
+    }
+    return sum;
+  }
+
+ private:
+  static const int kCellSize = 64;
+
+  struct Cell {
+    Atomic<T> value;
+    uint8 padding[kCellSize - sizeof(Atomic<T>)];
+  };
+
+  static int Index(const void* key) {
+    uint32 hash = static_cast<uint32>(reinterpret_cast<uword>(key) >> 4);
+    return (hash * 0x9E3779B1u) >> (32 - kStripeBits);
+  }
+
+  Cell cells_[kStripeCount];
+};
+
+class StripedCounter {
+ public:
+  void Increment(const void* key, uword amount = 1) {
+    stripes_.Add(key, amount);
+  }
+  uword value() const { return stripes_.Sum(); }
+
+ private:
+  MetricStripes<uword> stripes_;
+};
+
+class StripedGauge {
+ public:
+  void Increment(const void* key, word amount = 1) {
+    stripes_.Add(key, amount);
+  }
+  void Decrement(const void* key, word amount = 1) {
+    stripes_.Add(key, -amount);
+  }
+  word value() const { return stripes_.Sum(); }
+
+ private:
+  MetricStripes<word> stripes_;
+};
+
+// Bucket i counts the values that are at most 2^i. The last bucket counts
+// all larger values.
+class Histogram {
+ public:
+  static const int kBucketCount = 26;
+
+  Histogram() : count_(0), sum_(0) {
+    for (int i = 0; i < kBucketCount; i++) buckets_[i] = 0;
+  }
+
+  void Record(uword value) {
+    int index = (value <= 1) ? 0 : Utils::BitLength(value - 1);
+    if (index >= kBucketCount) index = kBucketCount - 1;
+    buckets_[index].fetch_add(1, kRelaxed);
+    sum_.fetch_add(value, kRelaxed);
+    count_.fetch_add(1, kRelaxed);
+  }
+
+  uword bucket(int index) const { return buckets_[index].load(kRelaxed); }
+  uword count() const { return count_.load(kRelaxed); }
+  uword sum() const { return sum_.load(kRelaxed); }
+
+ private:
+  Atomic<uword> buckets_[kBucketCount];
+  Atomic<uword> count_;
+  Atomic<uword> sum_;
+};
+
+class Metrics {
+ public:
+#define DECLARE_COUNTER(name, doc) static Counter name;
+#define DECLARE_STRIPED_COUNTER(name, doc) static StripedCounter name;
+#define DECLARE_GAUGE(name, doc) static Gauge name;
+#define DECLARE_STRIPED_GAUGE(name, doc) static StripedGauge name;
+#define DECLARE_HISTOGRAM(name, doc) static Histogram name;
+  METRICS_DO(DECLARE_COUNTER, DECLARE_STRIPED_COUNTER, DECLARE_GAUGE,
+             DECLARE_STRIPED_GAUGE, DECLARE_HISTOGRAM)
+#undef DECLARE_COUNTER
+#undef DECLARE_STRIPED_COUNTER
+#undef DECLARE_GAUGE
+#undef DECLARE_STRIPED_GAUGE
+#undef DECLARE_HISTOGRAM
+
+  // Writes all metrics in the Prometheus text format to buffer, without
+  // allocating. Like snprintf, the output is truncated to length - 1
+  // characters and null-terminated, and the result is the length the
+  // complete output would have had.
+  static int Format(char* buffer, int length);
+
+  // Serves the metrics over HTTP on the given localhost port from a VM
+  // thread. Only supported on POSIX platforms.
+  static void StartServer(int port);
+  static void StopServer();
+};
+
+}  // namespace dartino
+
+#endif  // SRC_VM_METRICS_H_
@@ -0,0 +1,103 @@
+// Copyright (c) 2016, the Dartino project authors. Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE.md file.
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "src/shared/assert.h"
+#include "src/shared/test_case.h"
+
+#include "src/vm/metrics.h"
+
+namespace dartino {
+
+TEST_CASE(MetricsHistogramBuckets) {
+  Histogram histogram;
+  histogram.Record(0);
+  histogram.Record(1);
+  histogram.Record(2);
+  histogram.Record(3);
+  histogram.Record(4);
+  histogram.Record(5);
+  histogram.Record(static_cast<uword>(1) << 40);
+  EXPECT_EQ(2, static_cast<int>(histogram.bucket(0)));
+  EXPECT_EQ(1, static_cast<int>(histogram.bucket(1)));
+  EXPECT_EQ(2, static_cast<int>(histogram.bucket(2)));
+  EXPECT_EQ(1, static_cast<int>(histogram.bucket(3)));
+  EXPECT_EQ(1, static_cast<int>(histogram.bucket(Histogram::kBucketCount - 1)));
+  EXPECT_EQ(7, static_cast<int>(histogram.count()));
+}
+
+TEST_CASE(MetricsStripes) {
+  StripedCounter counter;
+  StripedGauge gauge;
+  int keys[64];
+  for (int i = 0; i < 64; i++) {
+    counter.Increment(&keys[i], i);
+    gauge.Increment(&keys[i]);
+  }
+  for (int i = 0; i < 64; i += 2) gauge.Decrement(&keys[i]);
+  EXPECT_EQ(64 * 63 / 2, static_cast<int>(counter.value()));
+  EXPECT_EQ(32, static_cast<int>(gauge.value()));
+}
+
+// Returns the value on the line that starts with [name] followed by a
+// space, or -1 if there is no such line.
+static long long MetricValue(const char* buffer, const char* name) {  // NOLINT
+  int length = strlen(name);
+  for (const char* line = buffer; *line != '\0'; line++) {
+    if (strncmp(line, name, length) == 0 && line[length] == ' ') {
+      return strtoll(line + length + 1, NULL, 10);
+    }
+    line = strchr(line, '\n');
+    if (line == NULL) break;
+  }
+  return -1;
+}
+
+TEST_CASE(MetricsFormat) {
+  static const int kBufferSize = 32 * KB;
+  static char buffer[kBufferSize];
+
+  // The metrics are VM-wide, so only compare against their current values.
+  Metrics::Format(buffer, kBufferSize);
+  const char* const names[] = {
+      "dartino_messages_total",
+      "dartino_ready_processes",
+      "dartino_timer_latency_us_bucket{le=\"64\"}",
+      "dartino_timer_latency_us_bucket{le=\"128\"}",
+      "dartino_timer_latency_us_bucket{le=\"+Inf\"}",
+      "dartino_timer_latency_us_sum",
+  };
+  const int deltas[] = {3, 1, 0, 1, 1, 100};
+  static const int kNameCount = ARRAY_SIZE(names);
+  long long baseline[kNameCount];  // NOLINT
+  for (int i = 0; i < kNameCount; i++) {
+    baseline[i] = MetricValue(buffer, names[i]);
+    EXPECT(baseline[i] >= 0);
+  }
+
+  int key;
+  Metrics::messages.Increment(&key, 3);
+  Metrics::ready_processes.Increment();
+  Metrics::timer_latency_us.Record(100);
+
+  int length = Metrics::Format(buffer, kBufferSize);
+  EXPECT(length < kBufferSize);
+  EXPECT_EQ(length, static_cast<int>(strlen(buffer)));
+  EXPECT(strstr(buffer, "# TYPE dartino_messages_total counter\n") != NULL);
+  for (int i = 0; i < kNameCount; i++) {
+    EXPECT_EQ(baseline[i] + deltas[i], MetricValue(buffer, names[i]));
+  }
+  Metrics::ready_processes.Decrement();
+
+  // Truncated output has the same prefix and the same full length.
+  char small[64];
+  EXPECT_EQ(length, Metrics::Format(small, sizeof(small)));
+  EXPECT_EQ(63, static_cast<int>(strlen(small)));
+  EXPECT_EQ(0, strncmp(buffer, small, 63));
+  EXPECT_EQ(length, Metrics::Format(NULL, 0));
+}
+
+}  // namespace dartino
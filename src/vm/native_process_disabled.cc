@@ -15,6 +15,24 @@ BEGIN_LEAF_NATIVE(NativeProcessSpawnDetached) {
 }
 END_NATIVE()
 
+BEGIN_LEAF_NATIVE(NativeProcessSpawn) {
+  UNIMPLEMENTED();
+  return NULL;
+}
+END_NATIVE()
+
+BEGIN_LEAF_NATIVE(NativeProcessWait) {
+  UNIMPLEMENTED();
+  return NULL;
+}
+END_NATIVE()
+
+BEGIN_LEAF_NATIVE(NativeProcessClose) {
+  UNIMPLEMENTED();
+  return NULL;
+}
+END_NATIVE()
+
 }  // namespace dartino
 
 #endif  // !DARTINO_ENABLE_NATIVE_PROCESSES
@@ -10,9 +10,15 @@
 #include <sys/types.h>
 #include <sys/wait.h>
 #include <fcntl.h>
+#include <signal.h>
+#include <spawn.h>
 #include <stdlib.h>
 #include <unistd.h>
 
+#if defined(DARTINO_TARGET_OS_LINUX)
+#include <sys/syscall.h>
+#endif
+
 #include "src/shared/platform.h"
 #include "src/vm/natives.h"
 #include "src/vm/object.h"
@@ -296,6 +302,168 @@ BEGIN_LEAF_NATIVE(NativeProcessSpawnDetached) {
 }
 END_NATIVE()
 
+extern "C" char** environ;
+
+#if defined(DARTINO_TARGET_OS_LINUX) && !defined(SYS_pidfd_open)
+#define SYS_pidfd_open 434
+#endif
+
+// Returns a file descriptor that becomes readable when the child process
+// exits, so the exit can be waited for through the event handler without a
+// thread per child. Returns -1 where that is not supported.
+static int OpenExitDescriptor(pid_t pid) {
+#if defined(DARTINO_TARGET_OS_LINUX)
+  int fd = syscall(SYS_pidfd_open, pid, 0);
+  if (fd >= 0) fcntl(fd, F_SETFD, FD_CLOEXEC);
+  return fd;
+#else
+  return -1;
+#endif
+}
+
+static void CloseDescriptors(int* fds, int count) {
+  for (int i = 0; i < count; i++) {
+    if (fds[i] >= 0) TEMP_FAILURE_RETRY(close(fds[i]));
+  }
+}
+
+static pid_t Spawn(char* path, char* arguments[], int stdio_fds[3]) {
+  posix_spawn_file_actions_t actions;
+  posix_spawnattr_t attributes;
+  int err = posix_spawn_file_actions_init(&actions);
+  if (err != 0) {
+    errno = err;
+    return -1;
+  }
+  err = posix_spawnattr_init(&attributes);
+  if (err != 0) {
+    posix_spawn_file_actions_destroy(&actions);
+    errno = err;
+    return -1;
+  }
+
+  // Connect the pipes to stdin, stdout and stderr. The pipes are all close
+  // on exec, so the child doesn't get the other ends, and dup2 clears the
+  // flag on the new descriptors.
+  for (int i = 0; i < 3 && err == 0; i++) {
+    err = posix_spawn_file_actions_adddup2(&actions, stdio_fds[i], i);
+  }
+
+  // The calling thread has all signals blocked, and the VM ignores SIGPIPE
+  // and SIGQUIT. Don't let the child inherit that.
+  sigset_t mask;
+  sigemptyset(&mask);
+  if (err == 0) err = posix_spawnattr_setsigmask(&attributes, &mask);
+  sigaddset(&mask, SIGPIPE);
+  sigaddset(&mask, SIGQUIT);
+  if (err == 0) err = posix_spawnattr_setsigdefault(&attributes, &mask);
+  if (err == 0) {
+    err = posix_spawnattr_setflags(
+        &attributes, POSIX_SPAWN_SETSIGMASK | POSIX_SPAWN_SETSIGDEF);
+  }
+
+  pid_t pid = -1;
+  if (err == 0) {
+    err = posix_spawn(&pid, path, &actions, &attributes, arguments, environ);
+  }
+  posix_spawnattr_destroy(&attributes);
+  posix_spawn_file_actions_destroy(&actions);
+  if (err != 0) {
+    errno = err;
+    return -1;
+  }
+  return pid;
+}
+
+// Spawns a child process connected to the parent by pipes. On success the
+// non-blocking parent ends of the stdin, stdout and stderr pipes and the
+// exit descriptor are stored in the int32 array passed as second argument.
+BEGIN_LEAF_NATIVE(NativeProcessSpawn) {
+  word array = AsForeignWord(arguments[0]);
+  word result = AsForeignWord(arguments[1]);
+  if (array == 0 || result == 0) return Failure::illegal_state();
+  char** args = reinterpret_cast<char**>(array);
+  char* path = args[0];
+  if (path == NULL) return Failure::illegal_state();
+
+  // The parent ends are stdin[1], stdout[0] and stderr[0].
+  int pipes[6] = {-1, -1, -1, -1, -1, -1};
+  for (int i = 0; i < 3; i++) {
+    if (CreatePipes(pipes + 2 * i) < 0) {
+      int tmp_errno = errno;
+      CloseDescriptors(pipes, 6);
+      errno = tmp_errno;
+      return process->ToInteger(-1);
+    }
+  }
+
+  int child_fds[3] = {pipes[0], pipes[3], pipes[5]};
+  int parent_fds[3] = {pipes[1], pipes[2], pipes[4]};
+  pid_t pid = Spawn(path, args, child_fds);
+  int tmp_errno = errno;
+  CloseDescriptors(child_fds, 3);
+  if (pid < 0) {
+    CloseDescriptors(parent_fds, 3);
+    errno = tmp_errno;
+    return process->ToInteger(-1);
+  }
+
+  int32* fds = reinterpret_cast<int32*>(result);
+  for (int i = 0; i < 3; i++) {
+    int flags = fcntl(parent_fds[i], F_GETFL);
+    fcntl(parent_fds[i], F_SETFL, flags | O_NONBLOCK);
+    fds[i] = parent_fds[i];
+  }
+  fds[3] = OpenExitDescriptor(pid);
+  return process->ToInteger(pid);
+}
+END_NATIVE()
+
+// Returns the exit code for a waitpid status, or minus the signal number if
+// the child was killed by a signal.
+static int ExitCode(int status) {
+  return WIFEXITED(status) ? WEXITSTATUS(status) : -WTERMSIG(status);
+}
+
+// Reaps the child process if it has exited, and closes its exit descriptor.
+// The exit descriptor is also closed if waiting fails. Returns the exit code,
+// or null if the child is still running.
+BEGIN_LEAF_NATIVE(NativeProcessWait) {
+  if (!arguments[0]->IsSmi() || !arguments[1]->IsSmi()) {
+    return Failure::wrong_argument_type();
+  }
+  pid_t pid = Smi::cast(arguments[0])->value();
+  int exit_fd = Smi::cast(arguments[1])->value();
+  int status;
+  pid_t result = TEMP_FAILURE_RETRY(waitpid(pid, &status, WNOHANG));
+  if (result == 0) return process->program()->null_object();
+  if (exit_fd >= 0) TEMP_FAILURE_RETRY(close(exit_fd));
+  if (result < 0) return Failure::illegal_state();
+  return Smi::FromWord(ExitCode(status));
+}
+END_NATIVE()
+
+// Closes the exit descriptor and reaps the child process, killing it first if
+// it is still running. Returns the exit code like NativeProcessWait.
+BEGIN_LEAF_NATIVE(NativeProcessClose) {
+  if (!arguments[0]->IsSmi() || !arguments[1]->IsSmi()) {
+    return Failure::wrong_argument_type();
+  }
+  pid_t pid = Smi::cast(arguments[0])->value();
+  int exit_fd = Smi::cast(arguments[1])->value();
+  if (exit_fd >= 0) TEMP_FAILURE_RETRY(close(exit_fd));
+  int status;
+  pid_t result = TEMP_FAILURE_RETRY(waitpid(pid, &status, WNOHANG));
+  if (result == 0) {
+    // A killed child exits promptly, so the blocking wait is short.
+    kill(pid, SIGKILL);
+    result = TEMP_FAILURE_RETRY(waitpid(pid, &status, 0));
+  }
+  if (result < 0) return Failure::illegal_state();
+  return Smi::FromWord(ExitCode(status));
+}
+END_NATIVE()
+
 }  // namespace dartino
 
 #endif  // DARTINO_TARGET_OS_POSIX
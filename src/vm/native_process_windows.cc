@@ -105,6 +105,22 @@ BEGIN_LEAF_NATIVE(NativeProcessSpawnDetached) {
 }
 END_NATIVE()
 
+// Spawning processes with pipes is not supported on Windows yet.
+BEGIN_LEAF_NATIVE(NativeProcessSpawn) {
+  return Failure::illegal_state();
+}
+END_NATIVE()
+
+BEGIN_LEAF_NATIVE(NativeProcessWait) {
+  return Failure::illegal_state();
+}
+END_NATIVE()
+
+BEGIN_LEAF_NATIVE(NativeProcessClose) {
+  return Failure::illegal_state();
+}
+END_NATIVE()
+
 }  // namespace dartino
 
 #endif  // defined(DARTINO_TARGET_OS_WIN)
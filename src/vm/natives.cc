@@ -14,9 +14,12 @@
 #include "src/shared/selectors.h"
 #include "src/shared/platform.h"
 
+#include "src/vm/constant_map_index.h"
 #include "src/vm/event_handler.h"
 #include "src/vm/interpreter.h"
+#include "src/vm/metrics.h"
 #include "src/vm/native_interpreter.h"
+#include "src/vm/number_conversion.h"
 #include "src/vm/port.h"
 #include "src/vm/process.h"
 #include "src/vm/scheduler.h"
@@ -74,11 +77,22 @@ BEGIN_LEAF_NATIVE(IntParse) {
   Object* x = arguments[0];
   Object* y = arguments[1];
   if (!y->IsSmi()) return Failure::wrong_argument_type();
+  Smi* radix = Smi::cast(y);
+  // Fast path: parse plain one-byte strings in place without copying them.
+  if (x->IsOneByteString()) {
+    OneByteString* source = OneByteString::cast(x);
+    int64 result;
+    if (NumberConversion::TryParseInt(source->byte_address_for(0),
+                                      source->length(), radix->value(),
+                                      &result)) {
+      return process->ToInteger(result);
+    }
+  }
   char* chars = AsForeignString(x);
   if (chars == NULL) return Failure::wrong_argument_type();
   int length = strlen(chars);
-  Smi* radix = Smi::cast(y);
   char* end = chars;
+  errno = 0;
   int64 result = strtoll(chars, &end, radix->value());
   bool error = (end != chars + length) || (errno == ERANGE);
   free(chars);
@@ -706,41 +720,10 @@ BEGIN_LEAF_NATIVE(DoubleToInt) {
 END_NATIVE()
 
 BEGIN_LEAF_NATIVE(DoubleToString) {
-  static const int kDecimalLow = -6;
-  static const int kDecimalHigh = 21;
-  static const int kBufferSize = 128;
-
   Double* d = Double::cast(arguments[0]);
-  char buffer[kBufferSize] = {'\0'};
-
-  // The output contains the sign, at most kDecimalHigh - 1 digits,
-  // the decimal point followed by a 0 plus the \0.
-  ASSERT(kBufferSize >= 1 + (kDecimalHigh - 1) + 1 + 1 + 1);
-  // Or it contains the sign, a 0, the decimal point, kDecimalLow '0's,
-  // 17 digits (the precision needed for doubles), plus the \0.
-  ASSERT(kBufferSize >= 1 + 1 + 1 + kDecimalLow + 17 + 1);
-  // Alternatively it contains a sign, at most 17 digits (precision needed for
-  // any double), the decimal point, the exponent character, the exponent's
-  // sign, at most three exponent digits, plus the \0.
-  ASSERT(kBufferSize >= 1 + 17 + 1 + 1 + 1 + 3 + 1);
-
-  static const int kConversionFlags =
-      double_conversion::DoubleToStringConverter::EMIT_POSITIVE_EXPONENT_SIGN |
-      double_conversion::DoubleToStringConverter::EMIT_TRAILING_DECIMAL_POINT |
-      double_conversion::DoubleToStringConverter::
-          EMIT_TRAILING_ZERO_AFTER_POINT;
-
-  const double_conversion::DoubleToStringConverter converter(
-      kConversionFlags, kDoubleInfinitySymbol, kDoubleNaNSymbol,
-      kDoubleExponentChar, kDecimalLow, kDecimalHigh, 0,
-      0);  // Last two values are ignored in shortest mode.
-
-  double_conversion::StringBuilder builder(buffer, kBufferSize);
-  bool status = converter.ToShortest(d->value(), &builder);
-  ASSERT(status);
-  char* result = builder.Finalize();
-  ASSERT(result == buffer);
-  return process->NewStringFromAscii(List<const char>(result, strlen(result)));
+  char buffer[NumberConversion::kShortestBufferSize];
+  int length = NumberConversion::DoubleToShortest(d->value(), buffer);
+  return process->NewStringFromAscii(List<const char>(buffer, length));
 }
 END_NATIVE()
 
@@ -774,12 +757,18 @@ BEGIN_NATIVE(DoubleToStringAsFixed) {
   int digits = Smi::cast(arguments[1])->value();
   ASSERT(0 <= digits && digits <= 20);
 
+  char buffer[kBufferSize] = {'\0'};
+  ASSERT(kBufferSize >= NumberConversion::kShortestBufferSize + 20);
+  int length = NumberConversion::IntegralDoubleToFixed(d, digits, buffer);
+  if (length >= 0) {
+    return process->NewStringFromAscii(List<const char>(buffer, length));
+  }
+
   const double_conversion::DoubleToStringConverter converter(
       double_conversion::DoubleToStringConverter::NO_FLAGS,
       kDoubleInfinitySymbol, kDoubleNaNSymbol, kDoubleExponentChar, 0, 0, 0,
       0);  // Last four values are ignored in fixed mode.
 
-  char buffer[kBufferSize] = {'\0'};
   double_conversion::StringBuilder builder(buffer, kBufferSize);
   bool status = converter.ToFixed(d, digits, &builder);
   ASSERT(status);
@@ -817,7 +806,17 @@ END_NATIVE()
 BEGIN_LEAF_NATIVE(DoubleParse) {
   Object* x = arguments[0];
 
-  // We trim in Dart to handle all the whitespaces.
+  // We trim in Dart to handle all the whitespaces. Short decimal literals,
+  // the common case, are converted exactly without double-conversion.
+  if (x->IsOneByteString()) {
+    OneByteString* source = OneByteString::cast(x);
+    double result;
+    if (NumberConversion::TryParseDouble(source->byte_address_for(0),
+                                         source->length(), &result)) {
+      return process->NewDouble(result);
+    }
+  }
+
   static const int kConversionFlags =
       double_conversion::StringToDoubleConverter::NO_FLAGS;
 
@@ -929,6 +928,20 @@ BEGIN_LEAF_NATIVE(ByteListIndexGet) {
 }
 END_NATIVE()
 
+BEGIN_LEAF_NATIVE(ConstantMapIndexOf) {
+  Instance* map = Instance::cast(arguments[0]);
+  Object* index = map->GetInstanceField(2);
+  if (!index->IsArray()) return Failure::wrong_argument_type();
+  Instance* keys = Instance::cast(map->GetInstanceField(0));
+  int position = ConstantMapIndex::Lookup(
+      Array::cast(keys->GetInstanceField(0)), Array::cast(index), arguments[1]);
+  if (position == ConstantMapIndex::kUnsupportedKey) {
+    return Failure::wrong_argument_type();
+  }
+  return Smi::FromWord(position);
+}
+END_NATIVE()
+
 BEGIN_LEAF_NATIVE(ListIndexSet) {
   Object* list = Instance::cast(arguments[0])->GetInstanceField(0);
   Array* array = Array::cast(list);
@@ -979,11 +992,13 @@ static Function* FunctionForClosure(Object* argument, unsigned arity) {
 
 static Process* SpawnProcessInternal(Program* program, Process* process,
                                      Instance* entrypoint, Instance* closure,
-                                     Object* argument) {
+                                     Object* argument, int initial_stack_size,
+                                     int max_stack_size) {
   Function* entry = FunctionForClosure(entrypoint, 2);
   ASSERT(entry != NULL);
 
-  Process* child = program->SpawnProcess(process);
+  Process* child =
+      program->SpawnProcess(process, initial_stack_size, max_stack_size);
   if (child == NULL) return NULL;
 
   Stack* stack = child->stack();
@@ -1021,6 +1036,8 @@ BEGIN_LEAF_NATIVE(ProcessSpawn) {
   bool link_to_child = arguments[3] == program->true_object();
   bool link_from_child = arguments[4] == program->true_object();
   Object* dart_monitor_port = arguments[5];
+  Object* dart_initial_stack_size = arguments[6];
+  Object* dart_max_stack_size = arguments[7];
   Port* monitor_port = NULL;
   if (!dart_monitor_port->IsNull()) {
     if (!dart_monitor_port->IsPort()) {
@@ -1045,17 +1062,41 @@ BEGIN_LEAF_NATIVE(ProcessSpawn) {
     return Failure::index_out_of_bounds();
   }
 
+  // Null stack sizes select the defaults.
+  word initial_stack_size = 0;
+  if (!dart_initial_stack_size->IsNull()) {
+    if (!dart_initial_stack_size->IsSmi()) {
+      return Failure::wrong_argument_type();
+    }
+    initial_stack_size = Smi::cast(dart_initial_stack_size)->value();
+    if (initial_stack_size < Process::kMinStackSize ||
+        initial_stack_size > Smi::kMaxPortableValue) {
+      return Failure::index_out_of_bounds();
+    }
+  }
+  word max_stack_size = 0;
+  if (!dart_max_stack_size->IsNull()) {
+    if (!dart_max_stack_size->IsSmi()) return Failure::wrong_argument_type();
+    max_stack_size = Smi::cast(dart_max_stack_size)->value();
+    if (max_stack_size < Process::kMinStackSize ||
+        max_stack_size > Smi::kMaxPortableValue) {
+      return Failure::index_out_of_bounds();
+    }
+  }
+
   Object* dart_process = process->NewInstance(program->process_class(), true);
   if (dart_process->IsRetryAfterGCFailure()) return dart_process;
 
   Process* child =
-      SpawnProcessInternal(program, process, entrypoint, closure, argument);
+      SpawnProcessInternal(program, process, entrypoint, closure, argument,
+                           initial_stack_size, max_stack_size);
 
   if (child == NULL) {
+    if (initial_stack_size == 0) initial_stack_size = Flags::initial_stack_size;
     // TODO(erikcorry): Somehow collect this information instead of trying to
     // remember all allocations here.
     return Failure::retry_after_gc(
-        Stack::AllocationSize(Process::kInitialStackSize) + Coroutine::kSize +
+        Stack::AllocationSize(initial_stack_size) + Coroutine::kSize +
         Array::AllocationSize(program->static_fields()->length()));
   }
 
@@ -1098,11 +1139,20 @@ END_NATIVE()
 BEGIN_LEAF_NATIVE(CoroutineCurrent) { return process->coroutine(); }
 END_NATIVE()
 
+BEGIN_LEAF_NATIVE(CoroutineExit) {
+  // The current coroutine belongs to a fiber that exits and will never be
+  // resumed, but it stays alive until the fiber changes to another one.
+  process->coroutines()->Remove(process->coroutine());
+  return process->program()->null_object();
+}
+END_NATIVE()
+
 BEGIN_LEAF_NATIVE(CoroutineNewStack) {
   Object* object = process->NewStack(256);
   if (object->IsFailure()) return object;
   Instance* coroutine = Instance::cast(arguments[0]);
   Instance* entry = Instance::cast(arguments[1]);
+  process->coroutines()->Add(Coroutine::cast(coroutine));
 
   // TODO(kasperl): Avoid repeated lookups. Cache the start
   // function in the program?
@@ -1494,6 +1544,85 @@ BEGIN_LEAF_NATIVE(IsImmutable) {
 }
 END_NATIVE()
 
+BEGIN_LEAF_NATIVE(StringIntern) {
+  Object* x = arguments[0];
+  if (x->IsOneByteString()) {
+    return process->program()->intern_table()->Intern(OneByteString::cast(x));
+  }
+  // Two-byte strings are rare as keys and are not interned.
+  if (x->IsTwoByteString()) return x;
+  return Failure::wrong_argument_type();
+}
+END_NATIVE()
+
+BEGIN_NATIVE(VmMetrics) {
+  int length = Metrics::Format(NULL, 0);
+  char* buffer = static_cast<char*>(malloc(length + 1));
+  length = Utils::Minimum(Metrics::Format(buffer, length + 1), length);
+  Object* result =
+      process->NewStringFromAscii(List<const char>(buffer, length));
+  free(buffer);
+  return result;
+}
+END_NATIVE()
+
+// The nodes of the persistent collections in dart:dartino are immutable
+// instances with kPersistentNodeWidth fields, indexed by kPersistentNodeBits
+// bits of the hash or index at a time.
+static const int kPersistentNodeBits = 3;
+static const int kPersistentNodeWidth = 1 << kPersistentNodeBits;
+static const int kPersistentNodeMask = kPersistentNodeWidth - 1;
+
+static bool IsPersistentNode(Object* object) {
+  return object->IsInstance() &&
+         Instance::cast(object)->get_class()->NumberOfInstanceFields() ==
+             kPersistentNodeWidth;
+}
+
+BEGIN_LEAF_NATIVE(PersistentMapLookup) {
+  Object* root = arguments[0];
+  Object* hash_object = arguments[1];
+  if (!IsPersistentNode(root) || !hash_object->IsSmi()) {
+    return Failure::wrong_argument_type();
+  }
+  // Follow the hash until the path leaves the trie. Whatever is found there,
+  // an entry chain or null, is checked for the key in Dart.
+  Class* node_class = Instance::cast(root)->get_class();
+  word hash = Smi::cast(hash_object)->value();
+  Object* current = root;
+  while (true) {
+    int index = hash & kPersistentNodeMask;
+    current = Instance::cast(current)->GetInstanceField(index);
+    if (!current->IsInstance() ||
+        Instance::cast(current)->get_class() != node_class) {
+      return current;
+    }
+    hash >>= kPersistentNodeBits;
+  }
+}
+END_NATIVE()
+
+BEGIN_LEAF_NATIVE(PersistentVectorLookup) {
+  Object* root = arguments[0];
+  Object* shift_object = arguments[1];
+  Object* index_object = arguments[2];
+  if (!IsPersistentNode(root) || !shift_object->IsSmi() ||
+      !index_object->IsSmi()) {
+    return Failure::wrong_argument_type();
+  }
+  // The caller has checked the index against the length, so all nodes on
+  // the path are present.
+  word index = Smi::cast(index_object)->value();
+  Instance* node = Instance::cast(root);
+  for (word shift = Smi::cast(shift_object)->value(); shift > 0;
+       shift -= kPersistentNodeBits) {
+    int slot = (index >> shift) & kPersistentNodeMask;
+    node = Instance::cast(node->GetInstanceField(slot));
+  }
+  return node->GetInstanceField(index & kPersistentNodeMask);
+}
+END_NATIVE()
+
 BEGIN_LEAF_NATIVE(Uint32DigitsAllocate) {
   Smi* length = Smi::cast(arguments[0]);
   word byte_size = length->value() * 4;
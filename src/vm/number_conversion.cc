@@ -0,0 +1,269 @@
+// Copyright (c) 2016, the Dartino project authors. Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE.md file.
+
+#include "src/vm/number_conversion.h"
+
+#include <math.h>
+#include <string.h>
+
+#include "src/shared/assert.h"
+
+#include "third_party/double-conversion/src/double-conversion.h"
+
+namespace dartino {
+
+// The range of decimal exponents printed without exponential notation by
+// double.toString().
+static const int kDecimalLow = -6;
+static const int kDecimalHigh = 21;
+
+// Doubles below 2^53 that are integral are exact integers, so their shortest
+// representation is simply their digits.
+static const double kTwoToThe53 = 9007199254740992.0;
+static const uint64 kMaxExactSignificand = static_cast<uint64>(1) << 53;
+
+// The largest number of significant decimal digits that always fits in a
+// uint64.
+static const int kMaxSignificantDigits = 19;
+
+static const double kExactPowersOfTen[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+};
+static const int kMaxExactPowerOfTen = ARRAY_SIZE(kExactPowersOfTen) - 1;
+
+static int WriteString(const char* string, char* buffer) {
+  int length = strlen(string);
+  memcpy(buffer, string, length);
+  return length;
+}
+
+static int WriteUnsigned(uint64 value, char* buffer) {
+  char digits[20];
+  int count = 0;
+  do {
+    digits[count++] = '0' + static_cast<char>(value % 10);
+    value /= 10;
+  } while (value != 0);
+  for (int i = 0; i < count; i++) buffer[i] = digits[count - 1 - i];
+  return count;
+}
+
+static int WritePadding(char c, int count, char* buffer) {
+  for (int i = 0; i < count; i++) buffer[i] = c;
+  return count > 0 ? count : 0;
+}
+
+static bool IsIntegralBelowTwoToThe53(double value) {
+  return value < kTwoToThe53 && value == floor(value);
+}
+
+int NumberConversion::DoubleToShortest(double value, char* buffer) {
+  if (isnan(value)) return WriteString("NaN", buffer);
+
+  int pos = 0;
+  if (signbit(value)) {
+    buffer[pos++] = '-';
+    value = -value;
+  }
+  if (isinf(value)) return pos + WriteString("Infinity", buffer + pos);
+
+  if (IsIntegralBelowTwoToThe53(value)) {
+    pos += WriteUnsigned(static_cast<uint64>(value), buffer + pos);
+    buffer[pos++] = '.';
+    buffer[pos++] = '0';
+    return pos;
+  }
+
+  const int kDigitsCapacity =
+      double_conversion::DoubleToStringConverter::kBase10MaximalLength + 1;
+  char digits[kDigitsCapacity];
+  bool sign;
+  int length;
+  int point;
+  double_conversion::DoubleToStringConverter::DoubleToAscii(
+      value, double_conversion::DoubleToStringConverter::SHORTEST, 0, digits,
+      kDigitsCapacity, &sign, &length, &point);
+  ASSERT(!sign);
+
+  int exponent = point - 1;
+  if (kDecimalLow <= exponent && exponent < kDecimalHigh) {
+    if (point <= 0) {
+      // "0.000digits".
+      buffer[pos++] = '0';
+      buffer[pos++] = '.';
+      pos += WritePadding('0', -point, buffer + pos);
+      memcpy(buffer + pos, digits, length);
+      pos += length;
+    } else if (point >= length) {
+      // "digits000.0".
+      memcpy(buffer + pos, digits, length);
+      pos += length;
+      pos += WritePadding('0', point - length, buffer + pos);
+      buffer[pos++] = '.';
+      buffer[pos++] = '0';
+    } else {
+      // "dig.its".
+      memcpy(buffer + pos, digits, point);
+      pos += point;
+      buffer[pos++] = '.';
+      memcpy(buffer + pos, digits + point, length - point);
+      pos += length - point;
+    }
+  } else {
+    // "d.igitse+123".
+    buffer[pos++] = digits[0];
+    if (length != 1) {
+      buffer[pos++] = '.';
+      memcpy(buffer + pos, digits + 1, length - 1);
+      pos += length - 1;
+    }
+    buffer[pos++] = 'e';
+    if (exponent < 0) {
+      buffer[pos++] = '-';
+      exponent = -exponent;
+    } else {
+      buffer[pos++] = '+';
+    }
+    pos += WriteUnsigned(exponent, buffer + pos);
+  }
+  ASSERT(pos <= kShortestBufferSize);
+  return pos;
+}
+
+int NumberConversion::IntegralDoubleToFixed(double value, int digits,
+                                            char* buffer) {
+  if (isnan(value)) return -1;
+  int pos = 0;
+  if (signbit(value)) {
+    buffer[pos++] = '-';
+    value = -value;
+  }
+  if (!IsIntegralBelowTwoToThe53(value)) return -1;
+  pos += WriteUnsigned(static_cast<uint64>(value), buffer + pos);
+  if (digits > 0) {
+    buffer[pos++] = '.';
+    pos += WritePadding('0', digits, buffer + pos);
+  }
+  return pos;
+}
+
+static bool IsDecimalDigit(uint8 c) { return c >= '0' && c <= '9'; }
+
+bool NumberConversion::TryParseDouble(const uint8* chars, int length,
+                                      double* result) {
+  int pos = 0;
+  bool negative = false;
+  if (pos < length && (chars[pos] == '+' || chars[pos] == '-')) {
+    negative = chars[pos++] == '-';
+  }
+
+  // Accumulate the significant digits, ignoring leading zeros, and keep
+  // track of the decimal exponent that applies to them.
+  uint64 significand = 0;
+  int significant_digits = 0;
+  int exponent = 0;
+  bool seen_digit = false;
+  while (pos < length && IsDecimalDigit(chars[pos])) {
+    int digit = chars[pos++] - '0';
+    seen_digit = true;
+    if (significand == 0 && digit == 0) continue;
+    if (significant_digits == kMaxSignificantDigits) return false;
+    significand = significand * 10 + digit;
+    significant_digits++;
+  }
+  if (pos < length && chars[pos] == '.') {
+    pos++;
+    while (pos < length && IsDecimalDigit(chars[pos])) {
+      int digit = chars[pos++] - '0';
+      seen_digit = true;
+      exponent--;
+      if (significand == 0 && digit == 0) continue;
+      if (significant_digits == kMaxSignificantDigits) return false;
+      significand = significand * 10 + digit;
+      significant_digits++;
+    }
+  }
+  if (!seen_digit) return false;
+
+  if (pos < length && (chars[pos] == 'e' || chars[pos] == 'E')) {
+    pos++;
+    bool negative_exponent = false;
+    if (pos < length && (chars[pos] == '+' || chars[pos] == '-')) {
+      negative_exponent = chars[pos++] == '-';
+    }
+    int explicit_exponent = 0;
+    bool seen_exponent_digit = false;
+    while (pos < length && IsDecimalDigit(chars[pos])) {
+      // Clamp huge exponents; they are rejected below anyway.
+      if (explicit_exponent < 10000) {
+        explicit_exponent = explicit_exponent * 10 + (chars[pos] - '0');
+      }
+      seen_exponent_digit = true;
+      pos++;
+    }
+    if (!seen_exponent_digit) return false;
+    exponent += negative_exponent ? -explicit_exponent : explicit_exponent;
+  }
+  if (pos != length) return false;
+
+  if (significand == 0) {
+    *result = negative ? -0.0 : 0.0;
+    return true;
+  }
+  if (significand > kMaxExactSignificand) return false;
+
+  double value;
+  if (exponent < 0) {
+    if (exponent < -kMaxExactPowerOfTen) return false;
+    value = static_cast<double>(significand) / kExactPowersOfTen[-exponent];
+  } else if (exponent <= kMaxExactPowerOfTen) {
+    value = static_cast<double>(significand) * kExactPowersOfTen[exponent];
+  } else {
+    // Move the excess powers of ten into the significand as long as it
+    // stays exact, e.g., for 1e30.
+    for (; exponent > kMaxExactPowerOfTen; exponent--) {
+      significand *= 10;
+      if (significand > kMaxExactSignificand) return false;
+    }
+    value = static_cast<double>(significand) * kExactPowersOfTen[exponent];
+  }
+  *result = negative ? -value : value;
+  return true;
+}
+
+bool NumberConversion::TryParseInt(const uint8* chars, int length, int radix,
+                                   int64* result) {
+  ASSERT(radix >= 2 && radix <= 36);
+  int pos = 0;
+  bool negative = false;
+  if (pos < length && (chars[pos] == '+' || chars[pos] == '-')) {
+    negative = chars[pos++] == '-';
+  }
+  if (pos == length) return false;
+
+  uint64 limit = static_cast<uint64>(INT64_MAX) + (negative ? 1 : 0);
+  uint64 magnitude = 0;
+  for (; pos < length; pos++) {
+    uint8 c = chars[pos];
+    int digit;
+    if (c >= '0' && c <= '9') {
+      digit = c - '0';
+    } else if (c >= 'a' && c <= 'z') {
+      digit = c - 'a' + 10;
+    } else if (c >= 'A' && c <= 'Z') {
+      digit = c - 'A' + 10;
+    } else {
+      return false;
+    }
+    if (digit >= radix) return false;
+    if (magnitude > (limit - digit) / radix) return false;
+    magnitude = magnitude * radix + digit;
+  }
+  *result = negative ? static_cast<int64>(0 - magnitude)
+                     : static_cast<int64>(magnitude);
+  return true;
+}
+
+}  // namespace dartino
@@ -0,0 +1,49 @@
+// Copyright (c) 2016, the Dartino project authors. Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE.md file.
+
+#ifndef SRC_VM_NUMBER_CONVERSION_H_
+#define SRC_VM_NUMBER_CONVERSION_H_
+
+#include "src/shared/globals.h"
+
+namespace dartino {
+
+// Fast paths for the number formatting and parsing natives. Only the common
+// cases are handled here; everything else is left to double-conversion, which
+// stays the reference implementation.
+class NumberConversion {
+ public:
+  // Large enough for any result of DoubleToShortest: a sign, 17 digits, up
+  // to 5 padding zeros, the decimal point, and an exponent of the form
+  // "e+308", or an integral value below 1e21 with a ".0" suffix.
+  static const int kShortestBufferSize = 32;
+
+  // Writes the shortest representation of [value] that reads back as the
+  // same double, formatted as Dart's double.toString(). Returns the number
+  // of characters written. The result is not null terminated.
+  static int DoubleToShortest(double value, char* buffer);
+
+  // Writes [value] with [digits] digits after the decimal point if [value] is
+  // integral and exactly representable as an int64. Returns the number of
+  // characters written or -1 if [value] needs the general algorithm. The
+  // buffer must hold at least kShortestBufferSize + [digits] characters.
+  static int IntegralDoubleToFixed(double value, int digits, char* buffer);
+
+  // Parses a trimmed decimal string of at most 19 significant digits whose
+  // value can be computed exactly with a single floating-point operation
+  // (Clinger's fast path). Returns false if the input is not in that form;
+  // the caller must then fall back to the general parser, which also decides
+  // whether the input is malformed.
+  static bool TryParseDouble(const uint8* chars, int length, double* result);
+
+  // Parses an optionally signed integer in [radix] without a prefix. Returns
+  // false on anything unusual, including overflow, in which case the caller
+  // must fall back to the general parser.
+  static bool TryParseInt(const uint8* chars, int length, int radix,
+                          int64* result);
+};
+
+}  // namespace dartino
+
+#endif  // SRC_VM_NUMBER_CONVERSION_H_
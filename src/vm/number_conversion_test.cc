@@ -0,0 +1,123 @@
+// Copyright (c) 2016, the Dartino project authors. Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE.md file.
+
+#include <math.h>
+#include <string.h>
+
+#include "src/shared/assert.h"
+#include "src/shared/test_case.h"
+
+#include "src/vm/number_conversion.h"
+
+namespace dartino {
+
+static void ExpectShortest(const char* expected, double value) {
+  char buffer[NumberConversion::kShortestBufferSize];
+  int length = NumberConversion::DoubleToShortest(value, buffer);
+  EXPECT_EQ(static_cast<int>(strlen(expected)), length);
+  EXPECT_EQ(0, strncmp(expected, buffer, length));
+}
+
+static void ExpectParsedDouble(double expected, const char* input) {
+  double result = 0.0;
+  EXPECT(NumberConversion::TryParseDouble(
+      reinterpret_cast<const uint8*>(input), strlen(input), &result));
+  EXPECT_EQ(expected, result);
+}
+
+static void ExpectNoFastDouble(const char* input) {
+  double result = 0.0;
+  EXPECT(!NumberConversion::TryParseDouble(
+      reinterpret_cast<const uint8*>(input), strlen(input), &result));
+}
+
+static void ExpectParsedInt(int64 expected, const char* input, int radix) {
+  int64 result = 0;
+  EXPECT(NumberConversion::TryParseInt(reinterpret_cast<const uint8*>(input),
+                                       strlen(input), radix, &result));
+  EXPECT_EQ(expected, result);
+}
+
+static void ExpectNoFastInt(const char* input, int radix) {
+  int64 result = 0;
+  EXPECT(!NumberConversion::TryParseInt(reinterpret_cast<const uint8*>(input),
+                                        strlen(input), radix, &result));
+}
+
+TEST_CASE(DoubleToShortest) {
+  ExpectShortest("0.0", 0.0);
+  ExpectShortest("-0.0", -0.0);
+  ExpectShortest("42.0", 42.0);
+  ExpectShortest("-1.5", -1.5);
+  ExpectShortest("0.1", 0.1);
+  ExpectShortest("0.30000000000000004", 0.1 + 0.2);
+  ExpectShortest("0.000001", 1e-6);
+  ExpectShortest("1e-7", 1e-7);
+  ExpectShortest("9007199254740992.0", 9007199254740992.0);
+  ExpectShortest("100000000000000000000.0", 1e20);
+  ExpectShortest("1e+21", 1e21);
+  ExpectShortest("1.7976931348623157e+308", 1.7976931348623157e308);
+  ExpectShortest("5e-324", 5e-324);
+  ExpectShortest("NaN", NAN);
+  ExpectShortest("Infinity", INFINITY);
+  ExpectShortest("-Infinity", -INFINITY);
+}
+
+TEST_CASE(IntegralDoubleToFixed) {
+  char buffer[NumberConversion::kShortestBufferSize + 20];
+  int length = NumberConversion::IntegralDoubleToFixed(3.0, 2, buffer);
+  EXPECT_EQ(4, length);
+  EXPECT_EQ(0, strncmp("3.00", buffer, length));
+  length = NumberConversion::IntegralDoubleToFixed(-12.0, 0, buffer);
+  EXPECT_EQ(3, length);
+  EXPECT_EQ(0, strncmp("-12", buffer, length));
+  EXPECT_EQ(-1, NumberConversion::IntegralDoubleToFixed(1.5, 2, buffer));
+  EXPECT_EQ(-1, NumberConversion::IntegralDoubleToFixed(1e300, 2, buffer));
+}
+
+TEST_CASE(TryParseDouble) {
+  ExpectParsedDouble(0.0, "0");
+  ExpectParsedDouble(1.5, "1.5");
+  ExpectParsedDouble(-1.5, "-1.5");
+  ExpectParsedDouble(0.5, ".5");
+  ExpectParsedDouble(5.0, "5.");
+  ExpectParsedDouble(0.1, "0.1");
+  ExpectParsedDouble(1e-5, "1.0e-5");
+  ExpectParsedDouble(1.5e30, "15E29");
+  ExpectParsedDouble(123456.789, "123456.789");
+  double zero = 1.0;
+  EXPECT(NumberConversion::TryParseDouble(reinterpret_cast<const uint8*>("-0"),
+                                          2, &zero));
+  EXPECT(signbit(zero));
+
+  ExpectNoFastDouble("");
+  ExpectNoFastDouble(".");
+  ExpectNoFastDouble("1e");
+  ExpectNoFastDouble("1x");
+  ExpectNoFastDouble("Infinity");
+  ExpectNoFastDouble("9007199254740993");
+  ExpectNoFastDouble("12345678901234567890");
+  ExpectNoFastDouble("1e-23");
+  ExpectNoFastDouble("1e400");
+}
+
+TEST_CASE(TryParseInt) {
+  ExpectParsedInt(0, "0", 10);
+  ExpectParsedInt(-42, "-42", 10);
+  ExpectParsedInt(42, "+42", 10);
+  ExpectParsedInt(255, "ff", 16);
+  ExpectParsedInt(255, "FF", 16);
+  ExpectParsedInt(35, "z", 36);
+  ExpectParsedInt(INT64_MAX, "9223372036854775807", 10);
+  ExpectParsedInt(INT64_MIN, "-9223372036854775808", 10);
+
+  ExpectNoFastInt("", 10);
+  ExpectNoFastInt("-", 10);
+  ExpectNoFastInt("0x10", 16);
+  ExpectNoFastInt("2", 2);
+  ExpectNoFastInt("9223372036854775808", 10);
+  ExpectNoFastInt("-9223372036854775809", 10);
+}
+
+}  // namespace dartino
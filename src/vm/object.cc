@@ -100,6 +100,14 @@ bool OneByteString::Equals(OneByteString* str) {
   if (this == str) return true;
   int len = str->length();
   if (length() != len) return false;
+  // Strings with different hash codes cannot be equal. The hash codes are
+  // only compared if both have already been computed.
+  word hash = hash_value();
+  word other_hash = str->hash_value();
+  if (hash != kNoHashValue && other_hash != kNoHashValue &&
+      hash != other_hash) {
+    return false;
+  }
   for (int i = 0; i < len; i++) {
     if (get_char_code(i) != str->get_char_code(i)) return false;
   }
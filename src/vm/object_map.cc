@@ -6,226 +6,239 @@
 
 namespace dartino {
 
-ObjectMap::ObjectMap(int capacity) {
-  table_by_id_ = NewTable(Utils::Maximum(capacity, 8));
-  size_ = 0;
+ObjectMap::ObjectMap(int capacity) : size_(0), deleted_by_object_(0) {
+  capacity = Utils::Maximum(capacity, 8);
+  ids_ = List<int64>::New(capacity);
+  objects_ = List<Object*>::New(capacity);
+  table_by_id_ = NewTable(Utils::RoundUpToPowerOfTwo(capacity << 1));
   ASSERT(!HasTableByObject());
 }
 
 ObjectMap::~ObjectMap() {
-  DeleteTable(table_by_id_);
-  DeleteTable(table_by_object_);
+  ids_.Delete();
+  objects_.Delete();
+  table_by_id_.Delete();
+  table_by_object_.Delete();
 }
 
 void ObjectMap::Add(int64 id, Object* object) {
-  int index = BucketIndexFromId(id);
-  Bucket* original = table_by_id_[index];
-  Bucket* current = original;
-  while (current != NULL) {
-    if (current->id == id) {
-      if (HasTableByObject() && current->object != object) {
-        Bucket* existing = DetachByObject(current->object);
-        ASSERT(existing != NULL);
-        int index = BucketIndexFromObject(object);
-        existing->next = table_by_object_[index];
-        existing->object = object;
-        table_by_object_[index] = existing;
-      }
-      current->object = object;
-      return;
+  int slot = FindSlotById(id);
+  if (slot != -1) {
+    int index = table_by_id_[slot];
+    if (objects_[index] == object) return;
+    if (HasTableByObject()) {
+      RemoveFromTableByObject(objects_[index], index);
+      objects_[index] = object;
+      AddToTableByObject(index);
+    } else {
+      objects_[index] = object;
     }
-    current = current->next;
+    return;
   }
 
-  // Expand the size and recompute the bucket index if necessary.
-  if (Expand()) index = BucketIndexFromId(id);
-
-  // Add to the bucket list.
-  Bucket* bucket = new Bucket();
-  bucket->next = original;
-  bucket->id = id;
-  bucket->object = object;
-  table_by_id_[index] = bucket;
-  if (HasTableByObject()) AddToTableByObject(id, object);
+  if (static_cast<int>(size_) == ids_.length()) Expand();
+  int index = size_++;
+  ids_[index] = id;
+  objects_[index] = object;
+  AddToTableById(index);
+  if (HasTableByObject()) AddToTableByObject(index);
 }
 
 bool ObjectMap::RemoveById(int64 id) {
-  Bucket* bucket = DetachById(id);
-  if (bucket == NULL) return false;
-  if (HasTableByObject()) delete DetachByObject(bucket->object);
-  delete bucket;
-  size_--;
+  int slot = FindSlotById(id);
+  if (slot == -1) return false;
+  RemoveEntry(table_by_id_[slot]);
   return true;
 }
 
 bool ObjectMap::RemoveByObject(Object* object) {
   PopulateTableByObject();
-  Bucket* bucket = DetachByObject(object);
-  if (bucket == NULL) return false;
-  delete DetachById(bucket->id);
-  delete bucket;
-  size_--;
-  return true;
+  int slot = HashObject(object) & mask();
+  while (true) {
+    int index = table_by_object_[slot];
+    if (index == kEmpty) return false;
+    if (index != kDeleted && objects_[index] == object) {
+      RemoveEntry(index);
+      return true;
+    }
+    slot = (slot + 1) & mask();
+  }
 }
 
 Object* ObjectMap::LookupById(int64 id, bool* entry_exists) {
-  int index = BucketIndexFromId(id);
-  Bucket* current = table_by_id_[index];
-  while (current != NULL) {
-    if (current->id == id) {
-      if (entry_exists != NULL) *entry_exists = true;
-      return current->object;
-    }
-    current = current->next;
-  }
-  if (entry_exists != NULL) *entry_exists = false;
-  return NULL;
+  int slot = FindSlotById(id);
+  if (entry_exists != NULL) *entry_exists = slot != -1;
+  if (slot == -1) return NULL;
+  return objects_[table_by_id_[slot]];
 }
 
 int64 ObjectMap::LookupByObject(Object* object, int64 none) {
   PopulateTableByObject();
-  int index = BucketIndexFromObject(object);
-  Bucket* current = table_by_object_[index];
-  while (current != NULL) {
-    if (current->object == object) return current->id;
-    current = current->next;
+  int slot = HashObject(object) & mask();
+  while (true) {
+    int index = table_by_object_[slot];
+    if (index == kEmpty) return none;
+    if (index != kDeleted && objects_[index] == object) return ids_[index];
+    slot = (slot + 1) & mask();
   }
-  return none;
 }
 
 void ObjectMap::ClearTableByObject() {
-  DeleteTable(table_by_object_);
-  table_by_object_ = List<Bucket*>();
+  table_by_object_.Delete();
+  deleted_by_object_ = 0;
   ASSERT(!HasTableByObject());
 }
 
 void ObjectMap::IteratePointers(PointerVisitor* visitor) {
-  ASSERT(!HasTableByObject());
-  for (int i = 0; i < table_by_id_.length(); i++) {
-    Bucket* current = table_by_id_[i];
-    while (current != NULL) {
-      visitor->Visit(&current->object);
-      current = current->next;
+  int size = static_cast<int>(size_);
+  if (!HasTableByObject()) {
+    visitor->VisitBlock(objects_.data(), objects_.data() + size);
+    return;
+  }
+  int moved = 0;
+  for (int i = 0; i < size; i++) {
+    Object* old_object = objects_[i];
+    visitor->Visit(&objects_[i]);
+    if (objects_[i] == old_object || !HasTableByObject()) continue;
+    // Rebuilding the table is cheaper if most objects move.
+    if (++moved > (size >> 1) ||
+        deleted_by_object_ > (table_by_object_.length() >> 2)) {
+      ClearTableByObject();
+      continue;
     }
+    RemoveFromTableByObject(old_object, i);
+    AddToTableByObject(i);
   }
 }
 
-int ObjectMap::BucketIndexFromId(int64 id) {
-  return id & (table_by_id_.length() - 1);
+uword ObjectMap::HashObject(Object* object) {
+  // Objects are aligned and small integers are shifted, so the low bits
+  // alone hash poorly.
+  uword value = reinterpret_cast<uword>(object);
+  return (value ^ (value >> 7)) * 2654435761u;
 }
 
-int ObjectMap::BucketIndexFromObject(Object* object) {
+int ObjectMap::FindSlotById(int64 id) const {
+  int slot = HashId(id) & mask();
+  while (true) {
+    int index = table_by_id_[slot];
+    if (index == kEmpty) return -1;
+    if (ids_[index] == id) return slot;
+    slot = (slot + 1) & mask();
+  }
+}
+
+int ObjectMap::FindSlotByObject(Object* object, int index) const {
+  int slot = HashObject(object) & mask();
+  while (table_by_object_[slot] != index) {
+    ASSERT(table_by_object_[slot] != kEmpty);
+    slot = (slot + 1) & mask();
+  }
+  return slot;
+}
+
+void ObjectMap::AddToTableById(int index) {
+  int slot = HashId(ids_[index]) & mask();
+  while (table_by_id_[slot] != kEmpty) slot = (slot + 1) & mask();
+  table_by_id_[slot] = index;
+}
+
+void ObjectMap::AddToTableByObject(int index) {
   ASSERT(HasTableByObject());
-  return reinterpret_cast<word>(object) & (table_by_object_.length() - 1);
-}
-
-ObjectMap::Bucket* ObjectMap::DetachById(int64 id) {
-  int index = BucketIndexFromId(id);
-  Bucket* previous = NULL;
-  Bucket* current = table_by_id_[index];
-  while (current != NULL) {
-    if (current->id == id) {
-      Bucket* next = current->next;
-      if (previous == NULL) {
-        table_by_id_[index] = next;
-      } else {
-        previous->next = next;
-      }
-      return current;
+  Object* object = objects_[index];
+  int slot = HashObject(object) & mask();
+  while (true) {
+    int current = table_by_object_[slot];
+    if (current == kEmpty || current == kDeleted) {
+      if (current == kDeleted) deleted_by_object_--;
+      table_by_object_[slot] = index;
+      return;
+    }
+    if (objects_[current] == object) {
+      // Keep the most recently added id for an object first.
+      table_by_object_[slot] = index;
+      index = current;
     }
-    previous = current;
-    current = current->next;
+    slot = (slot + 1) & mask();
   }
-  return NULL;
-}
-
-ObjectMap::Bucket* ObjectMap::DetachByObject(Object* object) {
-  int index = BucketIndexFromObject(object);
-  Bucket* previous = NULL;
-  Bucket* current = table_by_object_[index];
-  while (current != NULL) {
-    if (current->object == object) {
-      Bucket* next = current->next;
-      if (previous == NULL) {
-        table_by_object_[index] = next;
-      } else {
-        previous->next = next;
-      }
-      return current;
+}
+
+void ObjectMap::RemoveFromTableById(int slot) {
+  // Shift the following entries of the cluster back into the hole, unless
+  // they would end up before their home slot.
+  while (true) {
+    table_by_id_[slot] = kEmpty;
+    int next = slot;
+    while (true) {
+      next = (next + 1) & mask();
+      int index = table_by_id_[next];
+      if (index == kEmpty) return;
+      int home = HashId(ids_[index]) & mask();
+      bool stays = (slot <= next) ? (slot < home && home <= next)
+                                  : (slot < home || home <= next);
+      if (!stays) break;
     }
-    previous = current;
-    current = current->next;
+    table_by_id_[slot] = table_by_id_[next];
+    slot = next;
   }
-  return NULL;
 }
 
-void ObjectMap::AddToTableByObject(int64 id, Object* object) {
-  ASSERT(HasTableByObject());
-  int index = BucketIndexFromObject(object);
-  Bucket* bucket = new Bucket();
-  bucket->next = table_by_object_[index];
-  bucket->id = id;
-  bucket->object = object;
-  table_by_object_[index] = bucket;
+void ObjectMap::RemoveFromTableByObject(Object* object, int index) {
+  table_by_object_[FindSlotByObject(object, index)] = kDeleted;
+  deleted_by_object_++;
 }
 
-bool ObjectMap::Expand() {
-  int needed = (++size_) << 1;
-  if (needed < table_by_id_.length()) return false;
+void ObjectMap::RemoveEntry(int index) {
+  RemoveFromTableById(FindSlotById(ids_[index]));
+  if (HasTableByObject()) RemoveFromTableByObject(objects_[index], index);
 
-  // Clear the object -> id mapping table and allocate
-  // a new and large table for the id -> object mappings.
-  ClearTableByObject();
-  List<Bucket*> old_table_by_id = table_by_id_;
-  table_by_id_ = NewTable(needed << 1);
-
-  // Run through the old mappings and re-use the buckets
-  // in the new table after rehashing.
-  for (int i = 0; i < old_table_by_id.length(); i++) {
-    Bucket* current = old_table_by_id[i];
-    while (current != NULL) {
-      Bucket* next = current->next;
-      int index = BucketIndexFromId(current->id);
-      current->next = table_by_id_[index];
-      table_by_id_[index] = current;
-      current = next;
+  int last = size_ - 1;
+  if (index != last) {
+    ids_[index] = ids_[last];
+    objects_[index] = objects_[last];
+    table_by_id_[FindSlotById(ids_[index])] = index;
+    if (HasTableByObject()) {
+      table_by_object_[FindSlotByObject(objects_[index], last)] = index;
     }
   }
+  size_--;
+
+  if (deleted_by_object_ > (table_by_object_.length() >> 2)) {
+    ClearTableByObject();
+  }
+}
 
-  // Delete the old table.
-  old_table_by_id.Delete();
-  return true;
+void ObjectMap::Reserve(int count) {
+  int needed = static_cast<int>(size_) + count;
+  if (needed <= ids_.length()) return;
+  Grow(Utils::RoundUpToPowerOfTwo(needed));
+}
+
+void ObjectMap::Expand() { Grow(ids_.length() << 1); }
+
+void ObjectMap::Grow(int capacity) {
+  ids_.Reallocate(capacity);
+  objects_.Reallocate(capacity);
+
+  // Rebuild the id table for the new capacity. The object table is rebuilt
+  // lazily.
+  ClearTableByObject();
+  table_by_id_.Delete();
+  table_by_id_ = NewTable(Utils::RoundUpToPowerOfTwo(capacity << 1));
+  for (int i = 0; i < static_cast<int>(size_); i++) AddToTableById(i);
 }
 
 void ObjectMap::PopulateTableByObject() {
   if (HasTableByObject()) return;
   table_by_object_ = NewTable(table_by_id_.length());
-  for (int i = 0; i < table_by_id_.length(); i++) {
-    Bucket* current = table_by_id_[i];
-    while (current != NULL) {
-      AddToTableByObject(current->id, current->object);
-      current = current->next;
-    }
-  }
+  for (int i = 0; i < static_cast<int>(size_); i++) AddToTableByObject(i);
   ASSERT(HasTableByObject());
 }
 
-List<ObjectMap::Bucket*> ObjectMap::NewTable(int length) {
-  List<Bucket*> result = List<Bucket*>::New(length);
-  memset(result.data(), 0, length * kPointerSize);
+List<int> ObjectMap::NewTable(int length) {
+  List<int> result = List<int>::New(length);
+  for (int i = 0; i < length; i++) result[i] = kEmpty;
   return result;
 }
 
-void ObjectMap::DeleteTable(List<Bucket*> table) {
-  for (int i = 0; i < table.length(); i++) {
-    Bucket* current = table[i];
-    while (current != NULL) {
-      Bucket* next = current->next;
-      delete current;
-      current = next;
-    }
-  }
-  table.Delete();
-}
-
 }  // namespace dartino
@@ -10,6 +10,13 @@
 
 namespace dartino {
 
+// A two-way mapping between ids and objects.
+//
+// The entries are stored densely in [ids_] and [objects_]. Both lookup
+// tables are open addressing hash tables of indices into the entries. The
+// object to id table is keyed by object addresses, so it is built lazily
+// and only the entries of objects that move are rehashed when the map is
+// visited by a GC.
 class ObjectMap {
  public:
   explicit ObjectMap(int capacity);
@@ -19,6 +26,10 @@ class ObjectMap {
 
   void Add(int64 id, Object* object);
 
+  // Makes room for [count] more entries, so adding them rebuilds the id
+  // table at most once.
+  void Reserve(int count);
+
   bool RemoveById(int64 id);
   bool RemoveByObject(Object* object);
 
@@ -28,33 +39,56 @@ class ObjectMap {
   bool HasTableByObject() const { return !table_by_object_.is_empty(); }
   void ClearTableByObject();
 
+  // Visits the objects in the map. If the object to id table exists, the
+  // objects that were moved by the visitor are rehashed. The table is
+  // dropped instead when that would cost more than rebuilding it.
   void IteratePointers(PointerVisitor* visitor);
 
  private:
-  struct Bucket {
-    Bucket* next;
-    int64 id;
-    Object* object;
-  };
-
-  List<Bucket*> table_by_id_;
-  List<Bucket*> table_by_object_;
+  static const int kEmpty = -1;
+  static const int kDeleted = -2;
+
+  List<int64> ids_;
+  List<Object*> objects_;
   uword size_;
 
-  int BucketIndexFromId(int64 id);
-  int BucketIndexFromObject(Object* object);
+  // Slots hold an index into the entries or kEmpty. Removals shift the
+  // following slots back, so there are no deleted slots.
+  List<int> table_by_id_;
+
+  // Slots hold an index into the entries, kEmpty or kDeleted. Removals
+  // leave kDeleted behind, because the addresses the following slots were
+  // hashed with may have changed since. If an object has several ids, the
+  // most recently added one comes first.
+  List<int> table_by_object_;
+  int deleted_by_object_;
+
+  int mask() const { return table_by_id_.length() - 1; }
+
+  static uword HashId(int64 id) { return static_cast<uword>(id); }
+  static uword HashObject(Object* object);
+
+  // Returns the slot in the id table of the entry for [id] or -1.
+  int FindSlotById(int64 id) const;
+  // Returns the slot in the object table holding [index], which was
+  // added for [object].
+  int FindSlotByObject(Object* object, int index) const;
 
-  Bucket* DetachById(int64 id);
-  Bucket* DetachByObject(Object* object);
+  void AddToTableById(int index);
+  void AddToTableByObject(int index);
+  void RemoveFromTableById(int slot);
+  void RemoveFromTableByObject(Object* object, int index);
 
-  void AddToTableByObject(int64 id, Object* object);
+  // Removes the entry at [index] from the tables and moves the last entry
+  // into its place.
+  void RemoveEntry(int index);
 
-  bool Expand();
+  void Expand();
+  void Grow(int capacity);
 
   void PopulateTableByObject();
 
-  static List<Bucket*> NewTable(int length);
-  static void DeleteTable(List<Bucket*> table);
+  static List<int> NewTable(int length);
 };
 
 }  // namespace dartino
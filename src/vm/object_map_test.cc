@@ -47,4 +47,66 @@ TEST_CASE(ObjectMap) {
   EXPECT_EQ(0u, map.size());
 }
 
+TEST_CASE(ObjectMapReserve) {
+  ObjectMap map(8);
+  for (int i = 0; i < 5; i++) map.Add(i, Smi::FromWord(i));
+  map.Reserve(1000);
+  for (int i = 5; i < 1005; i++) map.Add(i, Smi::FromWord(i));
+  EXPECT_EQ(1005u, map.size());
+  for (int i = 0; i < 1005; i++) {
+    EXPECT_EQ(i, Smi::cast(map.LookupById(i))->value());
+    EXPECT_EQ(i, map.LookupByObject(Smi::FromWord(i)));
+  }
+  // Reserving less than there is room for changes nothing.
+  map.Reserve(1);
+  EXPECT_EQ(1005u, map.size());
+}
+
+// Moves every [step]th object, like a GC that compacts part of the heap.
+class MovingVisitor : public PointerVisitor {
+ public:
+  MovingVisitor(int step, int distance) : step_(step), distance_(distance) {}
+
+  void VisitBlock(Object** start, Object** end) {
+    for (Object** p = start; p < end; p++) {
+      word value = Smi::cast(*p)->value();
+      if (value % step_ == 0) *p = Smi::FromWord(value + distance_);
+    }
+  }
+
+ private:
+  int step_;
+  int distance_;
+};
+
+TEST_CASE(ObjectMapMovingObjects) {
+  const int kSize = 1000;
+  const int kDistance = 1000000;
+  for (int step = 1; step <= 100; step *= 10) {
+    ObjectMap map(16);
+    for (int i = 0; i < kSize; i++) map.Add(i, Smi::FromWord(i));
+    EXPECT_EQ(5, map.LookupByObject(Smi::FromWord(5)));
+
+    MovingVisitor visitor(step, kDistance);
+    map.IteratePointers(&visitor);
+    // Only a few moved objects keep the table.
+    EXPECT_EQ(step != 1, map.HasTableByObject());
+    for (int i = 0; i < kSize; i++) {
+      int expected = (i % step == 0) ? i + kDistance : i;
+      EXPECT_EQ(Smi::FromWord(expected), map.LookupById(i));
+      EXPECT_EQ(i, map.LookupByObject(Smi::FromWord(expected)));
+      if (i % step == 0) {
+        EXPECT_EQ(-1, map.LookupByObject(Smi::FromWord(i)));
+      }
+    }
+
+    for (int i = 0; i < kSize; i += 2) EXPECT(map.RemoveById(i));
+    EXPECT_EQ(static_cast<uword>(kSize / 2), map.size());
+    for (int i = 1; i < kSize; i += 2) {
+      int expected = (i % step == 0) ? i + kDistance : i;
+      EXPECT_EQ(i, map.LookupByObject(Smi::FromWord(expected)));
+    }
+  }
+}
+
 }  // namespace dartino
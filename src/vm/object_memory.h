@@ -9,6 +9,7 @@
 #include "src/shared/platform.h"
 #include "src/shared/utils.h"
 #include "src/vm/double_list.h"
+#include "src/vm/slab_allocator.h"
 #include "src/vm/weak_pointer.h"
 
 namespace dartino {
@@ -51,7 +52,8 @@ typedef DoubleList<Chunk> ChunkList;
 typedef DoubleList<Chunk>::Iterator<Chunk> ChunkListIterator;
 
 // A chunk represents a block of memory provided by ObjectMemory.
-class Chunk : public ChunkList::Entry {
+class Chunk : public ChunkList::Entry,
+              public SlabAllocated<SlabAllocator::kChunk> {
  public:
   // The space owning this chunk.
   Space* owner() const { return owner_; }
@@ -56,4 +56,90 @@ TEST_CASE(Mutex) {
   delete mutex;
 }
 
+static const int kPingPongRounds = 10000;
+
+// The two threads take turns incrementing [value]. [out_of_order] counts
+// the turns that did not see the value the previous turn left behind.
+struct PingPong {
+  Semaphore ping;
+  Semaphore pong;
+  int value;
+  int out_of_order;
+  PingPong() : ping(0), pong(0), value(0), out_of_order(0) {}
+};
+
+static void* RunPong(void* arg) {
+  PingPong* ping_pong = static_cast<PingPong*>(arg);
+  for (int i = 0; i < kPingPongRounds; i++) {
+    ping_pong->ping.Down();
+    if (ping_pong->value != 2 * i + 1) ping_pong->out_of_order++;
+    ping_pong->value++;
+    ping_pong->pong.Up();
+  }
+  return NULL;
+}
+
+// Passes control back and forth between two threads, so each thread must
+// observe the other's update before it takes its turn.
+TEST_CASE(SemaphorePingPong) {
+  PingPong ping_pong;
+  pthread_t other;
+  EXPECT_EQ(0, pthread_create(&other, NULL, &RunPong, &ping_pong));
+  for (int i = 0; i < kPingPongRounds; i++) {
+    if (ping_pong.value != 2 * i) ping_pong.out_of_order++;
+    ping_pong.value++;
+    ping_pong.ping.Up();
+    ping_pong.pong.Down();
+  }
+  pthread_join(other, NULL);
+  EXPECT_EQ(2 * kPingPongRounds, ping_pong.value);
+  EXPECT_EQ(0, ping_pong.out_of_order);
+}
+
+struct EventCountState {
+  EventCount event_count;
+  Atomic<int> value;
+  EventCountState() : value(0) {}
+};
+
+static void* RunEventCountWaiter(void* arg) {
+  EventCountState* state = static_cast<EventCountState*>(arg);
+  for (int expected = 1; expected <= kPingPongRounds; expected += 2) {
+    // Wait for the value to become odd, then make it even.
+    while (state->value != expected) {
+      int32 key = state->event_count.PrepareWait();
+      if (state->value == expected) {
+        state->event_count.CancelWait();
+        break;
+      }
+      state->event_count.Wait(key);
+    }
+    state->value = expected + 1;
+    state->event_count.NotifyAll();
+  }
+  return NULL;
+}
+
+// Alternates two threads that sleep on the same event count, so a lost
+// wakeup would hang the test.
+TEST_CASE(EventCount) {
+  EventCountState state;
+  pthread_t other;
+  EXPECT_EQ(0, pthread_create(&other, NULL, &RunEventCountWaiter, &state));
+  for (int expected = 0; expected < kPingPongRounds; expected += 2) {
+    while (state.value != expected) {
+      int32 key = state.event_count.PrepareWait();
+      if (state.value == expected) {
+        state.event_count.CancelWait();
+        break;
+      }
+      state.event_count.Wait(key);
+    }
+    state.value = expected + 1;
+    state.event_count.NotifyAll();
+  }
+  pthread_join(other, NULL);
+  EXPECT_EQ(kPingPongRounds, state.value);
+}
+
 }  // namespace dartino
@@ -10,6 +10,7 @@
 #include "src/vm/natives.h"
 #include "src/vm/object.h"
 #include "src/vm/process.h"
+#include "src/vm/timeline.h"
 
 namespace dartino {
 
@@ -141,6 +142,7 @@ BEGIN_NATIVE(PortSend) {
     port->Lock();
     Process* port_process = port->process();
     if (port_process != NULL) {
+      Timeline::Instant("PortSend", port_process);
       port_process->mailbox()->EnqueueEntry(entry);
       entry = NULL;
 
@@ -22,6 +22,7 @@
 #include "src/vm/object_memory.h"
 #include "src/vm/port.h"
 #include "src/vm/session.h"
+#include "src/vm/source_positions.h"
 
 namespace dartino {
 
@@ -38,6 +39,7 @@ Process::Process(Program* program, Process* parent)
       exception_(program->null_object()),
       primary_lookup_cache_(NULL),
       remembered_set_bias_(GCMetadata::remembered_set_bias()),
+      lookup_cache_(NULL),
       large_integer_(program->null_object()),
       random_(program->random()->NextUInt32() + 1),
       state_(kSleeping),
@@ -47,7 +49,11 @@ Process::Process(Program* program, Process* parent)
       process_triangle_count_(1),
       parent_(parent),
       errno_cache_(0),
+      initial_stack_size_(0),
+      max_stack_size_(0),
+      shallow_idle_periods_(0),
       debug_info_(NULL),
+      trace_stack_(NULL),
       scheduler_(NULL)
 #ifdef DEBUG
       ,
@@ -55,6 +61,7 @@ Process::Process(Program* program, Process* parent)
 #endif
 {
   process_handle_ = new ProcessHandle(this);
+  SetStackSizes(0, 0);
 
   // These asserts need to hold when running on the target, but they don't need
   // to hold on the host (the build machine, where the interpreter-generating
@@ -104,6 +111,7 @@ Process::~Process() {
   if (signal != NULL) Signal::DecrementRef(signal);
 
   delete debug_info_;
+  delete trace_stack_;
   for (int i = 0; i < arguments_.length(); i++) {
     arguments_[i].Delete();
   }
@@ -132,7 +140,7 @@ void Process::Cleanup(Signal::Kind kind) {
 
 void Process::SetupExecutionStack() {
   ASSERT(coroutine_ == NULL);
-  Object* raw_stack = NewStack(kInitialStackSize);
+  Object* raw_stack = NewStack(initial_stack_size_);
   // Retry on allocation failure.
   if (raw_stack->IsRetryAfterGCFailure()) {
     SetAllocationFailed();
@@ -148,6 +156,7 @@ void Process::SetupExecutionStack() {
   }
   Coroutine* coroutine = Coroutine::cast(raw_coroutine);
   coroutine->set_stack(stack);
+  coroutines_.Add(coroutine);
   UpdateCoroutine(coroutine);
 }
 
@@ -178,7 +187,13 @@ Process::StackCheckResult Process::HandleStackOverflow(int addition) {
   int size_increase = Utils::RoundUpToPowerOfTwo(addition);
   size_increase = Utils::Maximum(256, size_increase);
   int new_size = stack()->length() + size_increase;
-  if (new_size > Platform::MaxStackSizeInWords()) return kStackCheckOverflow;
+  if (new_size > max_stack_size_) {
+    // Use the rest of the allowed stack if the addition fits.
+    if (stack()->length() + addition > max_stack_size_) {
+      return kStackCheckOverflow;
+    }
+    new_size = max_stack_size_;
+  }
 
   Object* new_stack_object = NewStack(new_size);
   if (new_stack_object->IsRetryAfterGCFailure()) {
@@ -194,11 +209,48 @@ Process::StackCheckResult Process::HandleStackOverflow(int addition) {
     }
   }
 
+  ReplaceStack(Stack::cast(new_stack_object));
+  return kStackCheckContinue;
+}
+
+void Process::SetStackSizes(int initial_size, int max_size) {
+  if (max_size <= 0) {
+    max_size = Flags::max_stack_size > 0 ? Flags::max_stack_size
+                                         : Platform::MaxStackSizeInWords();
+  }
+  if (initial_size <= 0) initial_size = Flags::initial_stack_size;
+  max_stack_size_ = Utils::Maximum(kMinStackSize, max_size);
+  initial_stack_size_ = Utils::Minimum(
+      Utils::Maximum(kMinStackSize, initial_size), max_stack_size_);
+}
+
+void Process::ShrinkStack() {
+  Stack* old_stack = stack();
+  word height = old_stack->length() - old_stack->top();
+  // Leave room for the frames pushed when the process resumes.
+  static_assert(kMinStackSize > Bytecode::kGuaranteedFrameSize + 2,
+                "Stack headroom");
+  int new_size = Utils::RoundUpToPowerOfTwo(height + kMinStackSize);
+  new_size = Utils::Maximum(initial_stack_size_, new_size);
+  if (new_size > old_stack->length() / 2) {
+    shallow_idle_periods_ = 0;
+    return;
+  }
+  // Keep the stack until the process has gone idle shallow a few times in a
+  // row, so a process that regularly runs deep doesn't keep reallocating it.
+  if (++shallow_idle_periods_ < kShrinkStackIdlePeriods) return;
+
+  Object* new_stack_object = NewStack(new_size);
+  if (new_stack_object->IsRetryAfterGCFailure()) return;
+  ReplaceStack(Stack::cast(new_stack_object));
+}
+
+void Process::ReplaceStack(Stack* new_stack) {
   NoAllocationScope scope(heap());  // Protect new_stack.
 
-  Stack* new_stack = Stack::cast(new_stack_object);
   word height = stack()->length() - stack()->top();
   ASSERT(height >= 0);
+  ASSERT(height <= new_stack->length());
   new_stack->set_top(new_stack->length() - height);
   memcpy(new_stack->Pointer(new_stack->top()), stack()->Pointer(stack()->top()),
          height * kWordSize);
@@ -207,7 +259,7 @@ Process::StackCheckResult Process::HandleStackOverflow(int addition) {
   coroutine_->set_stack(new_stack);
   GCMetadata::InsertIntoRememberedSet(coroutine_->stack()->address());
   UpdateStackLimit();
-  return kStackCheckContinue;
+  shallow_idle_periods_ = 0;
 }
 
 Object* Process::NewByteArray(int length) {
@@ -360,10 +412,11 @@ void Process::IterateProgramPointers(PointerVisitor* visitor) {
   mailbox_.IteratePointers(visitor);
 }
 
-void Process::TakeLookupCache() {
+void Process::TakeLookupCache(LookupCache* cache) {
   ASSERT(primary_lookup_cache_ == NULL);
   if (program()->is_optimized()) return;
-  LookupCache* cache = program()->EnsureCache();
+  cache->Validate();
+  lookup_cache_ = cache;
   primary_lookup_cache_ = cache->primary();
 }
 
@@ -397,6 +450,11 @@ void Process::EnsureDebuggerAttached() {
   }
 }
 
+TraceStack* Process::EnsureTraceStack() {
+  if (trace_stack_ == NULL) trace_stack_ = new TraceStack();
+  return trace_stack_;
+}
+
 int Process::PrepareStepOver() {
   ASSERT(debug_info_ != NULL);
   Frame frame(stack());
@@ -542,14 +600,17 @@ void Process::UpdateStackLimit() {
 LookupCache::Entry* Process::LookupEntrySlow(LookupCache::Entry* primary,
                                              Class* clazz, int selector) {
   ASSERT(!program()->is_optimized());
-  LookupCache* cache = program()->cache();
+  LookupCache* cache = lookup_cache_;
+  ASSERT(cache != NULL);
 
-  uword index = LookupCache::ComputeSecondaryIndex(clazz, selector);
+  uword index = cache->ComputeSecondaryIndex(clazz, selector);
   LookupCache::Entry* secondary = &(cache->secondary()[index]);
   if (secondary->clazz == clazz && secondary->selector == selector) {
+    cache->RecordSecondaryHit();
     return secondary;
   }
 
+  cache->RecordMiss();
   void* code = NULL;
   Function* target = clazz->LookupMethod(selector);
   if (target == NULL) {
@@ -616,8 +677,11 @@ void Process::PrintStackTrace() const {
         uint8* bcp = frame.ByteCodePointer();
         int bytecode_offset = bcp - start_bcp;
 
-        Print::Out("Frame % 2d: Function(%ld) Bytecode(%d)\n", index,
-                   program_->OffsetOf(function), bytecode_offset);
+        if (!SourcePositions::PrintFrame(program_, index, function,
+                                         bytecode_offset)) {
+          Print::Out("Frame % 2d: Function(%ld) Bytecode(%d)\n", index,
+                     program_->OffsetOf(function), bytecode_offset);
+        }
         index++;
       }
 
@@ -8,6 +8,7 @@
 #include "src/shared/atomic.h"
 #include "src/shared/random.h"
 
+#include "src/vm/coroutine_registry.h"
 #include "src/vm/debug_info.h"
 #include "src/vm/gc_metadata.h"
 #include "src/vm/heap.h"
@@ -95,6 +96,8 @@ class Process : public ProcessList::Entry, public ProcessQueueList::Entry {
   Stack* stack() const { return coroutine_->stack(); }
   uword stack_limit() const { return stack_limit_.load(); }
 
+  CoroutineRegistry* coroutines() { return &coroutines_; }
+
   Port* ports() const { return ports_; }
   void set_ports(Port* port) { ports_ = port; }
 
@@ -108,6 +111,21 @@ class Process : public ProcessList::Entry, public ProcessQueueList::Entry {
   void SetupExecutionStack();
   StackCheckResult HandleStackOverflow(int addition);
 
+  // Stack sizes are in words. A size of 0 selects the default from
+  // --initial_stack_size and --max_stack_size. Must be called before
+  // [SetupExecutionStack].
+  static const int kMinStackSize = 64;
+  void SetStackSizes(int initial_size, int max_size);
+  int initial_stack_size() const { return initial_stack_size_; }
+  int max_stack_size() const { return max_stack_size_; }
+
+  // Replaces a mostly unused stack by a smaller one, so a sleeping process
+  // holds on to less memory. The stack is only replaced once it has been
+  // mostly unused for kShrinkStackIdlePeriods consecutive calls. Allocation
+  // failures are ignored.
+  static const int kShrinkStackIdlePeriods = 4;
+  void ShrinkStack();
+
   inline LookupCache::Entry* LookupEntry(Object* receiver, int selector);
 
   // Lookup and update the primary cache entry.
@@ -197,8 +215,17 @@ class Process : public ProcessList::Entry, public ProcessQueueList::Entry {
   ProcessDebugInfo* debug_info() { return debug_info_; }
   bool is_debugging() const { return debug_info_ != NULL; }
 
-  void TakeLookupCache();
-  void ReleaseLookupCache() { primary_lookup_cache_ = NULL; }
+  // The entry times of the traced calls the process is in. Tracing does not
+  // attach the debugger.
+  TraceStack* EnsureTraceStack();
+
+  // Uses the lookup cache of the current thread while interpreting.
+  void TakeLookupCache(LookupCache* cache);
+  void ReleaseLookupCache() {
+    lookup_cache_ = NULL;
+    primary_lookup_cache_ = NULL;
+  }
+  LookupCache* lookup_cache() const { return lookup_cache_; }
 
   // Program GC support. Update breakpoints after having moved function.
   // Bytecode pointers need to be updated.
@@ -298,6 +325,10 @@ class Process : public ProcessList::Entry, public ProcessQueueList::Entry {
 
   void UpdateStackLimit();
 
+  // Copies the frames of the current stack to [new_stack] and makes it the
+  // stack of the current coroutine.
+  void ReplaceStack(Stack* new_stack);
+
   // Put these first so they can be accessed from the interpreter without
   // issues around object layout.
   void* native_stack_;
@@ -316,6 +347,9 @@ class Process : public ProcessList::Entry, public ProcessQueueList::Entry {
   // it quickly.
   uword remembered_set_bias_;
 
+  // The cache [primary_lookup_cache_] belongs to.
+  LookupCache* lookup_cache_;
+
   Object* large_integer_;
 
   RandomXorShift random_;
@@ -332,6 +366,9 @@ class Process : public ProcessList::Entry, public ProcessQueueList::Entry {
   // Linked list of ports owned by this process.
   Port* ports_;
 
+  // Weak list of the coroutines created by this process.
+  CoroutineRegistry coroutines_;
+
   // The number of direct child processes plus 1.
   Atomic<int> process_triangle_count_;
 
@@ -340,7 +377,13 @@ class Process : public ProcessList::Entry, public ProcessQueueList::Entry {
 
   int errno_cache_;
 
+  int initial_stack_size_;
+  int max_stack_size_;
+  // Consecutive idle periods with a mostly unused stack, see [ShrinkStack].
+  int shallow_idle_periods_;
+
   ProcessDebugInfo* debug_info_;
+  TraceStack* trace_stack_;
 
   List<List<uint8>> arguments_;
 
@@ -9,13 +9,15 @@
 
 #include "src/vm/spinlock.h"
 #include "src/vm/refcounted.h"
+#include "src/vm/slab_allocator.h"
 
 namespace dartino {
 
 class Process;
 class Object;
 
-class ProcessHandle : public Refcounted<ProcessHandle> {
+class ProcessHandle : public Refcounted<ProcessHandle>,
+                      public SlabAllocated<SlabAllocator::kProcessHandle> {
  public:
   explicit ProcessHandle(Process* process) : process_(process) {}
 
@@ -7,6 +7,7 @@
 
 #include "src/shared/assert.h"
 
+#include "src/vm/metrics.h"
 #include "src/vm/process.h"
 #include "src/vm/program.h"
 #include "src/vm/spinlock.h"
@@ -17,12 +18,15 @@ class ThreadState;
 
 class ProcessQueue {
  public:
+  ProcessQueue() : length_(0) {}
+
   // Enqueues [entry] to the queue and returns whether it was empty.
   bool Enqueue(Process* entry) {
     ScopedSpinlock locker(&spinlock_);
     ASSERT(!ready_.IsInList(entry));
     bool was_empty = ready_.IsEmpty();
     ready_.Append(entry);
+    SetLength(length_ + 1);
     if (!entry->ChangeState(Process::kEnqueuing, Process::kReady)) {
       UNREACHABLE();
     }
@@ -36,6 +40,7 @@ class ProcessQueue {
     if (ready_.IsEmpty()) return false;
 
     Process* process = ready_.RemoveFirst();
+    SetLength(length_ - 1);
     if (!process->ChangeState(Process::kReady, Process::kRunning)) {
       UNREACHABLE();
     }
@@ -49,6 +54,7 @@ class ProcessQueue {
 
     if (entry->ChangeState(Process::kReady, Process::kRunning)) {
       ready_.Remove(entry);
+      SetLength(length_ - 1);
       return true;
     }
     return false;
@@ -71,6 +77,7 @@ class ProcessQueue {
       Process* process = *it;
       if (process->program() == program) {
         it = ready_.Erase(it);
+        SetLength(length_ - 1);
         if (!process->ChangeState(Process::kReady, Process::kEnqueuing)) {
           UNREACHABLE();
         }
@@ -82,8 +89,16 @@ class ProcessQueue {
   }
 
  private:
+  // The length is only changed under the spinlock and published with a
+  // plain store, so the metric adds no atomic update to the queue.
+  void SetLength(word length) {
+    length_ = length;
+    Metrics::ready_processes.Set(length);
+  }
+
   Spinlock spinlock_;
   ProcessQueueList ready_;
+  word length_;
 };
 
 }  // namespace dartino
@@ -18,12 +18,15 @@
 #include "src/vm/frame.h"
 #include "src/vm/heap_validator.h"
 #include "src/vm/mark_sweep.h"
+#include "src/vm/metrics.h"
 #include "src/vm/native_interpreter.h"
 #include "src/vm/object.h"
 #include "src/vm/port.h"
 #include "src/vm/process.h"
 #include "src/vm/session.h"
+#include "src/vm/slab_allocator.h"
 #include "src/vm/snapshot.h"
+#include "src/vm/timeline.h"
 
 namespace dartino {
 
@@ -53,7 +56,6 @@ Program::Program(ProgramSource source, int snapshot_hash)
       program_exit_listener_data_(NULL),
       exit_kind_(Signal::kTerminated),
       stack_chain_(NULL),
-      cache_(NULL),
       debug_info_(NULL),
       group_mask_(0) {
 // These asserts need to hold when running on the target, but they don't need
@@ -74,7 +76,8 @@ Program::Program(ProgramSource source, int snapshot_hash)
 
 Program::~Program() {
   delete process_list_mutex_;
-  delete cache_;
+  // The caches may hold classes of this program.
+  ClearCache();
   delete debug_info_;
   ASSERT(process_list_.IsEmpty());
 }
@@ -100,7 +103,8 @@ int Program::ExitCode() {
   return 0;
 }
 
-Process* Program::SpawnProcess(Process* parent) {
+Process* Program::SpawnProcess(Process* parent, int initial_stack_size,
+                               int max_stack_size) {
   Process* process = new Process(this, parent);
   if (process->AllocationFailed()) {
     // Delete the half-built process, we will retry after a GC.
@@ -109,6 +113,7 @@ Process* Program::SpawnProcess(Process* parent) {
     return NULL;
   }
 
+  process->SetStackSizes(initial_stack_size, max_stack_size);
   process->SetupExecutionStack();
   if (process->AllocationFailed()) {
     // Delete the half-built process, we will retry after a GC.
@@ -123,6 +128,7 @@ Process* Program::SpawnProcess(Process* parent) {
   }
 
   AddToProcessList(process);
+  Timeline::Instant("SpawnProcess", process);
   return process;
 }
 
@@ -177,6 +183,7 @@ bool Program::ScheduleProcessForDeletion(Process* process, Signal::Kind kind) {
     }
 
     RemoveFromProcessList(current);
+    Timeline::Instant("DeleteProcess", current);
     delete current;
 
     current = parent;
@@ -340,6 +347,7 @@ void Program::PerformProgramGC(SemiSpace* to, PointerVisitor* visitor) {
     ASSERT(!to->is_empty());
     to->CompleteScavenge(visitor);
   }
+  intern_table_.CleanupAfterGC(heap_.space());
   heap_.ReplaceSpace(to);
 }
 
@@ -533,11 +541,13 @@ void Program::AddToProcessList(Process* process) {
   ASSERT(!process->AllocationFailed());
   ScopedLock locker(process_list_mutex_);
   process_list_.Append(process);
+  Metrics::processes.Increment();
 }
 
 void Program::RemoveFromProcessList(Process* process) {
   ScopedLock locker(process_list_mutex_);
   process_list_.Remove(process);
+  Metrics::processes.Decrement();
 }
 
 ProcessHandle* Program::MainProcess() {
@@ -596,12 +606,17 @@ void Program::CollectOldSpace() {
     GetSharedHeapUsage(process_heap(), &usage_before);
   }
 
+  TimelineScope timeline_scope("CollectOldSpace");
+  uint64 start = Platform::GetMicroseconds();
   PerformSharedGarbageCollection();
+  Metrics::old_space_collections.Increment();
+  Metrics::old_space_collection_us.Record(Platform::GetMicroseconds() - start);
 
   if (Flags::print_heap_statistics) {
     SharedHeapUsage usage_after;
     GetSharedHeapUsage(process_heap(), &usage_after);
     PrintProgramGCInfo(&usage_before, &usage_after);
+    SlabAllocator::PrintStatistics();
   }
 
   if (Flags::validate_heaps) {
@@ -657,7 +672,9 @@ void Program::SweepSharedHeap() {
 
   for (auto process : process_list_) {
     process->set_ports(Port::CleanupPorts(old_space, process->ports()));
+    process->coroutines()->CleanupAfterGC(old_space);
   }
+  intern_table_.CleanupAfterGC(old_space);
 
   // Sweep over the old-space and rebuild the freelist.
   SweepingVisitor sweeping_visitor(old_space);
@@ -692,7 +709,9 @@ void Program::CompactSharedHeap() {
 
   for (auto process : process_list_) {
     process->set_ports(Port::CleanupPorts(old_space, process->ports()));
+    process->coroutines()->CleanupAfterGC(old_space);
   }
+  intern_table_.CleanupAfterGC(old_space);
 
   old_space->ZapObjectStarts();
 
@@ -962,7 +981,7 @@ void Program::Initialize() {
   }
 
   {
-    InstanceFormat format = InstanceFormat::instance_format(2);
+    InstanceFormat format = InstanceFormat::instance_format(3);
     constant_map_class_ =
         Class::cast(heap()->CreateClass(format, meta_class_, null_object_));
   }
@@ -1069,6 +1088,7 @@ void Program::Initialize() {
       CreateStringFromAscii(StringFromCharZ("Illegal state.")));
 
   native_failure_result_ = null_object_;
+  source_positions_ = null_object_;
   VerifyObjectPlacements();
 }
 
@@ -1187,6 +1207,7 @@ void PrintProcessGCInfo(HeapUsage* before, HeapUsage* after) {
 // Somewhat misnamed - it does a scavenge of the data area used by the
 // processes, not the code area used by the program.
 void Program::CollectNewSpace() {
+  TimelineScope timeline_scope("CollectNewSpace");
   HeapUsage usage_before;
 
   TwoSpaceHeap* data_heap = process_heap();
@@ -1210,6 +1231,8 @@ void Program::CollectNewSpace() {
     GetHeapUsage(data_heap, &usage_before);
   }
 
+  uint64 start = Platform::GetMicroseconds();
+
   SemiSpace* to = data_heap->unused_space();
 
   uword old_used = old->Used();
@@ -1237,7 +1260,9 @@ void Program::CollectNewSpace() {
 
   for (auto process : process_list_) {
     process->set_ports(Port::CleanupPorts(from, process->ports()));
+    process->coroutines()->CleanupAfterGC(from);
   }
+  intern_table_.CleanupAfterGC(from);
 
   // Second space argument is used to size the new-space.
   data_heap->SwapSemiSpaces();
@@ -1262,6 +1287,12 @@ void Program::CollectNewSpace() {
   if (progress > 0) {
     old->ReportNewSpaceProgress(progress);
   }
+
+  Metrics::new_space_collections.Increment();
+  Metrics::new_space_allocated_bytes.Increment(from->Used());
+  Metrics::new_space_survived_bytes.Increment(to->Used() + old->Used() -
+                                              old_used);
+  Metrics::new_space_collection_us.Record(Platform::GetMicroseconds() - start);
   CollectOldSpaceIfNeeded(visitor.trigger_old_space_gc());
   UpdateStackLimits();
 }
@@ -1358,15 +1389,6 @@ void Program::UncookAndUnchainStacks() {
   stack_chain_ = NULL;
 }
 
-LookupCache* Program::EnsureCache() {
-  if (cache_ == NULL) cache_ = new LookupCache();
-  return cache_;
-}
-
-void Program::ClearCache() {
-  if (cache_ != NULL) cache_->Clear();
-}
-
 #ifdef DEBUG
 void Program::Find(uword address) {
   process_heap_.Find(address);
@@ -10,6 +10,7 @@
 #include "src/vm/debug_info.h"
 #include "src/vm/double_list.h"
 #include "src/vm/heap.h"
+#include "src/vm/intern_table.h"
 #include "src/vm/lookup_cache.h"
 #include "src/vm/links.h"
 #include "src/vm/program_folder.h"
@@ -74,6 +75,7 @@ class Session;
   V(HeapObject, raw_index_out_of_bounds, RawIndexOutOfBounds)   \
   V(HeapObject, raw_illegal_state, RawIllegalState)             \
   V(Object, native_failure_result, NativeFailureResult)         \
+  V(Object, source_positions, SourcePositions)                  \
   V(Array, static_fields, StaticFields)                         \
   V(Array, dispatch_table, DispatchTable)
 
@@ -187,6 +189,12 @@ class Program : public ProgramList::Entry {
     dispatch_table_ = dispatch_table;
   }
 
+  // The source position tables of the program or null, see
+  // src/vm/source_positions.h.
+  void set_source_positions(Object* source_positions) {
+    source_positions_ = source_positions;
+  }
+
   Scheduler* scheduler() const { return scheduler_; }
   void set_scheduler(Scheduler* scheduler) {
     ASSERT((scheduler_ == NULL && scheduler != NULL) ||
@@ -259,7 +267,9 @@ class Program : public ProgramList::Entry {
     return NULL;
   }
 
-  Process* SpawnProcess(Process* parent);
+  // Stack sizes of 0 select the defaults, see [Process::SetStackSizes].
+  Process* SpawnProcess(Process* parent, int initial_stack_size = 0,
+                        int max_stack_size = 0);
   Process* ProcessSpawnForMain(List<List<uint8>> arguments);
   // Returns [true] if this was the last process (i.e. main process).
   bool ScheduleProcessForDeletion(Process* process, Signal::Kind kind);
@@ -343,9 +353,11 @@ class Program : public ProgramList::Entry {
   // Returns the number of stacks found in the heap.
   int CollectMutableGarbageAndChainStacks();
 
-  LookupCache* cache() const { return cache_; }
-  LookupCache* EnsureCache();
-  void ClearCache();
+  // Invalidates the lookup caches of all worker threads.
+  void ClearCache() { LookupCache::InvalidateAll(); }
+
+  // Weak table of canonical strings shared by all processes of the program.
+  InternTable* intern_table() { return &intern_table_; }
 
   ProcessHandle* MainProcess();
 
@@ -419,7 +431,7 @@ class Program : public ProgramList::Entry {
   Stack* stack_chain_;
   List<List<int>> cooked_stack_deltas_;
 
-  LookupCache* cache_;
+  InternTable intern_table_;
 
   ProgramDebugInfo* debug_info_;
 
@@ -9,21 +9,53 @@
 #include "src/vm/frame.h"
 #include "src/vm/interpreter.h"
 #include "src/vm/links.h"
+#include "src/vm/lookup_cache.h"
 #include "src/vm/port.h"
 #include "src/vm/process.h"
 #include "src/vm/process_queue.h"
 #include "src/vm/session.h"
 #include "src/vm/thread.h"
+#include "src/vm/timeline.h"
 
 namespace dartino {
 
 // Global instance of scheduler.
 Scheduler* Scheduler::scheduler_ = NULL;
 
-WorkerThread::WorkerThread(Scheduler* scheduler)
-    : scheduler_(scheduler) {}
-
-WorkerThread::~WorkerThread() { }
+// Validates the flag in release builds too, before the tables are allocated.
+// A power of two would only use the low bits of the class addresses.
+static int LookupCacheSecondarySize() {
+  int size = Flags::lookup_cache_secondary_size;
+  if (size <= 0 || Utils::IsPowerOfTwo(size)) {
+    FATAL1("lookup_cache_secondary_size must be positive and not a power "
+           "of two, got %d.\n", size);
+  }
+  return size;
+}
+
+WorkerThread::WorkerThread(Scheduler* scheduler, int index)
+    : scheduler_(scheduler),
+      index_(index),
+      cpu_(-1),
+      lookup_cache_(new LookupCache(LookupCacheSecondarySize())),
+      slices_(0),
+      idle_waits_(0),
+      interpret_microseconds_(0) {}
+
+WorkerThread::~WorkerThread() { delete lookup_cache_; }
+
+void WorkerThread::PrintStatistics() {
+  // uword is unsigned long even where uintptr_t is not, so widen the counters
+  // to uint64 for the format macros.
+  Print::Error("Worker %d (cpu %d): %" PRIu64 " slices, %" PRIu64
+               " us interpreting, %" PRIu64 " idle waits\n",
+               index_, cpu_, static_cast<uint64>(slices_),
+               interpret_microseconds_, static_cast<uint64>(idle_waits_));
+  Print::Error("Worker %d lookup cache: %" PRIu64 " secondary hits, %" PRIu64
+               " misses\n",
+               index_, static_cast<uint64>(lookup_cache_->secondary_hits()),
+               static_cast<uint64>(lookup_cache_->misses()));
+}
 
 void InterpretationBarrier::PreemptProcess() {
   Process* process = current_process;
@@ -74,7 +106,9 @@ void InterpretationBarrier::Leave(Process* process) {
 
 void Scheduler::Setup() {
   ASSERT(scheduler_ == NULL);
-  scheduler_ = new Scheduler();
+  int thread_count = Flags::scheduler_threads;
+  if (thread_count < 1) thread_count = 1;
+  scheduler_ = new Scheduler(thread_count, Flags::pin_scheduler_threads);
 }
 
 void Scheduler::TearDown() {
@@ -85,27 +119,32 @@ void Scheduler::TearDown() {
   scheduler_ = NULL;
 }
 
-Scheduler::Scheduler()
-    : interpreter_is_paused_(false),
+Scheduler::Scheduler(int thread_count, bool pin_threads)
+    : thread_count_(thread_count),
+      pin_threads_(pin_threads),
+      thread_ids_(new ThreadIdentifier[thread_count]),
+      threads_(new WorkerThread*[thread_count]),
+      interpreter_is_paused_(false),
       pause_monitor_(Platform::CreateMonitor()),
       pause_(false),
       shutdown_(false),
-      idle_monitor_(Platform::CreateMonitor()),
       interpreter_semaphore_(1) {
-  for (int i = 0; i < kThreadCount; i++) {
-    WorkerThread* worker = new WorkerThread(this);
+  for (int i = 0; i < thread_count_; i++) {
+    WorkerThread* worker = new WorkerThread(this, i);
     threads_[i] = worker;
     thread_ids_[i] = Thread::Run(WorkerThread::RunThread, worker);
   }
 }
 
 Scheduler::~Scheduler() {
-  for (int i = 0; i < kThreadCount; i++) {
+  for (int i = 0; i < thread_count_; i++) {
     thread_ids_[i].Join();
+    if (Flags::print_scheduler_statistics) threads_[i]->PrintStatistics();
     delete threads_[i];
   }
+  delete[] thread_ids_;
+  delete[] threads_;
 
-  delete idle_monitor_;
   delete pause_monitor_;
 }
 
@@ -355,9 +394,13 @@ bool Scheduler::RunInterpreterLoop(WorkerThread* worker) {
         interpreter_is_paused_ = true;
         pause_monitor_->NotifyAll();
       }
-      {
-        ScopedMonitorLock idle_locker(idle_monitor_);
-        while (pause_) idle_monitor_->Wait();
+      while (pause_) {
+        int32 key = idle_event_.PrepareWait();
+        if (!pause_) {
+          idle_event_.CancelWait();
+          break;
+        }
+        idle_event_.Wait(key);
       }
       {
         ScopedMonitorLock locker(pause_monitor_);
@@ -368,9 +411,14 @@ bool Scheduler::RunInterpreterLoop(WorkerThread* worker) {
     }
 
     // Sleep until there is something new to execute.
-    ScopedMonitorLock scoped_lock(idle_monitor_);
-    while (ready_queue_.IsEmpty() && !pause_ && !shutdown_) {
-      idle_monitor_->Wait();
+    while (true) {
+      int32 key = idle_event_.PrepareWait();
+      if (!ready_queue_.IsEmpty() || pause_ || shutdown_) {
+        idle_event_.CancelWait();
+        break;
+      }
+      worker->idle_waits_++;
+      idle_event_.Wait(key);
     }
     if (shutdown_) break;
   }
@@ -394,7 +442,7 @@ void Scheduler::ResumeInterpreterLoop() {
   NotifyInterpreterThread();
 }
 
-void Scheduler::EnterDart(Process* process) {
+void Scheduler::EnterDart(Process* process, LookupCache* cache) {
   dispatch_table_.ResetBreakpoints(
       process->program()->debug_info(), process->debug_info());
 
@@ -408,7 +456,7 @@ void Scheduler::EnterDart(Process* process) {
   process->heap()->set_random(process->random());
 
   process->RestoreErrno();
-  process->TakeLookupCache();
+  process->TakeLookupCache(cache);
 }
 
 void Scheduler::LeaveDart(Process* process) {
@@ -437,10 +485,23 @@ Process* Scheduler::InterpretProcess(Process* process, WorkerThread* worker) {
     return NULL;
   }
 
-  EnterDart(process);
+  uint64 start = 0;
+  if (Flags::print_scheduler_statistics) start = Platform::GetMicroseconds();
+  Timeline::Begin("Interpret", process);
+  EnterDart(process, worker->lookup_cache());
   Interpreter interpreter(process);
   interpreter.Run();
+  // Shrink the stack of a process that is about to sleep.
+  if (Flags::shrink_idle_stacks && interpreter.IsYielded() &&
+      process->mailbox()->IsEmpty() && !process->is_debugging()) {
+    process->ShrinkStack();
+  }
   LeaveDart(process);
+  Timeline::End("Interpret");
+  worker->slices_++;
+  if (Flags::print_scheduler_statistics) {
+    worker->interpret_microseconds_ += Platform::GetMicroseconds() - start;
+  }
 
   if (interpreter.IsYielded()) {
     process->ChangeState(Process::kRunning, Process::kYielding);
@@ -517,10 +578,12 @@ Process* Scheduler::InterpretProcess(Process* process, WorkerThread* worker) {
 }
 
 void Scheduler::InterpretNestedProcess(Process* old_process, Process* process) {
+  // The nested process runs on the same thread, so it uses the same cache.
+  LookupCache* cache = old_process->lookup_cache();
   LeaveDart(old_process);
   while (true) {
     Interpreter interpreter(process);
-    EnterDart(process);
+    EnterDart(process, cache);
     interpreter.Run();
     LeaveDart(process);
 
@@ -539,7 +602,7 @@ void Scheduler::InterpretNestedProcess(Process* old_process, Process* process) {
     if (interpreter.IsYielded()) break;
     UNREACHABLE();
   }
-  EnterDart(old_process);
+  EnterDart(old_process, cache);
 }
 
 void Scheduler::HandleKilled(Process* process) {
@@ -689,6 +752,17 @@ void Scheduler::HandleEventResult(
 
 void WorkerThread::ThreadEnter() {
   Thread::SetupOSSignals();
+  if (Timeline::IsEnabled()) {
+    char name[32];
+    snprintf(name, sizeof(name), "Scheduler worker %d", index_);
+    Timeline::SetThreadName(name);
+  }
+  if (scheduler_->pin_threads_) {
+    // Go round-robin over the CPUs the process may use, which can be fewer
+    // than the hardware threads under taskset or a cgroup cpuset.
+    int cpu = Thread::GetAllowedCpu(index_);
+    if (cpu >= 0 && Thread::PinToCpu(cpu)) cpu_ = cpu;
+  }
   scheduler_->pause_monitor_->Lock();
   scheduler_->pause_monitor_->NotifyAll();
   scheduler_->pause_monitor_->Unlock();
@@ -702,10 +776,9 @@ void WorkerThread::ThreadExit() {
 }
 
 void Scheduler::NotifyInterpreterThread() {
-  Monitor* monitor = idle_monitor_;
-  monitor->Lock();
-  monitor->Notify();
-  monitor->Unlock();
+  // Only the worker holding the interpreter semaphore can be idle waiting,
+  // so waking up one is enough.
+  idle_event_.NotifyOne();
 }
 
 void Scheduler::EnqueueProcess(Process* process) {
@@ -17,6 +17,7 @@
 namespace dartino {
 
 class Heap;
+class LookupCache;
 class Object;
 class Port;
 class Process;
@@ -26,15 +27,33 @@ class WorkerThread {
  public:
   static void* RunThread(void* data);
 
-  explicit WorkerThread(Scheduler* scheduler);
+  WorkerThread(Scheduler* scheduler, int index);
   ~WorkerThread();
 
+  int index() const { return index_; }
+
+  LookupCache* lookup_cache() const { return lookup_cache_; }
+
+  void PrintStatistics();
+
  private:
+  friend class Scheduler;
+
   void RunInThread();
   void ThreadEnter();
   void ThreadExit();
 
   Scheduler* scheduler_;
+  const int index_;
+  // The CPU the worker is pinned to, or -1.
+  int cpu_;
+  // Used by all processes interpreted by this worker.
+  LookupCache* const lookup_cache_;
+
+  // Statistics. Only updated by the worker thread itself.
+  uword slices_;
+  uword idle_waits_;
+  uint64 interpret_microseconds_;
 };
 
 class ProcessVisitor {
@@ -86,9 +105,13 @@ class Scheduler {
   static void TearDown();
   static Scheduler* GlobalInstance() { return scheduler_; }
 
-  Scheduler();
+  // Worker threads are pinned to a CPU each if pin_threads is true and the
+  // platform supports it.
+  Scheduler(int thread_count, bool pin_threads);
   ~Scheduler();
 
+  int thread_count() const { return thread_count_; }
+
   void ScheduleProgram(Program* program, Process* main_process);
   void UnscheduleProgram(Program* program);
 
@@ -154,9 +177,10 @@ class Scheduler {
   static Scheduler* scheduler_;
 
   // Worker threads
-  static const int kThreadCount = 4;
-  ThreadIdentifier thread_ids_[kThreadCount];
-  WorkerThread* threads_[kThreadCount];
+  const int thread_count_;
+  const bool pin_threads_;
+  ThreadIdentifier* thread_ids_;
+  WorkerThread** threads_;
 
   Atomic<bool> interpreter_is_paused_;
   ProcessQueue ready_queue_;
@@ -169,7 +193,8 @@ class Scheduler {
 
   InterpretationBarrier interpretation_barrier_;
 
-  Monitor* idle_monitor_;
+  // Idle workers wait here for processes to become ready.
+  EventCount idle_event_;
   Semaphore interpreter_semaphore_;
 
   DispatchTable dispatch_table_;
@@ -224,8 +249,9 @@ class Scheduler {
   //
   // This function should be called just before running the interpreter.
   // See [InterpreterExecutionScope] and [NativeScope] for scoped calls to
-  // [EnterDart] and [LeaveDart].
-  void EnterDart(Process* process);
+  // [EnterDart] and [LeaveDart]. The process uses [cache] for method lookups
+  // until [LeaveDart] is called.
+  void EnterDart(Process* process, LookupCache* cache);
 
   // Prepares this scheduler and the given [process] for returning from
   // running Dart code to running native code again.
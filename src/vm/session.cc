@@ -14,6 +14,7 @@
 #include "src/shared/utils.h"
 #include "src/shared/version.h"
 
+#include "src/vm/constant_map_index.h"
 #include "src/vm/frame.h"
 #include "src/vm/heap_validator.h"
 #include "src/vm/native_interpreter.h"
@@ -586,12 +587,19 @@ SessionState* SessionState::ProcessMessage(Connection::Opcode opcode) {
       buffer.WriteInt(version_length);
       buffer.WriteString(version);
       free(compiler_version);
+      // Older compilers do not send the features they support.
+      int features = connection()->HasMoreData() ? connection()->ReadInt() : 0;
       // Send word size.
       buffer.WriteInt(kBitsPerPointer);
       // Send floating point size.
       buffer.WriteInt(kBitsPerDartinoDouble);
       // Send state
       buffer.WriteInt(Kind());
+      // Send the features enabled for the rest of the session. Older
+      // compilers ignore them.
+      int enabled_features =
+          version_match ? connection()->EnableFeatures(features) : 0;
+      buffer.WriteInt(enabled_features);
       connection()->Send(Connection::kHandShakeResult, buffer);
       if (!version_match) {
         MessageProcessingError("Error: Different compiler and VM version.\n");
@@ -776,6 +784,16 @@ SessionState* SessionState::ProcessMessage(Connection::Opcode opcode) {
       break;
     }
 
+    case Connection::kPushNewByteArray: {
+      ASSERT(!IsScheduled() || IsPaused());
+      int length;
+      uint8* bytes = connection()->ReadBytes(&length);
+      List<uint8> contents(bytes, length);
+      session()->PushNewByteArray(contents);
+      contents.Delete();
+      break;
+    }
+
     case Connection::kPushNewInstance: {
       ASSERT(!IsScheduled() || IsPaused());
       session()->PushNewInstance();
@@ -868,12 +886,73 @@ SessionState* SessionState::ProcessMessage(Connection::Opcode opcode) {
       break;
     }
 
+    // Tracepoints can be changed without a debugging session. A running
+    // program is stopped while its probes are changed.
+    case Connection::kSetTracepoint: {
+      Function* function = Function::cast(session()->Pop());
+      bool is_running = IsScheduled() && !IsPaused();
+      if (is_running) session()->PauseExecution();
+      program()->EnsureDebuggerAttached();
+      int id = program()->debug_info()->tracepoints()->Create(function);
+      if (is_running) session()->ResumeExecution();
+      WriteBuffer buffer;
+      buffer.WriteInt(id);
+      connection()->Send(Connection::kSetTracepointResult, buffer);
+      break;
+    }
+
+    case Connection::kDeleteTracepoint: {
+      int id = connection()->ReadInt();
+      ProgramDebugInfo* debug_info = program()->debug_info();
+      bool deleted = false;
+      if (debug_info != NULL) {
+        bool is_running = IsScheduled() && !IsPaused();
+        if (is_running) session()->PauseExecution();
+        deleted = debug_info->tracepoints()->Delete(id);
+        if (is_running) session()->ResumeExecution();
+      }
+      WriteBuffer buffer;
+      buffer.WriteInt(deleted ? id : -1);
+      connection()->Send(Connection::kDeleteTracepointResult, buffer);
+      break;
+    }
+
+    case Connection::kTracepointHistogramsRequest: {
+      ProgramDebugInfo* debug_info = program()->debug_info();
+      Tracepoint* first =
+          (debug_info == NULL) ? NULL : debug_info->tracepoints()->first();
+      int count = 0;
+      for (Tracepoint* tracepoint = first; tracepoint != NULL;
+           tracepoint = tracepoint->next()) {
+        ++count;
+      }
+      WriteBuffer buffer;
+      buffer.WriteInt(count);
+      buffer.WriteInt(Tracepoint::kHistogramBuckets);
+      for (Tracepoint* tracepoint = first; tracepoint != NULL;
+           tracepoint = tracepoint->next()) {
+        buffer.WriteInt(tracepoint->id());
+        buffer.WriteInt64(tracepoint->calls());
+        buffer.WriteInt64(tracepoint->total_microseconds());
+        for (int i = 0; i < Tracepoint::kHistogramBuckets; i++) {
+          buffer.WriteInt64(tracepoint->bucket(i));
+        }
+      }
+      connection()->Send(Connection::kTracepointHistograms, buffer);
+      break;
+    }
+
 #ifdef DARTINO_ENABLE_LIVE_CODING
     case Connection::kSetEntryPoint: {
       program()->set_entry(Function::cast(session()->Pop()));
       break;
     }
 
+    case Connection::kSetSourcePositions: {
+      program()->set_source_positions(Array::cast(session()->Pop()));
+      break;
+    }
+
     case Connection::kCreateSnapshot: {
       ASSERT(!IsScheduled());
       bool writeToDisk = connection()->ReadBoolean();
@@ -948,6 +1027,9 @@ Session::Session(
     program_update_error_(NULL),
     main_thread_monitor_(Platform::CreateMonitor()),
     main_thread_resume_kind_(kUnknown),
+    logpoint_monitor_(Platform::CreateMonitor()),
+    has_logpoint_thread_(false),
+    stop_logpoint_thread_(false),
     connection_listener_callback_(connection_listener_callback),
     listener_data_(listener_data) {
       program_->AddSession(this);
@@ -958,6 +1040,9 @@ Session::~Session() {
   Print::UnregisterPrintInterceptors();
 #endif  // DARTINO_ENABLE_PRINT_INTERCEPTORS
 
+  StopLogpointThread();
+  delete logpoint_monitor_;
+
   for (int i = 0; i < maps_.length(); ++i) delete maps_[i];
   maps_.Delete();
   delete main_thread_monitor_;
@@ -1045,6 +1130,7 @@ void Session::SendDartValue(Object* value) {
 }
 
 void Session::SendInstanceStructure(Instance* instance) {
+  ScopedSendBatch batch(connection_);
   WriteBuffer buffer;
   Class* klass = instance->get_class();
   buffer.WriteInt64(ClassMessage(klass));
@@ -1070,6 +1156,7 @@ void Session::SendArrayStructure(Array* array, int startIndex, int endIndex) {
     SendError(Connection::kInvalidInstanceAccess);
     return;
   }
+  ScopedSendBatch batch(connection_);
   WriteBuffer buffer;
   buffer.WriteInt(length);
   buffer.WriteInt(startIndex);
@@ -1181,10 +1268,50 @@ void Session::ProcessMessages() {
   while (true) {
     Connection::Opcode opcode = connection_->Receive();
     ScopedMonitorLock scoped_lock(main_thread_monitor_);
-    SessionState* next_state = state_->ProcessMessage(opcode);
-    if (next_state == NULL) return;
-    ChangeState(next_state);
-    if (next_state->IsTerminating()) return;
+    int batch_length;
+    uint8* batch = connection_->BatchedCommands(&batch_length);
+    if (batch != NULL) ReserveMapEntries(batch, batch_length);
+    // The rest of a batch is decoded in the same pass, without waiting for
+    // the lock again.
+    while (true) {
+      SessionState* next_state = state_->ProcessMessage(opcode);
+      if (next_state == NULL) return;
+      ChangeState(next_state);
+      if (next_state->IsTerminating()) return;
+      if (connection_->BatchedCommands(&batch_length) == NULL) break;
+      opcode = connection_->Receive();
+    }
+    map_reservations_.Clear();
+  }
+}
+
+void Session::ReserveMapEntries(uint8* commands, int length) {
+  // Count the kPopToMap commands for each map, so each map grows at most
+  // once for the whole batch.
+  map_reservations_.Clear();
+  int offset = 0;
+  while (offset + kFrameHeaderSize <= length) {
+    int payload_length = Utils::ReadInt32(commands + offset);
+    if (payload_length < 0) break;
+    Connection::Opcode opcode =
+        static_cast<Connection::Opcode>(commands[offset + 4]);
+    uint8* payload = commands + offset + kFrameHeaderSize;
+    offset += kFrameHeaderSize + payload_length;
+    if (opcode != Connection::kPopToMap || payload_length < 4 ||
+        offset > length) {
+      continue;
+    }
+    int map_index = Utils::ReadInt32(payload);
+    if (map_index < 0) continue;
+    while (static_cast<int>(map_reservations_.size()) <= map_index) {
+      map_reservations_.PushBack(0);
+    }
+    map_reservations_[map_index]++;
+  }
+  for (int i = 0; i < static_cast<int>(map_reservations_.size()); i++) {
+    if (i < maps_.length() && maps_[i] != NULL) {
+      maps_[i]->Reserve(map_reservations_[i]);
+    }
   }
 }
 
@@ -1282,6 +1409,38 @@ SessionState* SpawnedState::ProcessMessage(Connection::Opcode opcode) {
       break;
     }
 
+    case Connection::kProcessSetConditionalBreakpoint: {
+      ASSERT(IsDebuggingEnabled());
+      WriteBuffer buffer;
+      int bytecode_index = connection()->ReadInt();
+      int comparison = connection()->ReadInt();
+      int slot = connection()->ReadInt();
+      int64 value = connection()->ReadInt64();
+      int ignore_count = connection()->ReadInt();
+      bool is_logpoint = connection()->ReadBoolean();
+      int log_slot = connection()->ReadInt();
+      int max_logs_per_second = connection()->ReadInt();
+      Function* function = Function::cast(session()->Pop());
+      // Slots count words up the stack from the top, so they cannot be
+      // negative. The upper bound depends on the stack when hit.
+      bool is_valid = BreakpointCondition::IsValidComparison(comparison) &&
+                      slot >= 0 &&
+                      (log_slot == Breakpoint::kNoLogSlot || log_slot >= 0);
+      if (!is_valid) {
+        buffer.WriteInt(Breakpoint::kNoBreakpointId);
+      } else {
+        BreakpointCondition condition(
+            static_cast<BreakpointCondition::Comparison>(comparison), slot,
+            value);
+        int id = program()->debug_info()->CreateConditionalBreakpoint(
+            function, bytecode_index, condition, ignore_count, is_logpoint,
+            log_slot, max_logs_per_second);
+        buffer.WriteInt(id);
+      }
+      connection()->Send(Connection::kProcessSetBreakpoint, buffer);
+      break;
+    }
+
     case Connection::kProcessDeleteBreakpoint: {
       ASSERT(IsDebuggingEnabled());
       WriteBuffer buffer;
@@ -1458,19 +1617,19 @@ SessionState* PausedState::ProcessMessage(Connection::Opcode opcode) {
     }
 
     case Connection::kProcessAddFibersToMap: {
-      // TODO(ager): Potentially optimize this to not require a full
-      // process GC to locate the live stacks?
-      int number_of_stacks = program()->CollectMutableGarbageAndChainStacks();
-      Object* current = program()->stack_chain();
-      for (int i = 0; i < number_of_stacks; i++) {
-        Stack* stack = Stack::cast(current);
-        session()->AddToMap(session()->fibers_map_id_, i, stack);
-        current = stack->next();
-        // Unchain stacks.
-        stack->set_next(Smi::FromWord(0));
+      // The stacks are found through the coroutine registries of the
+      // processes, so no GC is needed. The most recently created
+      // coroutines come first.
+      int number_of_stacks = 0;
+      for (auto process : *program()->process_list()) {
+        CoroutineRegistry* coroutines = process->coroutines();
+        for (word i = coroutines->size() - 1; i >= 0; i--) {
+          Coroutine* coroutine = coroutines->at(i);
+          if (coroutine == NULL || !coroutine->has_stack()) continue;
+          session()->AddToMap(session()->fibers_map_id_, number_of_stacks++,
+                              coroutine->stack());
+        }
       }
-      ASSERT(current == NULL);
-      program()->ClearStackChain();
       WriteBuffer buffer;
       buffer.WriteInt(number_of_stacks);
       connection()->Send(Connection::kProcessNumberOfStacks, buffer);
@@ -1504,11 +1663,7 @@ void Session::IteratePointers(PointerVisitor* visitor) {
   IterateChangesPointers(visitor);
   for (int i = 0; i < maps_.length(); ++i) {
     ObjectMap* map = maps_[i];
-    if (map != NULL) {
-      // TODO(kasperl): Move the table clearing to a GC pre-phase.
-      map->ClearTableByObject();
-      map->IteratePointers(visitor);
-    }
+    if (map != NULL) map->IteratePointers(visitor);
   }
 }
 
@@ -1620,7 +1775,12 @@ void Session::NewMap(int map_index) {
   }
   ObjectMap* existing = maps_[map_index];
   if (existing != NULL) delete existing;
-  maps_[map_index] = new ObjectMap(64);
+  // A map created by a batch is sized for the entries the batch adds.
+  int capacity = 64;
+  if (map_index < static_cast<int>(map_reservations_.size())) {
+    capacity = Utils::Maximum(capacity, map_reservations_[map_index]);
+  }
+  maps_[map_index] = new ObjectMap(capacity);
 }
 
 void Session::DeleteMap(int map_index) {
@@ -1712,6 +1872,14 @@ void Session::PushNewTwoByteString(List<uint16> contents) {
   Push(result);
 }
 
+void Session::PushNewByteArray(List<uint8> contents) {
+  GC_AND_RETRY_ON_ALLOCATION_FAILURE(
+      result, program()->CreateByteArray(contents.length()));
+  ByteArray* array = ByteArray::cast(result);
+  memcpy(array->byte_address_for(0), contents.data(), contents.length());
+  Push(array);
+}
+
 void Session::PushNewInstance() {
   GC_AND_RETRY_ON_ALLOCATION_FAILURE(
       result, program()->CreateInstance(Class::cast(Top())));
@@ -1858,6 +2026,10 @@ void Session::PushBuiltinClass(Names::Id name, int fields) {
   Push(klass);
 }
 
+static Array* ConstantListBacking(Object* list) {
+  return Array::cast(Instance::cast(list)->GetInstanceField(0));
+}
+
 void Session::PushConstantList(int length) {
   PushNewArray(length);
   GC_AND_RETRY_ON_ALLOCATION_FAILURE(
@@ -1891,10 +2063,27 @@ void Session::PushConstantByteList(int length) {
 }
 
 void Session::PushConstantMap(int length) {
+  // The keys are below the values on the stack.
+  Array* keys = ConstantListBacking(stack_[stack_.length() - 2]);
+  int index_size = ConstantMapIndex::IndexSize(keys);
+  if (index_size == 0) {
+    Push(program()->null_object());
+  } else {
+    GC_AND_RETRY_ON_ALLOCATION_FAILURE(
+        result,
+        program()->CreateArrayWith(index_size, program()->null_object()));
+    Array* index = Array::cast(result);
+    keys = ConstantListBacking(stack_[stack_.length() - 2]);
+    ConstantMapIndex::Fill(keys, index);
+    Push(index);
+  }
+
   GC_AND_RETRY_ON_ALLOCATION_FAILURE(
       result, program()->CreateInstance(program()->constant_map_class()));
   Instance* map = Instance::cast(result);
-  ASSERT(map->get_class()->NumberOfInstanceFields() == 2);
+  ASSERT(map->get_class()->NumberOfInstanceFields() == 3);
+  // Index.
+  map->SetInstanceField(2, Pop());
   // Values.
   map->SetInstanceField(1, Pop());
   // Keys.
@@ -2144,6 +2333,72 @@ Scheduler::ProcessInterruptionEvent Session::CompileTimeError(
       process, state_->HandleCompileTimeError(process));
 }
 
+bool Session::Logpoint(Process* process, int breakpoint_id, int64 hit_count,
+                       int suppressed_count, Object* value) {
+  if (!CanHandleEvents()) return true;
+  // Only small integers are sent by value. Other objects would have to be
+  // mapped, which requires the program to be paused.
+  bool has_value = value != NULL && value->IsSmi();
+  LogpointHit hit = {breakpoint_id, process->debug_info()->process_id(),
+                     hit_count, suppressed_count, has_value,
+                     has_value ? Smi::cast(value)->value() : 0};
+  ScopedMonitorLock locker(logpoint_monitor_);
+  if (!has_logpoint_thread_) {
+    has_logpoint_thread_ = true;
+    logpoint_thread_ = Thread::Run(LogpointThread, this);
+  }
+  // Don't let a hot logpoint on a slow connection use up all memory.
+  if (pending_logpoints_.size() >=
+      static_cast<size_t>(kMaxPendingLogpoints)) {
+    return false;
+  }
+  pending_logpoints_.PushBack(hit);
+  if (pending_logpoints_.size() == 1) logpoint_monitor_->Notify();
+  return true;
+}
+
+void* Session::LogpointThread(void* data) {
+  reinterpret_cast<Session*>(data)->SendLogpoints();
+  return NULL;
+}
+
+void Session::SendLogpoints() {
+  Vector<LogpointHit> hits;
+  while (true) {
+    {
+      ScopedMonitorLock locker(logpoint_monitor_);
+      while (pending_logpoints_.IsEmpty() && !stop_logpoint_thread_) {
+        logpoint_monitor_->Wait();
+      }
+      if (pending_logpoints_.IsEmpty()) return;
+      hits.Swap(pending_logpoints_);
+    }
+    ScopedSendBatch batch(connection_);
+    for (size_t i = 0; i < hits.size(); i++) {
+      const LogpointHit& hit = hits[i];
+      WriteBuffer buffer;
+      buffer.WriteInt(hit.breakpoint_id);
+      buffer.WriteInt(hit.process_id);
+      buffer.WriteInt64(hit.hit_count);
+      buffer.WriteInt(hit.suppressed_count);
+      buffer.WriteBoolean(hit.has_value);
+      buffer.WriteInt64(hit.value);
+      connection_->Send(Connection::kProcessLogpoint, buffer);
+    }
+    hits.Clear();
+  }
+}
+
+void Session::StopLogpointThread() {
+  {
+    ScopedMonitorLock locker(logpoint_monitor_);
+    if (!has_logpoint_thread_) return;
+    stop_logpoint_thread_ = true;
+    logpoint_monitor_->Notify();
+  }
+  logpoint_thread_.Join();
+}
+
 Process* Session::GetProcess(int process_id) {
   ASSERT(!state_->IsScheduled() || state_->IsPaused());
   // TODO(zerny): Assert here and eliminate the default process.
@@ -2171,7 +2426,10 @@ void Session::ChangeState(SessionState* new_state) {
 class TransformInstancesPointerVisitor : public PointerVisitor {
  public:
   explicit TransformInstancesPointerVisitor(Heap* heap)
-      : heap_(heap) {}
+      : heap_(heap), transformed_count_(0) {}
+
+  // The number of instances that were replaced by transformed clones.
+  int transformed_count() const { return transformed_count_; }
 
   virtual void VisitClass(Object** p) {
     // The class pointer in the header of an object should not
@@ -2199,6 +2457,7 @@ class TransformInstancesPointerVisitor : public PointerVisitor {
           // old-space to avoid having up update the remembered set.
           clone = instance->CloneTransformed(heap_);
           instance->set_forwarding_address(clone);
+          transformed_count_++;
           *p = clone;
           if (GCMetadata::GetPageType(clone->address()) == kNewSpacePage) {
             GCMetadata::InsertIntoRememberedSet(current_object_address_);
@@ -2216,6 +2475,7 @@ class TransformInstancesPointerVisitor : public PointerVisitor {
  private:
   Heap* const heap_;
   uword current_object_address_;
+  int transformed_count_;
 };
 
 void Session::TransformInstances() {
@@ -2223,7 +2483,7 @@ void Session::TransformInstances() {
   // of objects *not* changing as we transform instances.
   for (int i = 0; i < maps_.length(); ++i) {
     ObjectMap* map = maps_[i];
-    ASSERT(!map->HasTableByObject());
+    if (map != NULL) map->ClearTableByObject();
   }
 
   // Deal with program space before the process spaces. This allows
@@ -2254,8 +2514,12 @@ void Session::TransformInstances() {
   process_heap->space()->CompleteTransformations(&process_heap_visitor);
   process_heap->old_space()->CompleteTransformations(&process_heap_visitor);
 
-  process_heap->space()->RebuildAfterTransformations();
-  process_heap->old_space()->RebuildAfterTransformations();
+  // The rebuild walks the heap once more to clean up after transformed
+  // instances. It is not needed if no process had any.
+  if (process_heap_visitor.transformed_count() > 0) {
+    process_heap->space()->RebuildAfterTransformations();
+    process_heap->old_space()->RebuildAfterTransformations();
+  }
 
   // Make the newly allocated (newly transformed) objects traversable again.
   process_heap->old_space()->EndTrackingAllocations();
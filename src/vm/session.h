@@ -9,6 +9,7 @@
 #include "src/vm/session_no_debugging.h"
 #else  // DARTINO_ENABLE_DEBUGGING
 
+#include "src/shared/atomic.h"
 #include "src/shared/connection.h"
 #include "src/shared/names.h"
 
@@ -17,6 +18,7 @@
 #include "src/vm/scheduler.h"
 #include "src/vm/snapshot.h"
 #include "src/vm/thread.h"
+#include "src/vm/vector.h"
 
 namespace dartino {
 
@@ -83,6 +85,15 @@ class Session {
   Scheduler::ProcessInterruptionEvent ProcessTerminated(Process* process);
   Scheduler::ProcessInterruptionEvent CompileTimeError(Process* process);
 
+  // Reports a hit of a logpoint without pausing [process]. [value] is the
+  // logged stack slot or NULL. The hit is queued and sent by the logpoint
+  // thread, so the interpreter never waits for the connection. Returns
+  // false if the hit was dropped because kMaxPendingLogpoints hits are
+  // already waiting to be sent.
+  static const int kMaxPendingLogpoints = 1024;
+  bool Logpoint(Process* process, int breakpoint_id, int64 hit_count,
+                int suppressed_count, Object* value);
+
  private:
   // SessionState private methods.
   void ChangeState(SessionState* new_state);
@@ -130,6 +141,7 @@ class Session {
   void PushNewDouble(double value);
   void PushNewOneByteString(List<uint8> contents);
   void PushNewTwoByteString(List<uint16> contents);
+  void PushNewByteArray(List<uint8> contents);
 
   // Stack: class, field<n-1>, ..., field<0>, ...
   //     -> new instance, ...
@@ -188,7 +200,8 @@ class Session {
   bool wait_for_connection_;
 
   Connection* connection_;
-  bool got_handshake_;
+  // Read by the interpreter threads to decide whether to report events.
+  Atomic<bool> got_handshake_;
   Program* program_;
   SessionState* state_;
 
@@ -208,12 +221,32 @@ class Session {
   PostponedChange* first_change_;
   PostponedChange* last_change_;
   List<ObjectMap*> maps_;
+  // The number of entries the current command batch adds to each map.
+  Vector<int> map_reservations_;
   bool has_program_update_error_;
   const char* program_update_error_;
 
   Monitor* main_thread_monitor_;
   MainThreadResumeKind main_thread_resume_kind_;
 
+  struct LogpointHit {
+    int breakpoint_id;
+    int process_id;
+    int64 hit_count;
+    int suppressed_count;
+    bool has_value;
+    int64 value;
+  };
+
+  // Logpoint hits that have not been sent yet. The logpoint thread is
+  // started by the first hit and sends all hits queued while it was sending
+  // the previous ones in a single batch.
+  Monitor* logpoint_monitor_;
+  Vector<LogpointHit> pending_logpoints_;
+  bool has_logpoint_thread_;
+  bool stop_logpoint_thread_;
+  ThreadIdentifier logpoint_thread_;
+
   ConnectionListenerCallback connection_listener_callback_;
   void* listener_data_;
 
@@ -225,6 +258,14 @@ class Session {
 
   void SignalMainThread(MainThreadResumeKind);
 
+  // Commands are framed by a 32-bit payload length and an opcode byte.
+  static const int kFrameHeaderSize = 5;
+  void ReserveMapEntries(uint8* commands, int length);
+
+  static void* LogpointThread(void* data);
+  void SendLogpoints();
+  void StopLogpointThread();
+
   void RequestExecutionPause();
   void PauseExecution();
   void ResumeExecution();
@@ -12,6 +12,7 @@
 namespace dartino {
 
 class Connection;
+class Object;
 class Process;
 class PointerVisitor;
 
@@ -68,6 +69,12 @@ class Session {
     return Scheduler::kUnhandled;
   }
 
+  bool Logpoint(Process* process, int breakpoint_id, int64 hit_count,
+                int suppressed_count, Object* value) {
+    UNIMPLEMENTED();
+    return false;
+  }
+
   bool is_debugging() const {
     UNIMPLEMENTED();
     return false;
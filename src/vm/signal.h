@@ -12,10 +12,12 @@
 #include "src/vm/refcounted.h"
 #include "src/vm/port.h"
 #include "src/vm/process_handle.h"
+#include "src/vm/slab_allocator.h"
 
 namespace dartino {
 
-class Signal : public Refcounted<Signal> {
+class Signal : public Refcounted<Signal>,
+               public SlabAllocated<SlabAllocator::kSignal> {
  public:
   // Please keep these in sync with lib/dartino/dartino.dart:SignalKind.
   enum Kind {
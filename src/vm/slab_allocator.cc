@@ -0,0 +1,319 @@
+// Copyright (c) 2016, the Dartino project authors. Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE.md file.
+
+#include "src/vm/slab_allocator.h"
+
+#include "src/shared/asan_helper.h"
+#include "src/shared/flags.h"
+#include "src/shared/utils.h"
+
+#include "src/vm/spinlock.h"
+#include "src/vm/thread.h"
+
+namespace dartino {
+
+struct FreeObject {
+  FreeObject* next;
+};
+
+// The number of objects moved between a thread cache and the shared free
+// list at a time. A thread caches at most twice that many objects of each
+// size class.
+static const int kCacheBatch = 32;
+static const int kCacheLimit = 2 * kCacheBatch;
+
+class SlabCache {
+ public:
+  SlabCache() : previous_(NULL), next_(NULL) {
+    for (int i = 0; i < SlabAllocator::kSizeClassCount; i++) {
+      free_[i] = NULL;
+      count_[i] = 0;
+    }
+    for (int i = 0; i < SlabAllocator::kCategoryCount; i++) {
+      objects_[i] = 0;
+      bytes_[i] = 0;
+    }
+  }
+
+  // Only the owning thread updates the counts, so they are updated with a
+  // plain load and store. They are atomic so the statistics can read them
+  // from another thread.
+  void Count(SlabAllocator::Category category, word objects, word bytes) {
+    objects_[category].store(objects_[category].load(kRelaxed) + objects,
+                             kRelaxed);
+    bytes_[category].store(bytes_[category].load(kRelaxed) + bytes, kRelaxed);
+  }
+
+  FreeObject* free_[SlabAllocator::kSizeClassCount];
+  int count_[SlabAllocator::kSizeClassCount];
+
+  // The objects allocated minus the objects freed by the owning thread.
+  Atomic<word> objects_[SlabAllocator::kCategoryCount];
+  Atomic<word> bytes_[SlabAllocator::kCategoryCount];
+
+  // Links in the list of all thread caches.
+  SlabCache* previous_;
+  SlabCache* next_;
+};
+
+// All thread caches that have not been released yet, so their counts can be
+// added up for the statistics.
+static Spinlock caches_lock;
+static SlabCache* caches = NULL;
+
+static void RegisterCache(SlabCache* cache) {
+  ScopedSpinlock locker(&caches_lock);
+  cache->next_ = caches;
+  if (caches != NULL) caches->previous_ = cache;
+  caches = cache;
+}
+
+// Must be called with caches_lock held.
+static void UnlinkCache(SlabCache* cache) {
+  if (cache->previous_ != NULL) {
+    cache->previous_->next_ = cache->next_;
+  } else {
+    caches = cache->next_;
+  }
+  if (cache->next_ != NULL) cache->next_->previous_ = cache->previous_;
+}
+
+// The free lists are only initialized by the zero-initialization of static
+// storage, so objects can be allocated before static constructors run.
+struct SharedFreeList {
+  Spinlock lock;
+  FreeObject* first;
+};
+
+static SharedFreeList shared_free_lists[SlabAllocator::kSizeClassCount];
+static Atomic<uword> reserved_slab_bytes;
+
+static const char* kCategoryNames[] = {
+#define CATEGORY_NAME(name) #name,
+    SLAB_CATEGORIES_DO(CATEGORY_NAME)
+#undef CATEGORY_NAME
+};
+
+Atomic<bool> SlabAllocator::thread_caches_enabled_(false);
+Atomic<word> SlabAllocator::objects_[kCategoryCount];
+Atomic<word> SlabAllocator::bytes_[kCategoryCount];
+
+static int SizeClass(size_t size) {
+  ASSERT(size > 0 && size <= SlabAllocator::kMaxSize);
+  return (size - 1) / SlabAllocator::kGranularity;
+}
+
+static void AddSlab(int size_class) {
+  int object_size = (size_class + 1) * SlabAllocator::kGranularity;
+  char* slab = static_cast<char*>(malloc(SlabAllocator::kSlabSize));
+  if (slab == NULL) FATAL("Out of memory");
+  reserved_slab_bytes.fetch_add(SlabAllocator::kSlabSize, kRelaxed);
+
+  int count = SlabAllocator::kSlabSize / object_size;
+  FreeObject* first = reinterpret_cast<FreeObject*>(slab);
+  FreeObject* last = first;
+  for (int i = 1; i < count; i++) {
+    FreeObject* next = reinterpret_cast<FreeObject*>(slab + i * object_size);
+    last->next = next;
+    last = next;
+  }
+
+  SharedFreeList* list = &shared_free_lists[size_class];
+  ScopedSpinlock locker(&list->lock);
+  last->next = list->first;
+  list->first = first;
+}
+
+// Takes up to [count] objects off the shared free list of the size class
+// and stores the number taken in [taken].
+static FreeObject* TakeShared(int size_class, int count, int* taken) {
+  SharedFreeList* list = &shared_free_lists[size_class];
+  while (true) {
+    {
+      ScopedSpinlock locker(&list->lock);
+      FreeObject* first = list->first;
+      if (first != NULL) {
+        FreeObject* last = first;
+        int n = 1;
+        while (n < count && last->next != NULL) {
+          last = last->next;
+          n++;
+        }
+        list->first = last->next;
+        last->next = NULL;
+        *taken = n;
+        return first;
+      }
+    }
+    // Slabs are allocated without holding the lock.
+    AddSlab(size_class);
+  }
+}
+
+static void ReturnShared(int size_class, FreeObject* first, FreeObject* last) {
+  SharedFreeList* list = &shared_free_lists[size_class];
+  ScopedSpinlock locker(&list->lock);
+  last->next = list->first;
+  list->first = first;
+}
+
+static FreeObject* LastOf(FreeObject* object) {
+  while (object->next != NULL) object = object->next;
+  return object;
+}
+
+void SlabAllocator::Setup() {
+#if defined(DARTINO_TARGET_OS_POSIX)
+  thread_caches_enabled_ = true;
+#endif
+}
+
+void SlabAllocator::TearDown() {
+  if (Flags::print_heap_statistics) PrintStatistics();
+  if (!thread_caches_enabled_) return;
+  thread_caches_enabled_ = false;
+  // The VM threads have been joined and released their caches when they
+  // exited. Other threads may still be using theirs, so only the cache of
+  // the calling thread is drained here.
+  SlabCache* cache = Thread::GetSlabCache();
+  if (cache != NULL) {
+    Thread::SetSlabCache(NULL);
+    ReleaseCache(cache);
+  }
+}
+
+SlabCache* SlabAllocator::CurrentCache() {
+  if (!thread_caches_enabled_.load(kRelaxed)) return NULL;
+  SlabCache* cache = Thread::GetSlabCache();
+  if (cache == NULL) {
+    cache = new SlabCache();
+    RegisterCache(cache);
+    Thread::SetSlabCache(cache);
+  }
+  return cache;
+}
+
+void SlabAllocator::Count(SlabCache* cache, Category category, word objects,
+                          word bytes) {
+  if (cache != NULL) {
+    cache->Count(category, objects, bytes);
+  } else {
+    objects_[category].fetch_add(objects, kRelaxed);
+    bytes_[category].fetch_add(bytes, kRelaxed);
+  }
+}
+
+void* SlabAllocator::Allocate(Category category, size_t size) {
+  SlabCache* cache = CurrentCache();
+  Count(cache, category, 1, size);
+#ifdef USING_ADDRESS_SANITIZER
+  // Leave reuse to ASan, so use-after-free is still detected.
+  bool use_malloc = true;
+#else
+  bool use_malloc = size > kMaxSize;
+#endif
+  if (use_malloc) {
+    void* result = malloc(size);
+    if (result == NULL) FATAL("Out of memory");
+    return result;
+  }
+
+  int size_class = SizeClass(size);
+  int taken;
+  if (cache == NULL) return TakeShared(size_class, 1, &taken);
+
+  FreeObject* object = cache->free_[size_class];
+  if (object == NULL) {
+    object = TakeShared(size_class, kCacheBatch, &taken);
+    cache->count_[size_class] = taken;
+  }
+  cache->free_[size_class] = object->next;
+  cache->count_[size_class]--;
+  return object;
+}
+
+void SlabAllocator::Free(Category category, void* pointer, size_t size) {
+  if (pointer == NULL) return;
+  SlabCache* cache = CurrentCache();
+  Count(cache, category, -1, -static_cast<word>(size));
+#ifdef USING_ADDRESS_SANITIZER
+  bool use_malloc = true;
+#else
+  bool use_malloc = size > kMaxSize;
+#endif
+  if (use_malloc) {
+    free(pointer);
+    return;
+  }
+
+  int size_class = SizeClass(size);
+  FreeObject* object = static_cast<FreeObject*>(pointer);
+  if (cache == NULL) {
+    object->next = NULL;
+    ReturnShared(size_class, object, object);
+    return;
+  }
+
+  object->next = cache->free_[size_class];
+  cache->free_[size_class] = object;
+  if (++cache->count_[size_class] > kCacheLimit) {
+    // Keep the most recently freed objects and return the rest.
+    FreeObject* last_kept = object;
+    for (int i = 1; i < kCacheBatch; i++) last_kept = last_kept->next;
+    FreeObject* first = last_kept->next;
+    last_kept->next = NULL;
+    ReturnShared(size_class, first, LastOf(first));
+    cache->count_[size_class] = kCacheBatch;
+  }
+}
+
+void SlabAllocator::ReleaseCache(SlabCache* cache) {
+  {
+    // Move the counts under the lock, so readers count them exactly once.
+    ScopedSpinlock locker(&caches_lock);
+    UnlinkCache(cache);
+    for (int i = 0; i < kCategoryCount; i++) {
+      objects_[i].fetch_add(cache->objects_[i], kRelaxed);
+      bytes_[i].fetch_add(cache->bytes_[i], kRelaxed);
+    }
+  }
+  for (int i = 0; i < kSizeClassCount; i++) {
+    FreeObject* first = cache->free_[i];
+    if (first != NULL) ReturnShared(i, first, LastOf(first));
+  }
+  delete cache;
+}
+
+word SlabAllocator::objects(Category category) {
+  ScopedSpinlock locker(&caches_lock);
+  word result = objects_[category].load(kRelaxed);
+  for (SlabCache* cache = caches; cache != NULL; cache = cache->next_) {
+    result += cache->objects_[category].load(kRelaxed);
+  }
+  return result;
+}
+
+word SlabAllocator::bytes(Category category) {
+  ScopedSpinlock locker(&caches_lock);
+  word result = bytes_[category].load(kRelaxed);
+  for (SlabCache* cache = caches; cache != NULL; cache = cache->next_) {
+    result += cache->bytes_[category].load(kRelaxed);
+  }
+  return result;
+}
+
+uword SlabAllocator::slab_bytes() {
+  return reserved_slab_bytes.load(kRelaxed);
+}
+
+void SlabAllocator::PrintStatistics() {
+  Print::Error("Native memory: %lu bytes in slabs\n", slab_bytes());
+  for (int i = 0; i < kCategoryCount; i++) {
+    Category category = static_cast<Category>(i);
+    Print::Error("  %s: %ld objects, %ld bytes\n", kCategoryNames[i],
+                 objects(category), bytes(category));
+  }
+}
+
+}  // namespace dartino
@@ -0,0 +1,100 @@
+// Copyright (c) 2016, the Dartino project authors. Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE.md file.
+
+#ifndef SRC_VM_SLAB_ALLOCATOR_H_
+#define SRC_VM_SLAB_ALLOCATOR_H_
+
+#include <stdlib.h>
+
+#include "src/shared/atomic.h"
+#include "src/shared/globals.h"
+
+namespace dartino {
+
+class SlabCache;
+
+// The VM-internal classes that are allocated from slabs. Each category is
+// accounted separately.
+#define SLAB_CATEGORIES_DO(V) \
+  V(WeakPointer)              \
+  V(EventListener)            \
+  V(Signal)                   \
+  V(ProcessHandle)            \
+  V(Chunk)                    \
+  V(Message)
+
+// Allocator for the small, short-lived C++ objects the VM creates on hot
+// paths. Objects are carved out of 64KB slabs and kept on free lists per
+// size class, so they never go back to malloc.
+//
+// Each thread caches a few free objects of every size class, so the shared
+// free lists are only locked when a thread cache runs empty or overflows.
+// Thread caches are only used between [Setup] and [TearDown]; outside of
+// that all threads use the shared free lists. [TearDown] must run after the
+// VM threads have been joined and before the thread-local keys are deleted.
+//
+// The allocation statistics are also kept per thread cache and only added
+// up when they are read, so allocating does not touch shared counters.
+class SlabAllocator {
+ public:
+  enum Category {
+#define DECLARE_CATEGORY(name) k##name,
+    SLAB_CATEGORIES_DO(DECLARE_CATEGORY)
+#undef DECLARE_CATEGORY
+    kCategoryCount
+  };
+
+  // Sizes are rounded up to a multiple of kGranularity. Larger objects are
+  // allocated with malloc.
+  static const int kGranularity = 2 * sizeof(void*);
+  static const int kMaxSize = 16 * kGranularity;
+  static const int kSizeClassCount = kMaxSize / kGranularity;
+  static const int kSlabSize = 64 * KB;
+
+  static void Setup();
+  static void TearDown();
+
+  static void* Allocate(Category category, size_t size);
+  static void Free(Category category, void* pointer, size_t size);
+
+  // The objects of a category that are currently allocated.
+  static word objects(Category category);
+  static word bytes(Category category);
+
+  // The memory reserved for slabs.
+  static uword slab_bytes();
+
+  static void PrintStatistics();
+
+  // Returns the objects cached by an exiting thread to the shared free
+  // lists and deletes the cache.
+  static void ReleaseCache(SlabCache* cache);
+
+ private:
+  static SlabCache* CurrentCache();
+  static void Count(SlabCache* cache, Category category, word objects,
+                    word bytes);
+
+  static Atomic<bool> thread_caches_enabled_;
+  // The counts of threads without a cache and of released caches.
+  static Atomic<word> objects_[kCategoryCount];
+  static Atomic<word> bytes_[kCategoryCount];
+};
+
+// Base class for classes that are allocated with the slab allocator.
+template <SlabAllocator::Category category>
+class SlabAllocated {
+ public:
+  static void* operator new(size_t size) {
+    return SlabAllocator::Allocate(category, size);
+  }
+
+  static void operator delete(void* pointer, size_t size) {
+    SlabAllocator::Free(category, pointer, size);
+  }
+};
+
+}  // namespace dartino
+
+#endif  // SRC_VM_SLAB_ALLOCATOR_H_
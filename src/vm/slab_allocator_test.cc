@@ -0,0 +1,78 @@
+// Copyright (c) 2016, the Dartino project authors. Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE.md file.
+
+#include "src/shared/asan_helper.h"
+#include "src/shared/assert.h"
+#include "src/shared/test_case.h"
+
+#include "src/vm/slab_allocator.h"
+#include "src/vm/thread.h"
+
+namespace dartino {
+
+class SmallObject : public SlabAllocated<SlabAllocator::kMessage> {
+ public:
+  explicit SmallObject(word value) : value_(value) {}
+
+  word value() const { return value_; }
+
+ private:
+  word value_;
+  word padding_[3];
+};
+
+class LargeObject : public SlabAllocated<SlabAllocator::kMessage> {
+ private:
+  char data_[SlabAllocator::kMaxSize + 1];
+};
+
+static const int kObjects = 1000;
+
+static void* AllocateAndFree(void* data) {
+  SmallObject* objects[kObjects];
+  for (int round = 0; round < 10; round++) {
+    for (int i = 0; i < kObjects; i++) objects[i] = new SmallObject(i);
+    for (int i = 0; i < kObjects; i++) {
+      EXPECT_EQ(i, objects[i]->value());
+      delete objects[i];
+    }
+  }
+  return NULL;
+}
+
+TEST_CASE(SlabAllocatorAccounting) {
+  SlabAllocator::Category category = SlabAllocator::kMessage;
+  word objects = SlabAllocator::objects(category);
+  word bytes = SlabAllocator::bytes(category);
+
+  SmallObject* small = new SmallObject(42);
+  LargeObject* large = new LargeObject();
+  EXPECT_EQ(objects + 2, SlabAllocator::objects(category));
+  word size = sizeof(SmallObject) + sizeof(LargeObject);
+  EXPECT_EQ(bytes + size, SlabAllocator::bytes(category));
+  EXPECT(SlabAllocator::slab_bytes() > 0);
+
+  delete large;
+  delete small;
+  EXPECT_EQ(objects, SlabAllocator::objects(category));
+  EXPECT_EQ(bytes, SlabAllocator::bytes(category));
+
+#ifndef USING_ADDRESS_SANITIZER
+  // Freed objects are reused.
+  SmallObject* reused = new SmallObject(0);
+  EXPECT(reused == small);
+  delete reused;
+#endif
+}
+
+TEST_CASE(SlabAllocatorThreads) {
+  word objects = SlabAllocator::objects(SlabAllocator::kMessage);
+  ThreadIdentifier threads[4];
+  for (int i = 0; i < 4; i++) threads[i] = Thread::Run(AllocateAndFree);
+  AllocateAndFree(NULL);
+  for (int i = 0; i < 4; i++) threads[i].Join();
+  EXPECT_EQ(objects, SlabAllocator::objects(SlabAllocator::kMessage));
+}
+
+}  // namespace dartino
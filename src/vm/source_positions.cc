@@ -0,0 +1,109 @@
+// Copyright (c) 2016, the Dartino project authors. Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE.md file.
+
+#include "src/vm/source_positions.h"
+
+#include "src/shared/utils.h"
+#include "src/vm/object.h"
+#include "src/vm/program.h"
+
+namespace dartino {
+
+SourcePositionTable::SourcePositionTable(const uint8* data, int length)
+    : data_(data), length_(length), name_(0), name_length_(0), entries_(-1) {
+  int position = 0;
+  uword name_length;
+  if (!ReadUnsigned(&position, &name_length)) return;
+  if (name_length > static_cast<uword>(length_ - position)) return;
+  name_ = position;
+  name_length_ = static_cast<int>(name_length);
+  entries_ = position + name_length_;
+}
+
+bool SourcePositionTable::Lookup(int bytecode_index, int* file, int* line,
+                                 int* column) const {
+  if (!is_valid()) return false;
+  int position = entries_;
+  word current_index = 0;
+  word current_file = 0;
+  word current_line = 0;
+  word current_column = 0;
+  bool found = false;
+  uword value;
+  while (ReadUnsigned(&position, &value)) {
+    current_index += value >> 1;
+    if (current_index > bytecode_index) break;
+    if ((value & 1) != 0) {
+      uword new_file;
+      if (!ReadUnsigned(&position, &new_file)) return false;
+      current_file = new_file;
+    }
+    uword line_delta;
+    uword new_column;
+    if (!ReadUnsigned(&position, &line_delta) ||
+        !ReadUnsigned(&position, &new_column)) {
+      return false;
+    }
+    // Undo the zigzag encoding.
+    current_line += static_cast<word>(line_delta >> 1) ^
+                    -static_cast<word>(line_delta & 1);
+    current_column = new_column;
+    found = true;
+  }
+  if (!found || current_file == 0) return false;
+  *file = current_file - 1;
+  *line = current_line;
+  *column = current_column;
+  return true;
+}
+
+bool SourcePositionTable::ReadUnsigned(int* position, uword* value) const {
+  uword result = 0;
+  int shift = 0;
+  while (*position < length_ && shift < kBitsPerWord) {
+    uint8 byte = data_[(*position)++];
+    result |= static_cast<uword>(byte & 0x7f) << shift;
+    if ((byte & 0x80) == 0) {
+      *value = result;
+      return true;
+    }
+    shift += 7;
+  }
+  return false;
+}
+
+bool SourcePositions::PrintFrame(Program* program, int index,
+                                 Function* function, int bytecode_index) {
+  // The tables are an array of the file names followed by pairs of a
+  // function and its table. They are only used for printing uncaught
+  // exceptions, so a linear search is good enough.
+  Object* positions = program->source_positions();
+  if (!positions->IsArray()) return false;
+  Array* array = Array::cast(positions);
+  if (array->length() == 0 || !array->get(0)->IsArray()) return false;
+  Array* files = Array::cast(array->get(0));
+  for (int i = 1; i + 1 < array->length(); i += 2) {
+    if (array->get(i) != function) continue;
+    if (!array->get(i + 1)->IsByteArray()) return false;
+    ByteArray* bytes = ByteArray::cast(array->get(i + 1));
+    SourcePositionTable table(bytes->byte_address_for(0), bytes->length());
+    if (!table.is_valid()) return false;
+    int file;
+    int line;
+    int column;
+    if (table.Lookup(bytecode_index, &file, &line, &column) &&
+        file < files->length() && files->get(file)->IsOneByteString()) {
+      OneByteString* name = OneByteString::cast(files->get(file));
+      Print::Out("   %d: %.*s %.*s:%d:%d\n", index, table.name_length(),
+                 table.name(), name->length(), name->byte_address_for(0),
+                 line, column);
+    } else {
+      Print::Out("   %d: %.*s\n", index, table.name_length(), table.name());
+    }
+    return true;
+  }
+  return false;
+}
+
+}  // namespace dartino
@@ -0,0 +1,66 @@
+// Copyright (c) 2016, the Dartino project authors. Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE.md file.
+
+#ifndef SRC_VM_SOURCE_POSITIONS_H_
+#define SRC_VM_SOURCE_POSITIONS_H_
+
+#include "src/shared/globals.h"
+
+namespace dartino {
+
+class Function;
+class Program;
+
+// The source position table of a single function. Tables are only embedded
+// in snapshots exported with --embed-source-positions, so that uncaught
+// exceptions can be symbolised without the compiler.
+//
+// A table is a sequence of unsigned LEB128 numbers: the length of the
+// function name, the bytes of the name and then one entry per change of
+// source position. An entry is the bytecode index delta shifted left by
+// one, the new file index if the low bit of the delta is set, the zigzag
+// encoded line delta and the column. File index 0 marks bytecodes without
+// a known position, the other file indices are one more than the index in
+// the file name array. Lines and columns start at 1.
+//
+// The encoder in pkg/dartino_compiler/lib/src/source_positions.dart must be
+// kept in sync with this format.
+class SourcePositionTable {
+ public:
+  SourcePositionTable(const uint8* data, int length);
+
+  // Is the name of the function well formed?
+  bool is_valid() const { return entries_ >= 0; }
+
+  const uint8* name() const { return data_ + name_; }
+  int name_length() const { return name_length_; }
+
+  // Finds the position of the last entry at or before [bytecode_index].
+  // Returns false if there is none or it has no known position.
+  bool Lookup(int bytecode_index, int* file, int* line, int* column) const;
+
+ private:
+  const uint8* data_;
+  int length_;
+  int name_;
+  int name_length_;
+  // The offset of the first entry or -1 if the table is malformed.
+  int entries_;
+
+  // Reads a LEB128 number at [*position]. Returns false at the end of the
+  // table.
+  bool ReadUnsigned(int* position, uword* value) const;
+};
+
+class SourcePositions {
+ public:
+  // Prints frame [index] as "name file:line:column" if [program] has
+  // source positions for [function]. Returns false otherwise.
+  static bool PrintFrame(Program* program, int index, Function* function,
+                         int bytecode_index);
+};
+
+}  // namespace dartino
+
+#endif  // SRC_VM_SOURCE_POSITIONS_H_
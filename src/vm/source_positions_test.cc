@@ -0,0 +1,79 @@
+// Copyright (c) 2016, the Dartino project authors. Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE.md file.
+
+#include "src/shared/assert.h"
+#include "src/shared/test_case.h"
+
+#include "src/vm/source_positions.h"
+
+namespace dartino {
+
+static void ExpectPosition(const SourcePositionTable& table,
+                           int bytecode_index, int file, int line,
+                           int column) {
+  int actual_file = -1;
+  int actual_line = -1;
+  int actual_column = -1;
+  EXPECT(table.Lookup(bytecode_index, &actual_file, &actual_line,
+                      &actual_column));
+  EXPECT_EQ(file, actual_file);
+  EXPECT_EQ(line, actual_line);
+  EXPECT_EQ(column, actual_column);
+}
+
+TEST_CASE(SourcePositionTableLookup) {
+  const uint8 data[] = {
+    3, 'f', 'o', 'o',
+    // Bytecode 2 in file 0 at 10:5.
+    (2 << 1) | 1, 1, 20, 5,
+    // Bytecode 7 at 9:3.
+    5 << 1, 1, 3,
+  };
+  SourcePositionTable table(data, sizeof(data));
+  EXPECT(table.is_valid());
+  EXPECT_EQ(3, table.name_length());
+  EXPECT_EQ('f', table.name()[0]);
+
+  int file, line, column;
+  EXPECT(!table.Lookup(0, &file, &line, &column));
+  EXPECT(!table.Lookup(1, &file, &line, &column));
+  ExpectPosition(table, 2, 0, 10, 5);
+  ExpectPosition(table, 6, 0, 10, 5);
+  ExpectPosition(table, 7, 0, 9, 3);
+  ExpectPosition(table, 1000, 0, 9, 3);
+}
+
+TEST_CASE(SourcePositionTableUnknownPosition) {
+  const uint8 data[] = {
+    0,
+    // Bytecode 0 in file 1 at 1:1.
+    1, 2, 2, 1,
+    // Bytecode 200 has no position.
+    0x91, 0x03, 0, 0, 0,
+    // Bytecode 201 in file 1 at 2:1.
+    3, 2, 2, 1,
+  };
+  SourcePositionTable table(data, sizeof(data));
+  EXPECT(table.is_valid());
+  EXPECT_EQ(0, table.name_length());
+  ExpectPosition(table, 199, 1, 1, 1);
+  int file, line, column;
+  EXPECT(!table.Lookup(200, &file, &line, &column));
+  ExpectPosition(table, 201, 1, 2, 1);
+}
+
+TEST_CASE(SourcePositionTableMalformed) {
+  const uint8 long_name[] = { 5, 'a', 'b' };
+  EXPECT(!SourcePositionTable(long_name, sizeof(long_name)).is_valid());
+  const uint8 truncated_number[] = { 0x80 };
+  EXPECT(!SourcePositionTable(truncated_number, 1).is_valid());
+
+  const uint8 truncated_entry[] = { 0, 1, 1, 2 };
+  SourcePositionTable table(truncated_entry, sizeof(truncated_entry));
+  EXPECT(table.is_valid());
+  int file, line, column;
+  EXPECT(!table.Lookup(0, &file, &line, &column));
+}
+
+}  // namespace dartino
@@ -0,0 +1,82 @@
+// Copyright (c) 2016, the Dartino project authors. Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE.md file.
+
+#include "src/vm/spinlock.h"
+
+#include "src/shared/flags.h"
+#include "src/shared/utils.h"
+
+#include "src/vm/metrics.h"
+#include "src/vm/thread.h"
+
+#if defined(_MSC_VER) && \
+    (defined(DARTINO_TARGET_IA32) || defined(DARTINO_TARGET_X64))
+#include <intrin.h>
+#endif
+
+namespace dartino {
+
+// The number of pause hints to spin for before giving up the time slice.
+static const int kMaxSpins = 1024;
+static const int kMaxBackoff = 64;
+
+static MetricStripes<uword> contended_locks_stripes;
+static MetricStripes<uword> spins_stripes;
+static MetricStripes<uword> yields_stripes;
+
+// Tells the CPU that we are in a spin loop, so it can save power and give
+// the other hardware thread of the core priority.
+static inline void Pause() {
+#if defined(_MSC_VER)
+#if defined(DARTINO_TARGET_IA32) || defined(DARTINO_TARGET_X64)
+  _mm_pause();
+#endif
+#elif defined(DARTINO_TARGET_IA32) || defined(DARTINO_TARGET_X64)
+  __asm__ __volatile__("pause");
+#elif defined(DARTINO_TARGET_ARM64) || \
+    (defined(DARTINO_TARGET_ARM) && defined(__ARM_ARCH) && __ARM_ARCH >= 7)
+  __asm__ __volatile__("yield");
+#endif
+}
+
+void Spinlock::LockSlow() {
+  int spins = 0;
+  int yields = 0;
+  int backoff = 1;
+  do {
+    // Wait for the lock to look free before retrying the exchange, so the
+    // waiting threads don't keep stealing the cache line from the holder.
+    while (is_locked_.load(kRelaxed)) {
+      if (spins < kMaxSpins) {
+        for (int i = 0; i < backoff; i++) Pause();
+        spins += backoff;
+        backoff = Utils::Minimum(backoff * 2, kMaxBackoff);
+      } else {
+        Thread::YieldCurrentThread();
+        yields++;
+      }
+    }
+  } while (is_locked_.exchange(true, kAcquire));
+
+  if (Flags::print_lock_statistics) {
+    contended_locks_stripes.Add(this, 1);
+    spins_stripes.Add(this, spins);
+    if (yields > 0) yields_stripes.Add(this, yields);
+  }
+}
+
+uword Spinlock::contended_locks() { return contended_locks_stripes.Sum(); }
+
+uword Spinlock::spins() { return spins_stripes.Sum(); }
+
+uword Spinlock::yields() { return yields_stripes.Sum(); }
+
+void Spinlock::PrintStatistics() {
+  Print::Error("Spinlocks: %lu contended locks, %lu spins, %lu yields\n",
+               static_cast<unsigned long>(contended_locks()),  // NOLINT
+               static_cast<unsigned long>(spins()),            // NOLINT
+               static_cast<unsigned long>(yields()));          // NOLINT
+}
+
+}  // namespace dartino
@@ -29,6 +29,8 @@ class ThreadIdentifier;
 
 // Forward declaration.
 class Process;
+class SlabCache;
+class TimelineBuffer;
 
 // Thread are started using the static Thread::Run method.
 class Thread {
@@ -46,9 +48,29 @@ class Thread {
   static void SetProcess(Process* process);
   static Process* GetProcess();
 
+  // TLS accessors for the timeline event buffer of the current thread.
+  static void SetTimelineBuffer(TimelineBuffer* buffer);
+  static TimelineBuffer* GetTimelineBuffer();
+
+  // TLS accessors for the slab allocator cache of the current thread. The
+  // cache is released when the thread exits.
+  static void SetSlabCache(SlabCache* cache);
+  static SlabCache* GetSlabCache();
+
   typedef void* (*RunSignature)(void*);
   static ThreadIdentifier Run(RunSignature run, void* data = NULL);
 
+  // Lets the OS run another thread before continuing this one.
+  static void YieldCurrentThread();
+
+  // Restricts the current thread to run on the given CPU. Returns false if
+  // that is not supported or failed.
+  static bool PinToCpu(int cpu);
+
+  // Returns the [index]th CPU, modulo their number, of the CPUs the process
+  // is allowed to run on, or -1 if they are not known.
+  static int GetAllowedCpu(int index);
+
  private:
   DISALLOW_ALLOCATION();
 };
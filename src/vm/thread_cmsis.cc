@@ -36,6 +36,24 @@ Process* Thread::GetProcess() {
   return NULL;
 }
 
+void Thread::SetTimelineBuffer(TimelineBuffer* buffer) {
+  // Unused since the timeline is not available on cmsis.
+}
+
+TimelineBuffer* Thread::GetTimelineBuffer() {
+  // Unused since the timeline is not available on cmsis.
+  return NULL;
+}
+
+void Thread::SetSlabCache(SlabCache* cache) {
+  // Unused since thread caches are not used on cmsis.
+}
+
+SlabCache* Thread::GetSlabCache() {
+  // Unused since thread caches are not used on cmsis.
+  return NULL;
+}
+
 bool Thread::IsCurrent(const ThreadIdentifier* thread) {
   return thread->IsSelf();
 }
@@ -82,6 +100,12 @@ ThreadIdentifier Thread::Run(RunSignature run, void* data) {
   return ThreadIdentifier(thread);
 }
 
+void Thread::YieldCurrentThread() { osThreadYield(); }
+
+bool Thread::PinToCpu(int cpu) { return false; }
+
+int Thread::GetAllowedCpu(int index) { return -1; }
+
 }  // namespace dartino
 
 #endif  // defined(DARTINO_TARGET_OS_CMSIS)
@@ -22,6 +22,24 @@ Process* Thread::GetProcess() {
   return NULL;
 }
 
+void Thread::SetTimelineBuffer(TimelineBuffer* buffer) {
+  // Unused since the timeline is not available on LK.
+}
+
+TimelineBuffer* Thread::GetTimelineBuffer() {
+  // Unused since the timeline is not available on LK.
+  return NULL;
+}
+
+void Thread::SetSlabCache(SlabCache* cache) {
+  // Unused since thread caches are not used on LK.
+}
+
+SlabCache* Thread::GetSlabCache() {
+  // Unused since thread caches are not used on LK.
+  return NULL;
+}
+
 bool Thread::IsCurrent(const ThreadIdentifier* thread) {
   return thread->IsSelf();
 }
@@ -50,6 +68,12 @@ ThreadIdentifier Thread::Run(RunSignature run, void* data) {
   return ThreadIdentifier(thread);
 }
 
+void Thread::YieldCurrentThread() { thread_yield(); }
+
+bool Thread::PinToCpu(int cpu) { return false; }
+
+int Thread::GetAllowedCpu(int index) { return -1; }
+
 }  // namespace dartino
 
 #endif  // defined(DARTINO_TARGET_OS_LK)
@@ -7,12 +7,15 @@
 #include "src/vm/thread.h"  // NOLINT we don't include thread_posix.h.
 
 #include <errno.h>
+#include <sched.h>
 #include <stdio.h>
 #include <sys/time.h>
+#include <unistd.h>
 
 #include "src/shared/platform.h"
 #include "src/shared/utils.h"
 
+#include "src/vm/slab_allocator.h"
 #include "src/vm/tick_sampler.h"
 
 namespace dartino {
@@ -22,6 +25,8 @@ bool Thread::IsCurrent(const ThreadIdentifier* thread) {
 }
 
 static pthread_key_t thr_id_key;
+static pthread_key_t timeline_key;
+static pthread_key_t slab_cache_key;
 
 void Thread::SetProcess(Process* process) {
   pthread_setspecific(thr_id_key, static_cast<void*>(process));
@@ -31,14 +36,38 @@ Process* Thread::GetProcess() {
   return static_cast<Process*>(pthread_getspecific(thr_id_key));
 }
 
+void Thread::SetTimelineBuffer(TimelineBuffer* buffer) {
+  pthread_setspecific(timeline_key, static_cast<void*>(buffer));
+}
+
+TimelineBuffer* Thread::GetTimelineBuffer() {
+  return static_cast<TimelineBuffer*>(pthread_getspecific(timeline_key));
+}
+
+void Thread::SetSlabCache(SlabCache* cache) {
+  pthread_setspecific(slab_cache_key, static_cast<void*>(cache));
+}
+
+SlabCache* Thread::GetSlabCache() {
+  return static_cast<SlabCache*>(pthread_getspecific(slab_cache_key));
+}
+
+static void ReleaseSlabCache(void* cache) {
+  SlabAllocator::ReleaseCache(static_cast<SlabCache*>(cache));
+}
+
 void Thread::Setup() {
-  if (pthread_key_create(&thr_id_key, NULL) != 0) {
+  if (pthread_key_create(&thr_id_key, NULL) != 0 ||
+      pthread_key_create(&timeline_key, NULL) != 0 ||
+      pthread_key_create(&slab_cache_key, ReleaseSlabCache) != 0) {
     FATAL("Failed to create thread local key");
   }
 }
 
 void Thread::TearDown() {
-  if (pthread_key_delete(thr_id_key) != 0) {
+  if (pthread_key_delete(thr_id_key) != 0 ||
+      pthread_key_delete(timeline_key) != 0 ||
+      pthread_key_delete(slab_cache_key) != 0) {
     FATAL("Failed to delete thread local key");
   }
 }
@@ -80,6 +109,37 @@ ThreadIdentifier Thread::Run(RunSignature run, void* data) {
   return ThreadIdentifier(thread);
 }
 
+void Thread::YieldCurrentThread() { sched_yield(); }
+
+bool Thread::PinToCpu(int cpu) {
+#if defined(DARTINO_TARGET_OS_LINUX)
+  cpu_set_t cpus;
+  CPU_ZERO(&cpus);
+  CPU_SET(cpu, &cpus);
+  return sched_setaffinity(0, sizeof(cpus), &cpus) == 0;
+#else
+  // Mac OS X only supports affinity hints between threads.
+  return false;
+#endif
+}
+
+int Thread::GetAllowedCpu(int index) {
+#if defined(DARTINO_TARGET_OS_LINUX)
+  // Ask for the main thread's mask, which worker threads have not narrowed.
+  cpu_set_t cpus;
+  if (sched_getaffinity(getpid(), sizeof(cpus), &cpus) != 0) return -1;
+  int count = CPU_COUNT(&cpus);
+  if (count == 0) return -1;
+  int remaining = index % count;
+  for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+    if (CPU_ISSET(cpu, &cpus) && remaining-- == 0) return cpu;
+  }
+  return -1;
+#else
+  return -1;
+#endif
+}
+
 }  // namespace dartino
 
 #endif  // defined(DARTINO_TARGET_OS_POSIX)
@@ -22,6 +22,24 @@ Process* Thread::GetProcess() {
   return NULL;
 }
 
+void Thread::SetTimelineBuffer(TimelineBuffer* buffer) {
+  // Unused since the timeline is not available on Windows.
+}
+
+TimelineBuffer* Thread::GetTimelineBuffer() {
+  // Unused since the timeline is not available on Windows.
+  return NULL;
+}
+
+void Thread::SetSlabCache(SlabCache* cache) {
+  // Unused since thread caches are not used on Windows.
+}
+
+SlabCache* Thread::GetSlabCache() {
+  // Unused since thread caches are not used on Windows.
+  return NULL;
+}
+
 bool Thread::IsCurrent(const ThreadIdentifier* thread) {
   return thread->IsSelf();
 }
@@ -48,6 +66,34 @@ ThreadIdentifier Thread::Run(RunSignature run, void* data) {
   return ThreadIdentifier(thread);
 }
 
+void Thread::YieldCurrentThread() { SwitchToThread(); }
+
+bool Thread::PinToCpu(int cpu) {
+  if (cpu >= static_cast<int>(sizeof(DWORD_PTR) * 8)) return false;
+  DWORD_PTR mask = static_cast<DWORD_PTR>(1) << cpu;
+  return SetThreadAffinityMask(GetCurrentThread(), mask) != 0;
+}
+
+int Thread::GetAllowedCpu(int index) {
+  DWORD_PTR process_mask;
+  DWORD_PTR system_mask;
+  if (!GetProcessAffinityMask(GetCurrentProcess(), &process_mask,
+                              &system_mask)) {
+    return -1;
+  }
+  const int kMaskBits = static_cast<int>(sizeof(DWORD_PTR) * 8);
+  int count = 0;
+  for (int cpu = 0; cpu < kMaskBits; cpu++) {
+    if ((process_mask >> cpu) & 1) count++;
+  }
+  if (count == 0) return -1;
+  int remaining = index % count;
+  for (int cpu = 0; cpu < kMaskBits; cpu++) {
+    if (((process_mask >> cpu) & 1) && remaining-- == 0) return cpu;
+  }
+  return -1;
+}
+
 }  // namespace dartino
 
 #endif  // defined(DARTINO_TARGET_OS_WIN)
@@ -0,0 +1,196 @@
+// Copyright (c) 2016, the Dartino project authors. Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE.md file.
+
+#include "src/vm/timeline.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "src/shared/flags.h"
+#include "src/shared/platform.h"
+#include "src/shared/utils.h"
+
+#include "src/vm/thread.h"
+
+namespace dartino {
+
+struct TimelineEvent {
+  uint64 timestamp;
+  const char* name;
+  Process* process;
+  char phase;
+};
+
+// The events of one thread. Only the owning thread adds events, and it
+// publishes them by storing the event count of the chunk with release
+// semantics, so the trace can be written while threads are recording.
+class TimelineBuffer {
+ public:
+  static const int kChunkEvents = 4096;
+  // Limits the memory used by a single thread to 32MB on 64-bit platforms.
+  static const int kMaxChunks = 256;
+
+  struct Chunk {
+    Chunk() : count(0), next(NULL) {}
+
+    TimelineEvent events[kChunkEvents];
+    Atomic<int> count;
+    Atomic<Chunk*> next;
+  };
+
+  explicit TimelineBuffer(int id)
+      : id_(id), next_(NULL), first_(new Chunk()), chunks_(1), dropped_(0) {
+    last_ = first_;
+    snprintf(name_, sizeof(name_), "Thread %d", id);
+  }
+
+  ~TimelineBuffer() {
+    Chunk* chunk = first_;
+    while (chunk != NULL) {
+      Chunk* next = chunk->next;
+      delete chunk;
+      chunk = next;
+    }
+  }
+
+  int id() const { return id_; }
+  const char* name() const { return name_; }
+  int dropped() const { return dropped_; }
+  Chunk* first() const { return first_; }
+
+  TimelineBuffer* next() const { return next_; }
+  void set_next(TimelineBuffer* next) { next_ = next; }
+
+  void set_name(const char* name) {
+    snprintf(name_, sizeof(name_), "%s", name);
+  }
+
+  void Add(char phase, const char* name, Process* process, uint64 timestamp) {
+    int count = last_->count.load(kRelaxed);
+    if (count == kChunkEvents) {
+      if (chunks_ == kMaxChunks) {
+        dropped_++;
+        return;
+      }
+      Chunk* chunk = new Chunk();
+      last_->next.store(chunk, kRelease);
+      last_ = chunk;
+      chunks_++;
+      count = 0;
+    }
+    TimelineEvent* event = &last_->events[count];
+    event->timestamp = timestamp;
+    event->name = name;
+    event->process = process;
+    event->phase = phase;
+    last_->count.store(count + 1, kRelease);
+  }
+
+ private:
+  const int id_;
+  TimelineBuffer* next_;
+  char name_[32];
+  Chunk* const first_;
+  Chunk* last_;
+  int chunks_;
+  int dropped_;
+};
+
+Atomic<bool> Timeline::enabled_(false);
+
+static Mutex* buffers_mutex = NULL;
+static TimelineBuffer* buffers = NULL;
+static int next_buffer_id = 0;
+static uint64 start_time = 0;
+
+static TimelineBuffer* CurrentBuffer() {
+  TimelineBuffer* buffer = Thread::GetTimelineBuffer();
+  if (buffer != NULL) return buffer;
+  ScopedLock locker(buffers_mutex);
+  buffer = new TimelineBuffer(next_buffer_id++);
+  buffer->set_next(buffers);
+  buffers = buffer;
+  Thread::SetTimelineBuffer(buffer);
+  return buffer;
+}
+
+void Timeline::Setup() {
+  if (Flags::timeline_file == NULL) return;
+#if defined(DARTINO_TARGET_OS_POSIX)
+  buffers_mutex = Platform::CreateMutex();
+  start_time = Platform::GetMicroseconds();
+  enabled_ = true;
+#else
+  Print::Error("The timeline is not supported on this platform\n");
+#endif
+}
+
+void Timeline::TearDown() {
+  if (!IsEnabled()) return;
+  enabled_ = false;
+  if (!WriteTrace(Flags::timeline_file)) {
+    Print::Error("Failed to write the timeline to '%s'\n",
+                 Flags::timeline_file);
+  }
+  Thread::SetTimelineBuffer(NULL);
+  while (buffers != NULL) {
+    TimelineBuffer* next = buffers->next();
+    delete buffers;
+    buffers = next;
+  }
+  delete buffers_mutex;
+  buffers_mutex = NULL;
+}
+
+void Timeline::Record(char phase, const char* name, Process* process) {
+  CurrentBuffer()->Add(phase, name, process, Platform::GetMicroseconds());
+}
+
+void Timeline::NameThread(const char* name) { CurrentBuffer()->set_name(name); }
+
+bool Timeline::WriteTrace(const char* path) {
+  FILE* file = fopen(path, "w");
+  if (file == NULL) return false;
+
+  ScopedLock locker(buffers_mutex);
+  fprintf(file,
+          "{\"traceEvents\":[\n"
+          "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":0,"
+          "\"args\":{\"name\":\"Dartino VM\"}}");
+  for (TimelineBuffer* buffer = buffers; buffer != NULL;
+       buffer = buffer->next()) {
+    fprintf(file,
+            ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%d,"
+            "\"args\":{\"name\":\"%s\"}}",
+            buffer->id(), buffer->name());
+    for (TimelineBuffer::Chunk* chunk = buffer->first(); chunk != NULL;
+         chunk = chunk->next.load(kAcquire)) {
+      int count = chunk->count.load(kAcquire);
+      for (int i = 0; i < count; i++) {
+        TimelineEvent* event = &chunk->events[i];
+        fprintf(file,
+                ",\n{\"name\":\"%s\",\"cat\":\"vm\",\"ph\":\"%c\","
+                "\"ts\":%llu,\"pid\":0,\"tid\":%d",
+                event->name, event->phase,
+                static_cast<unsigned long long>(  // NOLINT
+                    event->timestamp - start_time),
+                buffer->id());
+        if (event->phase == 'i') fprintf(file, ",\"s\":\"t\"");
+        if (event->process != NULL) {
+          fprintf(file, ",\"args\":{\"process\":\"%p\"}",
+                  reinterpret_cast<void*>(event->process));
+        }
+        fputc('}', file);
+      }
+    }
+    if (buffer->dropped() > 0) {
+      Print::Error("Timeline: dropped %d events of %s\n", buffer->dropped(),
+                   buffer->name());
+    }
+  }
+  fprintf(file, "\n],\"displayTimeUnit\":\"ms\"}\n");
+  return fclose(file) == 0;
+}
+
+}  // namespace dartino
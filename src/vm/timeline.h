@@ -0,0 +1,83 @@
+// Copyright (c) 2016, the Dartino project authors. Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE.md file.
+
+#ifndef SRC_VM_TIMELINE_H_
+#define SRC_VM_TIMELINE_H_
+
+#include "src/shared/atomic.h"
+#include "src/shared/globals.h"
+
+namespace dartino {
+
+class Process;
+class TimelineBuffer;
+
+// Records when the scheduler, the garbage collector and the event handler
+// do their work, and writes the events as a Chrome trace (chrome://tracing
+// or https://ui.perfetto.dev) on exit.
+//
+// Each thread appends to its own buffer without taking locks. When the
+// timeline is disabled, recording an event is a single test of a flag.
+class Timeline {
+ public:
+  // Enables the timeline if Flags::timeline_file is set.
+  static void Setup();
+  // Disables the timeline and writes the recorded events to the file. Must
+  // only be called once all other threads that record events have exited,
+  // since their buffers are deleted.
+  static void TearDown();
+
+  static bool IsEnabled() { return enabled_.load(kRelaxed); }
+
+  // Event names must be string literals, since only the pointer is stored.
+  static void Begin(const char* name, Process* process = NULL) {
+    if (IsEnabled()) Record('B', name, process);
+  }
+
+  static void End(const char* name) {
+    if (IsEnabled()) Record('E', name, NULL);
+  }
+
+  static void Instant(const char* name, Process* process = NULL) {
+    if (IsEnabled()) Record('i', name, process);
+  }
+
+  // Names the current thread in the trace. The name is copied.
+  static void SetThreadName(const char* name) {
+    if (IsEnabled()) NameThread(name);
+  }
+
+  // Writes the events recorded so far as Chrome trace JSON. Returns false
+  // if the file could not be written.
+  static bool WriteTrace(const char* path);
+
+ private:
+  static void Record(char phase, const char* name, Process* process);
+  static void NameThread(const char* name);
+
+  static Atomic<bool> enabled_;
+};
+
+// Records the begin and end event for a C++ scope.
+class TimelineScope {
+ public:
+  explicit TimelineScope(const char* name, Process* process = NULL)
+      : name_(NULL) {
+    if (Timeline::IsEnabled()) {
+      name_ = name;
+      Timeline::Begin(name, process);
+    }
+  }
+
+  ~TimelineScope() {
+    if (name_ != NULL) Timeline::End(name_);
+  }
+
+ private:
+  const char* name_;
+};
+
+}  // namespace dartino
+
+#endif  // SRC_VM_TIMELINE_H_
@@ -0,0 +1,87 @@
+// Copyright (c) 2016, the Dartino project authors. Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE.md file.
+
+#if defined(DARTINO_TARGET_OS_POSIX)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "src/shared/assert.h"
+#include "src/shared/flags.h"
+#include "src/shared/test_case.h"
+
+#include "src/vm/thread.h"
+#include "src/vm/timeline.h"
+
+namespace dartino {
+
+static void* RecordEvents(void* data) {
+  Timeline::SetThreadName("Test thread");
+  for (int i = 0; i < 5000; i++) {
+    TimelineScope scope("Outer");
+    Timeline::Instant("Inner");
+  }
+  return NULL;
+}
+
+static char* ReadFile(const char* path) {
+  FILE* file = fopen(path, "r");
+  if (file == NULL) return NULL;
+  fseek(file, 0, SEEK_END);
+  long size = ftell(file);  // NOLINT
+  fseek(file, 0, SEEK_SET);
+  char* contents = static_cast<char*>(malloc(size + 1));
+  size_t read = fread(contents, 1, size, file);
+  contents[read] = '\0';
+  fclose(file);
+  return contents;
+}
+
+static int CountOccurrences(const char* text, const char* pattern) {
+  int count = 0;
+  for (const char* p = strstr(text, pattern); p != NULL;
+       p = strstr(p + 1, pattern)) {
+    count++;
+  }
+  return count;
+}
+
+TEST_CASE(Timeline) {
+  // Nothing is recorded while the timeline is disabled.
+  EXPECT(!Timeline::IsEnabled());
+  Timeline::Instant("Disabled");
+
+  char path[64];
+  snprintf(path, sizeof(path), "/tmp/dartino_timeline_%d.json",
+           static_cast<int>(getpid()));
+  Flags::timeline_file = path;
+  Timeline::Setup();
+  EXPECT(Timeline::IsEnabled());
+
+  Timeline::Begin("Main");
+  ThreadIdentifier thread = Thread::Run(RecordEvents);
+  thread.Join();
+  Timeline::End("Main");
+
+  Timeline::TearDown();
+  Flags::timeline_file = NULL;
+  EXPECT(!Timeline::IsEnabled());
+
+  char* trace = ReadFile(path);
+  unlink(path);
+  EXPECT(trace != NULL);
+  EXPECT_EQ(0, strncmp(trace, "{\"traceEvents\":[", 16));
+  EXPECT(strstr(trace, "\"args\":{\"name\":\"Test thread\"}") != NULL);
+  EXPECT(strstr(trace, "Disabled") == NULL);
+  EXPECT_EQ(2, CountOccurrences(trace, "\"name\":\"Main\""));
+  EXPECT_EQ(10000, CountOccurrences(trace, "\"name\":\"Outer\""));
+  EXPECT_EQ(5000, CountOccurrences(trace, "\"ph\":\"i\""));
+  free(trace);
+}
+
+}  // namespace dartino
+
+#endif  // defined(DARTINO_TARGET_OS_POSIX)
@@ -0,0 +1,151 @@
+// Copyright (c) 2016, the Dartino project authors. Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE.md file.
+
+#ifdef DARTINO_ENABLE_DEBUGGING
+
+#include "src/vm/debug_info.h"
+
+#include <string.h>
+
+#include "src/shared/bytecodes.h"
+#include "src/shared/utils.h"
+
+namespace dartino {
+
+Tracepoint::Tracepoint(Function* function, int id)
+    : function_(function),
+      id_(id),
+      next_(NULL),
+      calls_(0),
+      total_microseconds_(0) {
+  for (int i = 0; i < kHistogramBuckets; i++) buckets_[i] = 0;
+}
+
+void Tracepoint::RecordCall(int64 microseconds) {
+  int index = Utils::BitLength(microseconds);
+  if (index >= kHistogramBuckets) index = kHistogramBuckets - 1;
+  calls_.fetch_add(1, kRelaxed);
+  total_microseconds_.fetch_add(microseconds, kRelaxed);
+  buckets_[index].fetch_add(1, kRelaxed);
+}
+
+void Tracepoint::VisitProgramPointers(PointerVisitor* visitor) {
+  visitor->Visit(reinterpret_cast<Object**>(&function_));
+}
+
+Tracepoints::Tracepoints() : first_(NULL), next_id_(0) {
+  memset(filter_, 0, sizeof(filter_));
+}
+
+Tracepoints::~Tracepoints() {
+  Tracepoint* current = first_;
+  while (current != NULL) {
+    Tracepoint* next = current->next();
+    delete current;
+    current = next;
+  }
+}
+
+int Tracepoints::Create(Function* function) {
+  for (Tracepoint* current = first_; current != NULL;
+       current = current->next_) {
+    if (current->function() == function) return current->id();
+  }
+  Tracepoint* tracepoint = new Tracepoint(function, next_id_++);
+  tracepoint->next_ = first_;
+  first_ = tracepoint;
+  AddProbes(tracepoint);
+  return tracepoint->id();
+}
+
+bool Tracepoints::Delete(int id) {
+  Tracepoint** link = &first_;
+  for (Tracepoint* current = first_; current != NULL;
+       current = current->next_) {
+    if (current->id() == id) {
+      *link = current->next_;
+      delete current;
+      UpdateProbes();
+      return true;
+    }
+    link = &current->next_;
+  }
+  return false;
+}
+
+const TracepointProbe* Tracepoints::Lookup(uint8_t* bcp) const {
+  ProbeMap::ConstIterator it = probes_.Find(bcp);
+  if (it != probes_.End()) return &it->second;
+  return NULL;
+}
+
+void Tracepoints::VisitProgramPointers(PointerVisitor* visitor) {
+  for (Tracepoint* current = first_; current != NULL;
+       current = current->next_) {
+    current->VisitProgramPointers(visitor);
+  }
+}
+
+// Recompute the probe addresses after functions have moved.
+void Tracepoints::UpdateProbes() {
+  ProbeMap empty;
+  probes_.Swap(empty);
+  memset(filter_, 0, sizeof(filter_));
+  for (Tracepoint* current = first_; current != NULL;
+       current = current->next_) {
+    AddProbes(current);
+  }
+}
+
+void Tracepoints::AddProbes(Tracepoint* tracepoint) {
+  uint8_t* bcp = tracepoint->function()->bytecode_address_for(0);
+  AddProbe(bcp, {tracepoint, true, false});
+  while (true) {
+    Opcode opcode = static_cast<Opcode>(*bcp);
+    if (opcode == kMethodEnd) break;
+    if (opcode == kReturn || opcode == kReturnNull) {
+      ProbeMap::Iterator it = probes_.Find(bcp);
+      if (it != probes_.End()) {
+        it->second.is_exit = true;
+      } else {
+        AddProbe(bcp, {tracepoint, false, true});
+      }
+    }
+    bcp += Bytecode::Size(opcode);
+  }
+}
+
+void Tracepoints::AddProbe(uint8_t* bcp, const TracepointProbe& probe) {
+  probes_.Insert({bcp, probe});
+  uword index = FilterIndex(bcp);
+  filter_[index / kBitsPerWord] |= static_cast<uword>(1)
+                                   << (index % kBitsPerWord);
+}
+
+void TraceStack::Enter(int tracepoint_id, word height, int64 now) {
+  Entry* entry = &entries_[top_];
+  entry->tracepoint_id = tracepoint_id;
+  entry->height = height;
+  entry->time = now;
+  top_ = (top_ + 1) % kCapacity;
+  if (size_ < kCapacity) size_++;
+}
+
+void TraceStack::Exit(Tracepoint* tracepoint, word height, int64 now) {
+  int index = top_;
+  for (int i = 0; i < size_; i++) {
+    index = (index + kCapacity - 1) % kCapacity;
+    Entry* entry = &entries_[index];
+    if (entry->tracepoint_id == tracepoint->id() && entry->height <= height) {
+      top_ = index;
+      size_ -= i + 1;
+      if (now >= entry->time) tracepoint->RecordCall(now - entry->time);
+      return;
+    }
+  }
+}
+
+}  // namespace dartino
+
+#endif  // DARTINO_ENABLE_DEBUGGING
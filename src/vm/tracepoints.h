@@ -0,0 +1,143 @@
+// Copyright (c) 2016, the Dartino project authors. Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE.md file.
+
+#ifndef SRC_VM_TRACEPOINTS_H_
+#define SRC_VM_TRACEPOINTS_H_
+
+#ifndef SRC_VM_DEBUG_INFO_H_
+#error "Do not import tracepoints.h directly, import debug_info.h"
+#endif  // SRC_VM_DEBUG_INFO_H_
+
+#include "src/shared/atomic.h"
+#include "src/vm/hash_map.h"
+#include "src/vm/object.h"
+
+namespace dartino {
+
+// Call counts and a latency histogram for a traced function. The counters
+// are updated by all interpreter threads.
+class Tracepoint {
+ public:
+  // Bucket 0 counts calls that took less than a microsecond. Bucket i > 0
+  // counts calls that took [2^(i-1), 2^i) microseconds, except for the last
+  // bucket which also counts all longer calls.
+  static const int kHistogramBuckets = 32;
+
+  Tracepoint(Function* function, int id);
+
+  Function* function() const { return function_; }
+  int id() const { return id_; }
+  Tracepoint* next() const { return next_; }
+
+  int64 calls() const { return calls_; }
+  int64 total_microseconds() const { return total_microseconds_; }
+  int64 bucket(int index) const { return buckets_[index]; }
+
+  void RecordCall(int64 microseconds);
+
+  void VisitProgramPointers(PointerVisitor* visitor);
+
+ private:
+  friend class Tracepoints;
+
+  Function* function_;
+  int id_;
+  Tracepoint* next_;
+
+  Atomic<int64> calls_;
+  Atomic<int64> total_microseconds_;
+  Atomic<int64> buckets_[kHistogramBuckets];
+};
+
+// A probe at a bytecode of a traced function. A probe can both be an entry
+// and an exit probe if the function starts with a return.
+struct TracepointProbe {
+  Tracepoint* tracepoint;
+  bool is_entry;
+  bool is_exit;
+};
+
+// The tracepoints of a program. Probes are placed on the first bytecode and
+// on the return bytecodes of the traced functions and are reached through
+// the same dispatch table patching as breakpoints. The patched opcodes are
+// also executed by functions that are not traced; for those a probe filter
+// rejects almost all bytecodes with a single bit test, before the hash map
+// of probes is consulted.
+class Tracepoints {
+ public:
+  typedef HashMap<uint8_t*, TracepointProbe> ProbeMap;
+
+  Tracepoints();
+  ~Tracepoints();
+
+  // Returns the id of the tracepoint of [function], creating it if needed.
+  int Create(Function* function);
+  bool Delete(int id);
+
+  // Returns false if there is no probe at [bcp]. May return true for
+  // bytecodes without a probe.
+  bool MayHaveProbeAt(uint8_t* bcp) const {
+    uword index = FilterIndex(bcp);
+    return (filter_[index / kBitsPerWord] >> (index % kBitsPerWord)) & 1;
+  }
+
+  const TracepointProbe* Lookup(uint8_t* bcp) const;
+
+  const ProbeMap& probes() const { return probes_; }
+  Tracepoint* first() const { return first_; }
+
+  // GC support for program GCs.
+  void VisitProgramPointers(PointerVisitor* visitor);
+  void UpdateProbes();
+
+ private:
+  static const int kFilterBits = 4096;
+
+  static uword FilterIndex(uint8_t* bcp) {
+    return reinterpret_cast<uword>(bcp) & (kFilterBits - 1);
+  }
+
+  void AddProbes(Tracepoint* tracepoint);
+  void AddProbe(uint8_t* bcp, const TracepointProbe& probe);
+
+  Tracepoint* first_;
+  int next_id_;
+  ProbeMap probes_;
+  uword filter_[kFilterBits / kBitsPerWord];
+};
+
+// The entry times of the traced calls that a process is in. Processes move
+// between interpreter threads, so the entries are kept per process, which
+// also means no synchronization is needed. The entries form a ring buffer:
+// in deep recursion the oldest entries are overwritten and the
+// corresponding exits are not recorded.
+class TraceStack {
+ public:
+  TraceStack() : top_(0), size_(0) {}
+
+  // [height] is the height of the stack of the process at the probe.
+  void Enter(int tracepoint_id, word height, int64 now);
+
+  // Records the latency of the innermost call of [tracepoint] that was
+  // entered at or below [height]. Entries above it belong to calls that
+  // were left by throwing and are dropped.
+  void Exit(Tracepoint* tracepoint, word height, int64 now);
+
+ private:
+  static const int kCapacity = 64;
+
+  struct Entry {
+    int tracepoint_id;
+    word height;
+    int64 time;
+  };
+
+  Entry entries_[kCapacity];
+  int top_;
+  int size_;
+};
+
+}  // namespace dartino
+
+#endif  // SRC_VM_TRACEPOINTS_H_
@@ -0,0 +1,66 @@
+// Copyright (c) 2016, the Dartino project authors. Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE.md file.
+
+#ifdef DARTINO_ENABLE_DEBUGGING
+
+#include "src/shared/assert.h"
+#include "src/shared/test_case.h"
+
+#include "src/vm/debug_info.h"
+
+namespace dartino {
+
+TEST_CASE(TracepointHistogram) {
+  Tracepoint tracepoint(NULL, 0);
+  tracepoint.RecordCall(0);
+  tracepoint.RecordCall(1);
+  tracepoint.RecordCall(3);
+  tracepoint.RecordCall(4);
+  tracepoint.RecordCall(INT64_MAX);
+  EXPECT_EQ(5, tracepoint.calls());
+  EXPECT_EQ(1, tracepoint.bucket(0));
+  EXPECT_EQ(1, tracepoint.bucket(1));
+  EXPECT_EQ(1, tracepoint.bucket(2));
+  EXPECT_EQ(1, tracepoint.bucket(3));
+  EXPECT_EQ(1, tracepoint.bucket(Tracepoint::kHistogramBuckets - 1));
+}
+
+TEST_CASE(TraceStackMatchesCalls) {
+  Tracepoint outer(NULL, 0);
+  Tracepoint inner(NULL, 1);
+  TraceStack stack;
+
+  // Nested calls.
+  stack.Enter(outer.id(), 10, 100);
+  stack.Enter(inner.id(), 20, 110);
+  stack.Exit(&inner, 25, 130);
+  stack.Exit(&outer, 12, 200);
+  EXPECT_EQ(1, inner.calls());
+  EXPECT_EQ(20, inner.total_microseconds());
+  EXPECT_EQ(1, outer.calls());
+  EXPECT_EQ(100, outer.total_microseconds());
+
+  // A call of [inner] left by throwing is dropped when [outer] returns.
+  stack.Enter(outer.id(), 10, 300);
+  stack.Enter(inner.id(), 20, 310);
+  stack.Exit(&outer, 11, 350);
+  stack.Exit(&inner, 25, 360);
+  EXPECT_EQ(2, outer.calls());
+  EXPECT_EQ(150, outer.total_microseconds());
+  EXPECT_EQ(1, inner.calls());
+}
+
+TEST_CASE(TraceStackRecursion) {
+  Tracepoint tracepoint(NULL, 0);
+  TraceStack stack;
+  for (int i = 0; i < 100; i++) stack.Enter(tracepoint.id(), i, i);
+  for (int i = 99; i >= 0; i--) stack.Exit(&tracepoint, i, 100);
+  // Only the innermost calls fit in the ring buffer.
+  EXPECT(tracepoint.calls() < 100);
+  EXPECT(tracepoint.calls() > 0);
+}
+
+}  // namespace dartino
+
+#endif  // DARTINO_ENABLE_DEBUGGING
@@ -46,6 +46,10 @@
         }],
       ],
       'sources': [
+        'constant_map_index.cc',
+        'constant_map_index.h',
+        'coroutine_registry.cc',
+        'coroutine_registry.h',
         'dartino_api_impl.cc',
         'dartino_api_impl.h',
         'dartino.cc',
@@ -73,17 +77,21 @@
         'heap.h',
         'heap_validator.cc',
         'heap_validator.h',
+        'intern_table.cc',
+        'intern_table.h',
         'intrinsics.cc',
         'intrinsics.h',
         'links.cc',
         'links.h',
-        'log_print_interceptor.cc',
-        'log_print_interceptor.h',
+        'log_writer.cc',
+        'log_writer.h',
         'lookup_cache.cc',
         'lookup_cache.h',
         'mailbox.h',
         'message_mailbox.cc',
         'message_mailbox.h',
+        'metrics.cc',
+        'metrics.h',
         'multi_hashset.h',
         'native_process_disabled.cc',
         'native_process_posix.cc',
@@ -94,6 +102,8 @@
         'natives_lk.cc',
         'natives_posix.cc',
         'natives_windows.cc',
+        'number_conversion.cc',
+        'number_conversion.h',
         'object.cc',
         'object.h',
         'object_list.cc',
@@ -132,12 +142,18 @@
         'session.h',
         'session_no_debugging.h',
         'signal.h',
+        'slab_allocator.cc',
+        'slab_allocator.h',
         'snapshot.cc',
         'snapshot.h',
         'socket_connection_api_impl.cc',
         'socket_connection_api_impl.h',
         'sort.cc',
         'sort.h',
+        'source_positions.cc',
+        'source_positions.h',
+        'spinlock.cc',
+        'spinlock.h',
         'thread_cmsis.cc',
         'thread_cmsis.h',
         'thread.h',
@@ -149,6 +165,10 @@
         'thread_posix.h',
         'thread_windows.cc',
         'thread_windows.h',
+        'timeline.cc',
+        'timeline.h',
+        'tracepoints.cc',
+        'tracepoints.h',
         'unicode.cc',
         'unicode.h',
         'vector.cc',
@@ -356,16 +376,42 @@
       ],
       'sources': [
         # TODO(ahe): Add header (.h) files.
+        'coroutine_registry_test.cc',
         'double_list_tests.cc',
         'hash_table_test.cc',
+        'log_writer_test.cc',
+        'lookup_cache_test.cc',
+        'metrics_test.cc',
+        'number_conversion_test.cc',
         'object_map_test.cc',
         'object_memory_test.cc',
         'object_test.cc',
         'platform_test.cc',
         'priority_heap_test.cc',
+        'slab_allocator_test.cc',
+        'source_positions_test.cc',
+        'timeline_test.cc',
+        'tracepoints_test.cc',
         'vector_test.cc',
       ],
     },
+    {
+      # C++ benchmarks of VM internals that Dart code cannot reach. They
+      # print their results in the RunTime format of benchmarks/.
+      'target_name': 'vm_cc_benchmarks',
+      'type': 'executable',
+      'dependencies': [
+        'libdartino',
+        '../shared/shared.gyp:cc_test_base',
+      ],
+      'defines': [
+        'TESTING',
+      ],
+      'sources': [
+        '../../benchmarks/cc/object_map_benchmark.cc',
+        '../../benchmarks/cc/semaphore_benchmark.cc',
+      ],
+    },
     {
       'target_name': 'multiprogram_cc_test',
       'type': 'executable',
@@ -6,6 +6,7 @@
 #define SRC_VM_WEAK_POINTER_H_
 
 #include "src/vm/double_list.h"
+#include "src/vm/slab_allocator.h"
 
 namespace dartino {
 
@@ -20,7 +21,8 @@ typedef void (*WeakPointerCallback)(HeapObject* object, void* arg);
 typedef void (*ExternalWeakPointerCallback)(void* arg);
 typedef DoubleList<WeakPointer> WeakPointerList;
 
-class WeakPointer : public WeakPointerList::Entry {
+class WeakPointer : public WeakPointerList::Entry,
+                    public SlabAllocated<SlabAllocator::kWeakPointer> {
  public:
   WeakPointer(HeapObject* object, WeakPointerCallback callback, void* arg);
 
@@ -2,11 +2,14 @@
 // for details. All rights reserved. Use of this source code is governed by a
 // BSD-style license that can be found in the LICENSE.md file.
 
+import 'dart:dartino';
 import 'dart:dartino.ffi';
 import 'dart:dartino.os';
+import 'dart:typed_data';
 
 import 'package:expect/expect.dart';
 import 'package:file/file.dart';
+import 'package:os/os.dart' as os;
 
 void main() {
   testStartDetachedValid();
@@ -14,6 +17,10 @@ void main() {
   testStartDetachedEmptyPath();
   testStartDetachedInvalidPath();
   testStartDetachedNonExecutablePath();
+  testStartPipes();
+  testStartExitCodes();
+  testStartClose();
+  testStartInvalidPath();
 }
 
 final ForeignFunction _kill = ForeignLibrary.main.lookup('kill');
@@ -60,3 +67,89 @@ void testStartDetachedNonExecutablePath() {
                   "Got errno 13");
   File.delete(nonExecFile.path);
 }
+
+// Reads [fd] until end of file, waiting for data with the event handler.
+String readAll(int fd) {
+  Channel channel = new Channel();
+  Port port = new Port(channel);
+  var buffer = new Uint8List(64).buffer;
+  List<int> bytes = [];
+  while (true) {
+    int read = os.sys.read(fd, buffer, 0, 64);
+    if (read == 0) break;
+    if (read < 0) {
+      eventHandler.registerPortForNextEvent(fd, port, READ_EVENT);
+      channel.receive();
+      continue;
+    }
+    bytes.addAll(new Uint8List.view(buffer, 0, read));
+  }
+  return new String.fromCharCodes(bytes);
+}
+
+void testStartPipes() {
+  var process = NativeProcess.start(
+      '/bin/sh', ['-c', 'read line; echo "\$line out"; echo err >&2; exit 3']);
+  Expect.isTrue(process.pid > 0);
+  var input = new Uint8List.fromList('in\n'.codeUnits).buffer;
+  Expect.equals(3, os.sys.write(process.stdin, input, 0, 3));
+  os.sys.close(process.stdin);
+  Expect.equals('in out\n', readAll(process.stdout));
+  Expect.equals('err\n', readAll(process.stderr));
+  os.sys.close(process.stdout);
+  os.sys.close(process.stderr);
+  Expect.equals(3, process.waitForExit());
+  Expect.equals(3, process.exitCode);
+}
+
+void testStartExitCodes() {
+  const SIGKILL = 9;
+  // Many short-lived children are waited for without a thread each.
+  List<NativeProcess> processes = [];
+  for (int i = 0; i < 20; i++) {
+    processes.add(NativeProcess.start('/bin/sh', ['-c', 'exit $i']));
+  }
+  for (int i = 0; i < 20; i++) {
+    var process = processes[i];
+    os.sys.close(process.stdin);
+    os.sys.close(process.stdout);
+    os.sys.close(process.stderr);
+    Expect.equals(i, process.waitForExit());
+  }
+
+  var sleeping = NativeProcess.start('/bin/sleep', ['130']);
+  Expect.isNull(sleeping.exitCode);
+  Expect.equals(0, _kill.icall$2(sleeping.pid, SIGKILL));
+  Expect.equals(-SIGKILL, sleeping.waitForExit());
+  os.sys.close(sleeping.stdin);
+  os.sys.close(sleeping.stdout);
+  os.sys.close(sleeping.stderr);
+}
+
+void testStartClose() {
+  const SIGKILL = 9;
+  // Closing a running process kills and reaps it.
+  var sleeping = NativeProcess.start('/bin/sleep', ['130']);
+  Expect.equals(-SIGKILL, sleeping.close());
+  Expect.equals(-SIGKILL, sleeping.exitCode);
+  Expect.equals(-SIGKILL, sleeping.waitForExit());
+  Expect.equals(-SIGKILL, sleeping.close());
+  os.sys.close(sleeping.stdin);
+  os.sys.close(sleeping.stdout);
+  os.sys.close(sleeping.stderr);
+
+  // Closing a process that has been waited for returns its exit code.
+  var exited = NativeProcess.start('/bin/sh', ['-c', 'exit 7']);
+  os.sys.close(exited.stdin);
+  os.sys.close(exited.stdout);
+  os.sys.close(exited.stderr);
+  Expect.equals(7, exited.waitForExit());
+  Expect.equals(7, exited.close());
+}
+
+void testStartInvalidPath() {
+  Expect.throws(() => NativeProcess.start('', null),
+      (e) => e == 'Empty path: Path must point to valid executable');
+  Expect.throws(() => NativeProcess.start('bla', null),
+      (e) => e == "Failed to start process from path 'bla'. Got errno 2");
+}
@@ -0,0 +1,62 @@
+// Copyright (c) 2016, the Dartino project authors. Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE.md file.
+
+import 'package:expect/expect.dart';
+
+// Large enough to get a hash index.
+const Map<String, int> units = const {
+  'b': 1, 'kb': 1000, 'mb': 1000000, 'gb': 1000000000,
+  'kib': 1024, 'mib': 1048576, 'gib': 1073741824,
+  'bit': 0, 'nibble': 4, 'byte': 8, 'word': 16,
+};
+
+const Map<int, String> opcodes = const {
+  0: 'nop', 1: 'load', 2: 'store', 3: 'add', 4: 'sub', 5: 'mul',
+  6: 'div', 7: 'jump', 8: 'call', 9: 'return', 100: 'halt', -1: 'invalid',
+};
+
+// Keys that cannot be hashed in the VM.
+const Map<Object, String> mixed = const {
+  1.5: 'double', 'a': 'string', 1: 'int', null: 'null', true: 'bool',
+  2: 'two', 3: 'three', 4: 'four', 5: 'five',
+};
+
+// Small maps are scanned.
+const Map<String, int> small = const {'x': 1, 'y': 2};
+
+String build(String string) {
+  return (new StringBuffer()..write(string)).toString();
+}
+
+main() {
+  units.forEach((String key, int value) {
+    Expect.equals(value, units[key]);
+    Expect.equals(value, units[build(key)]);
+    Expect.isTrue(units.containsKey(build(key)));
+  });
+  Expect.isNull(units['tb']);
+  Expect.isFalse(units.containsKey('tb'));
+  Expect.isFalse(units.containsKey(1));
+  Expect.isNull(units[null]);
+  Expect.isNull(units[new Object()]);
+  Expect.equals(1000, units[build('ሴkb').substring(1)]);
+
+  opcodes.forEach((int key, String value) {
+    Expect.equals(value, opcodes[key]);
+  });
+  Expect.isNull(opcodes[10]);
+  Expect.isNull(opcodes['1']);
+  Expect.isNull(opcodes[1 << 40]);
+  Expect.isFalse(opcodes.containsKey(-2));
+
+  Expect.equals('double', mixed[1.5]);
+  Expect.equals('string', mixed['a']);
+  Expect.equals('int', mixed[1]);
+  Expect.equals('null', mixed[null]);
+  Expect.equals('bool', mixed[true]);
+  Expect.isNull(mixed[6]);
+
+  Expect.equals(2, small['y']);
+  Expect.isNull(small['z']);
+}
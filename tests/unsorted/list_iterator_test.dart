@@ -0,0 +1,31 @@
+// Copyright (c) 2016, the Dartino project authors. Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE.md file.
+
+import 'package:expect/expect.dart';
+
+int sum(Iterable<int> iterable) {
+  int result = 0;
+  for (int value in iterable) result += value;
+  return result;
+}
+
+main() {
+  Expect.equals(6, sum([1, 2, 3]));
+  Expect.equals(6, sum(const [1, 2, 3]));
+  Expect.equals(6, sum(new List<int>(3)..fillRange(0, 3, 2)));
+  Expect.equals(0, sum([]));
+
+  Iterator it = [1].iterator;
+  Expect.isNull(it.current);
+  Expect.isTrue(it.moveNext());
+  Expect.equals(1, it.current);
+  Expect.isFalse(it.moveNext());
+  Expect.isNull(it.current);
+  Expect.isFalse(it.moveNext());
+
+  List<int> growable = [1, 2, 3];
+  Expect.throws(() {
+    for (int value in growable) growable.add(value);
+  }, (e) => e is ConcurrentModificationError);
+}
@@ -0,0 +1,114 @@
+// Copyright (c) 2016, the Dartino project authors. Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE.md file.
+
+import 'dart:dartino';
+
+import 'package:expect/expect.dart';
+
+// Keys with the same hash code end up in the same collision chain.
+class CollidingKey {
+  final int value;
+  const CollidingKey(this.value);
+  int get hashCode => 42;
+  bool operator==(other) => other is CollidingKey && other.value == value;
+}
+
+void testMap() {
+  PersistentMap map = new PersistentMap();
+  Expect.isTrue(map.isEmpty);
+  Expect.isNull(map[0]);
+
+  const int count = 5000;
+  List<PersistentMap> versions = <PersistentMap>[];
+  for (int i = 0; i < count; i++) {
+    versions.add(map);
+    map = map.put(i * 31, i);
+  }
+  Expect.equals(count, map.length);
+  for (int i = 0; i < count; i++) {
+    Expect.equals(i, map[i * 31]);
+    Expect.isFalse(map.containsKey(i * 31 + 1));
+  }
+
+  // Older versions are unaffected by updates.
+  Expect.equals(100, versions[100].length);
+  Expect.isTrue(versions[100].containsKey(99 * 31));
+  Expect.isFalse(versions[100].containsKey(100 * 31));
+
+  PersistentMap updated = map.put(31, 'one');
+  Expect.equals(count, updated.length);
+  Expect.equals('one', updated[31]);
+  Expect.equals(1, map[31]);
+
+  for (int i = 0; i < count; i += 2) map = map.remove(i * 31);
+  Expect.equals(count ~/ 2, map.length);
+  for (int i = 0; i < count; i++) {
+    Expect.equals(i.isOdd, map.containsKey(i * 31));
+  }
+  Expect.identical(map, map.remove(0));
+
+  int sum = 0;
+  map.forEach((key, value) { sum += value; });
+  Expect.equals(count * count ~/ 4, sum);
+
+  PersistentMap strings = new PersistentMap.fromMap({'a': 1, 'b': 2});
+  Expect.equals(2, strings.length);
+  Expect.equals(2, strings['b']);
+  Expect.mapEquals({'a': 1, 'b': 2}, strings.toMap());
+}
+
+void testCollisions() {
+  PersistentMap map = new PersistentMap();
+  for (int i = 0; i < 10; i++) map = map.put(new CollidingKey(i), i);
+  map = map.put(7, 'seven');
+  Expect.equals(11, map.length);
+  for (int i = 0; i < 10; i++) Expect.equals(i, map[new CollidingKey(i)]);
+  Expect.equals('seven', map[7]);
+
+  map = map.remove(new CollidingKey(5));
+  Expect.equals(10, map.length);
+  Expect.isFalse(map.containsKey(new CollidingKey(5)));
+  Expect.equals(6, map[new CollidingKey(6)]);
+}
+
+void testVector() {
+  PersistentVector vector = new PersistentVector();
+  Expect.isTrue(vector.isEmpty);
+  Expect.throws(() => vector[0], (e) => e is IndexError);
+
+  const int count = 5000;
+  for (int i = 0; i < count; i++) vector = vector.add(i);
+  Expect.equals(count, vector.length);
+  for (int i = 0; i < count; i++) Expect.equals(i, vector[i]);
+
+  PersistentVector updated = vector.set(4095, 'x');
+  Expect.equals('x', updated[4095]);
+  Expect.equals(4095, vector[4095]);
+  Expect.throws(() => vector.set(count, 0), (e) => e is IndexError);
+
+  Expect.listEquals(
+      [1, 2, 3], new PersistentVector.fromList([1, 2, 3]).toList());
+}
+
+void testMessages() {
+  PersistentMap map = new PersistentMap().put('key', 'value').put(1, 2.5);
+  PersistentVector vector = new PersistentVector().add(map).add('x');
+  Expect.isTrue(isImmutable(map));
+  Expect.isTrue(isImmutable(vector));
+  Expect.isFalse(isImmutable(map.put('list', [])));
+
+  var channel = new Channel();
+  final port = new Port(channel);
+  Process.spawn((PersistentVector received) {
+    port.send(received[0]['key']);
+  }, vector);
+  Expect.equals('value', channel.receive());
+}
+
+main() {
+  testMap();
+  testCollisions();
+  testVector();
+  testMessages();
+}
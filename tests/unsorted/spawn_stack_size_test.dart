@@ -0,0 +1,75 @@
+// Copyright (c) 2016, the Dartino project authors. Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE.md file.
+
+import 'dart:dartino';
+
+import 'package:expect/expect.dart';
+
+const int DEPTH = 10000;
+const int ECHO_ROUNDS = 10;
+
+main() {
+  Expect.throws(() => Process.spawn(noop, null, const StackSize(initial: 1)),
+                (e) => e is RangeError);
+  Expect.throws(() => Process.spawn(noop, null, const StackSize(maximum: 1)),
+                (e) => e is RangeError);
+  Expect.throws(
+      () => Process.spawn(
+          noop, null, const StackSize(initial: 4096, maximum: 1024)),
+      (e) => e is ArgumentError);
+
+  // The recursion does not fit in a small stack.
+  Expect.isTrue(overflowsWith(const StackSize(maximum: 1024)));
+  // A small initial stack grows as needed.
+  Expect.isFalse(
+      overflowsWith(const StackSize(initial: 64, maximum: 1024 * 1024)));
+  Expect.isFalse(overflowsWith(const StackSize(initial: 64 * 1024)));
+
+  // Processes that went to sleep after a deep recursion still work. The VM
+  // shrinks the stack of a process that has gone idle shallow a few times in
+  // a row (Process::kShrinkStackIdlePeriods is 4), so run enough rounds for
+  // the stack to be shrunk and then grown again by the next recursion.
+  var channel = new Channel();
+  var port = new Port(channel);
+  Process.spawnDetached(() => recurseAndEcho(port),
+                        stackSize: const StackSize(initial: 64));
+  Port echo = channel.receive();
+  for (int i = 0; i < ECHO_ROUNDS; i++) {
+    echo.send(i);
+    Expect.equals(i, channel.receive());
+  }
+  echo.send(null);
+}
+
+void noop() { }
+
+bool overflowsWith(StackSize stackSize) {
+  var channel = new Channel();
+  var port = new Port(channel);
+  Process.spawnDetached(() => recurseAndReport(port), stackSize: stackSize);
+  return channel.receive();
+}
+
+int recurse(int n) => n == 0 ? 0 : 1 + recurse(n - 1);
+
+void recurseAndReport(Port port) {
+  try {
+    Expect.equals(DEPTH, recurse(DEPTH));
+    port.send(false);
+  } on StackOverflowError {
+    port.send(true);
+  }
+}
+
+void recurseAndEcho(Port port) {
+  var channel = new Channel();
+  Expect.equals(DEPTH, recurse(DEPTH));
+  port.send(new Port(channel));
+  var message;
+  while ((message = channel.receive()) != null) {
+    // The stack may have been shrunk while waiting, so grow it again.
+    Expect.equals(DEPTH, recurse(DEPTH));
+    port.send(message);
+  }
+}
@@ -0,0 +1,38 @@
+// Copyright (c) 2016, the Dartino project authors. Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE.md file.
+
+import 'dart:convert';
+import 'dart:dartino';
+
+import 'package:expect/expect.dart';
+
+String build(String prefix, int i) {
+  return (new StringBuffer()..write(prefix)..write(i)).toString();
+}
+
+main() {
+  String a = build('key', 1);
+  String b = build('key', 1);
+  Expect.equals(a, b);
+  Expect.isFalse(identical(a, b));
+
+  String canonical = intern(a);
+  Expect.isTrue(identical(canonical, a));
+  Expect.isTrue(identical(canonical, intern(b)));
+
+  // Interned strings survive and stay canonical across collections, while
+  // unreferenced ones are dropped from the table.
+  for (int i = 0; i < 10000; i++) {
+    intern(build('garbage', i));
+    new List(100);
+  }
+  Expect.isTrue(identical(canonical, intern(build('key', 1))));
+
+  // Decoded JSON property names are interned.
+  Map first = JSON.decode('{"name": 1}');
+  Map second = JSON.decode('{"name": 2}');
+  Expect.isTrue(identical(first.keys.first, second.keys.first));
+
+  Expect.throws(() => intern(null), (e) => e is ArgumentError);
+}
@@ -20,6 +20,7 @@ LOCAL_CFLAGS := \
 LOCAL_SRC_FILES := \
 	../../../src/shared/assert.cc \
 	../../../src/shared/bytecodes.cc \
+	../../../src/shared/compression.cc \
 	../../../src/shared/connection.cc \
 	../../../src/shared/flags.cc \
 	../../../src/shared/native_socket_linux.cc \
@@ -28,6 +29,8 @@ LOCAL_SRC_FILES := \
 	../../../src/shared/platform_posix.cc \
 	../../../src/shared/platform_vm.cc \
 	../../../src/shared/utils.cc \
+	../../../src/vm/constant_map_index.cc \
+	../../../src/vm/coroutine_registry.cc \
 	../../../src/vm/debug_info.cc \
 	../../../src/vm/event_handler.cc \
 	../../../src/vm/event_handler_linux.cc \
@@ -41,16 +44,19 @@ LOCAL_SRC_FILES := \
 	../../../src/vm/gc_metadata.cc \
 	../../../src/vm/heap.cc \
 	../../../src/vm/heap_validator.cc \
+	../../../src/vm/intern_table.cc \
 	../../../src/vm/interpreter.cc \
 	../../../src/vm/intrinsics.cc \
 	../../../src/vm/links.cc \
 	../../../src/vm/lookup_cache.cc \
-	../../../src/vm/log_print_interceptor.cc \
+	../../../src/vm/log_writer.cc \
 	../../../src/vm/message_mailbox.cc \
+	../../../src/vm/metrics.cc \
 	../../../src/vm/native_process.cc \
 	../../../src/vm/native_process_disabled.cc \
 	../../../src/vm/natives.cc \
 	../../../src/vm/natives_posix.cc \
+	../../../src/vm/number_conversion.cc \
 	../../../src/vm/object.cc \
 	../../../src/vm/object_list.cc \
 	../../../src/vm/object_map.cc \
@@ -65,10 +71,15 @@ LOCAL_SRC_FILES := \
 	../../../src/vm/selector_row.cc \
 	../../../src/vm/service_api_impl.cc \
 	../../../src/vm/session.cc \
+	../../../src/vm/slab_allocator.cc \
 	../../../src/vm/snapshot.cc \
 	../../../src/vm/sort.cc \
+	../../../src/vm/source_positions.cc \
+	../../../src/vm/spinlock.cc \
 	../../../src/vm/thread_pool.cc \
 	../../../src/vm/thread_posix.cc \
+	../../../src/vm/timeline.cc \
+	../../../src/vm/tracepoints.cc \
 	../../../src/vm/unicode.cc \
 	../../../src/vm/vector.cc \
 	../../../src/vm/void_hash_table.cc \